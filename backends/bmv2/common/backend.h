@@ -77,6 +77,11 @@ class Backend {
           json(new BMV2::JsonObjects()) {
         refMap->setIsV1(options.isv1());
     }
+    /// Unlike the DPDK and TC back ends, which stream their JSON through Util::JsonWriter, the
+    /// BMv2 JSON is mostly built as a tree first: the converters look up and modify nodes
+    /// after creating them, e.g. to attach counters and actions to tables.  The const entries
+    /// of tables, which can make up most of the output, are Util::JsonStreamed values written
+    /// only here.
     void serialize(std::ostream &out) const { json->toplevel->serialize(out); }
     virtual void convert(const IR::ToplevelBlock *block) = 0;
 };
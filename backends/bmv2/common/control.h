@@ -28,6 +28,7 @@ limitations under the License.
 #include "ir/ir.h"
 #include "lib/algorithm.h"
 #include "lib/json.h"
+#include "lib/json_writer.h"
 #include "midend/convertEnums.h"
 #include "sharedActionSelectorCheck.h"
 
@@ -433,160 +434,189 @@ class ControlConverter : public Inspector {
         convertTableEntries(table, result);
         return result;
     }
+    /// The width and match type of every key field of a table.
+    using KeyFields = std::vector<std::pair<int, cstring>>;
+
     void convertTableEntries(const IR::P4Table *table, Util::JsonObject *jsonTable) {
         auto entriesList = table->getEntries();
         if (entriesList == nullptr) return;
 
-        auto entries = mkArrayField(jsonTable, "entries");
-        int entryPriority = 1;  // default priority is defined by index position
+        // The key of every entry has the same fields, which are looked up only once.
+        KeyFields keyFields;
+        for (auto tableKey : table->getKey()->keyElements)
+            keyFields.emplace_back(tableKey->expression->type->width_bits(),
+                                   getKeyMatchType(tableKey));
+        // Tables may have very many const entries.  They are converted here only to report
+        // errors, and converted again one at a time while the JSON is written.  Actions are
+        // looked up now, as the maps may have changed by then.
+        std::vector<unsigned> actionIds;
+        actionIds.reserve(entriesList->size());
         for (auto e : entriesList->entries) {
-            auto entry = new Util::JsonObject();
-            entry->emplace_non_null("source_info", e->sourceInfoJsonObj());
-
-            auto keyset = e->getKeys();
-            auto matchKeys = mkArrayField(entry, "match_key");
-            int keyIndex = 0;
-            for (auto k : keyset->components) {
-                auto key = new Util::JsonObject();
-                auto tableKey = table->getKey()->keyElements.at(keyIndex);
-                auto keyWidth = tableKey->expression->type->width_bits();
-                auto k8 = ROUNDUP(keyWidth, 8);
-                auto matchType = getKeyMatchType(tableKey);
-                // Table key fields with match_kind optional will be
-                // represented in the BMv2 JSON file the same as a ternary
-                // field would be.
-                if (matchType == "optional") {
-                    key->emplace("match_type", "ternary");
+            actionIds.push_back(getEntryActionId(e));
+            (void)convertTableEntry(e, keyFields, actionIds.back(), 0);
+        }
+        jsonTable->emplace(
+            "entries", new Util::JsonStreamed([this, entriesList, keyFields,
+                                               actionIds](Util::JsonWriter &writer) {
+                writer.beginArray();
+                int entryPriority = 1;  // default priority is defined by index position
+                for (size_t index = 0; index < actionIds.size(); ++index)
+                    writer.value(convertTableEntry(entriesList->entries.at(index), keyFields,
+                                                   actionIds.at(index), entryPriority++));
+                writer.endArray();
+            }));
+    }
+    /// @returns the id of the action called by the const entry @p e.
+    unsigned getEntryActionId(const IR::Entry *e) {
+        auto actionRef = e->getAction();
+        if (!actionRef->is<IR::MethodCallExpression>())
+            ::error(ErrorType::ERR_INVALID, "Invalid action '%1%' in entries list.", actionRef);
+        auto actionCall = actionRef->to<IR::MethodCallExpression>();
+        auto method = actionCall->method->to<IR::PathExpression>()->path;
+        auto decl = ctxt->refMap->getDeclaration(method, true);
+        auto actionDecl = decl->to<IR::P4Action>();
+        unsigned id = get(ctxt->structure->ids, actionDecl, INVALID_ACTION_ID);
+        BUG_CHECK(id != INVALID_ACTION_ID, "Could not find id for %1%", actionDecl);
+        return id;
+    }
+    /// Converts the const entry @p e, which calls the action @p actionId, of a table with the
+    /// key @p keyFields.  The entry gets @p entryPriority unless it has a priority annotation.
+    Util::JsonObject *convertTableEntry(const IR::Entry *e, const KeyFields &keyFields,
+                                        unsigned actionId, int entryPriority) {
+        auto entry = new Util::JsonObject();
+        entry->emplace_non_null("source_info", e->sourceInfoJsonObj());
+
+        auto keyset = e->getKeys();
+        auto matchKeys = mkArrayField(entry, "match_key");
+        int keyIndex = 0;
+        for (auto k : keyset->components) {
+            auto key = new Util::JsonObject();
+            auto [keyWidth, matchType] = keyFields.at(keyIndex);
+            auto k8 = ROUNDUP(keyWidth, 8);
+            // Table key fields with match_kind optional will be
+            // represented in the BMv2 JSON file the same as a ternary
+            // field would be.
+            if (matchType == "optional") {
+                key->emplace("match_type", "ternary");
+            } else {
+                key->emplace("match_type", matchType);
+            }
+            if (matchType == corelib.exactMatch.name) {
+                if (k->is<IR::Constant>())
+                    key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                else if (k->is<IR::BoolLiteral>())
+                    // booleans are converted to ints
+                    key->emplace("key",
+                                 stringRepr(k->to<IR::BoolLiteral>()->value ? 1 : 0, k8));
+                else
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported exact key expression",
+                            k);
+            } else if (matchType == corelib.ternaryMatch.name) {
+                if (k->is<IR::Mask>()) {
+                    auto km = k->to<IR::Mask>();
+                    key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
+                    key->emplace("mask", stringRepr(km->right->to<IR::Constant>()->value, k8));
+                } else if (k->is<IR::Constant>()) {
+                    key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                    key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
+                } else if (k->is<IR::DefaultExpression>()) {
+                    key->emplace("key", stringRepr(0, k8));
+                    key->emplace("mask", stringRepr(0, k8));
                 } else {
-                    key->emplace("match_type", matchType);
+                    ::error(ErrorType::ERR_UNSUPPORTED,
+                            "%1%: unsupported ternary key expression", k);
                 }
-                if (matchType == corelib.exactMatch.name) {
-                    if (k->is<IR::Constant>())
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                    else if (k->is<IR::BoolLiteral>())
-                        // booleans are converted to ints
-                        key->emplace("key",
-                                     stringRepr(k->to<IR::BoolLiteral>()->value ? 1 : 0, k8));
+            } else if (matchType == corelib.lpmMatch.name) {
+                if (k->is<IR::Mask>()) {
+                    auto km = k->to<IR::Mask>();
+                    key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
+                    auto trailing_zeros = [](unsigned long n, unsigned long keyWidth) {
+                        return n ? __builtin_ctzl(n) : static_cast<int>(keyWidth);
+                    };
+                    auto count_ones = [](unsigned long n) {
+                        return n ? __builtin_popcountl(n) : 0;
+                    };
+                    auto mask =
+                        static_cast<unsigned long>(km->right->to<IR::Constant>()->value);
+                    auto len = trailing_zeros(mask, keyWidth);
+                    if (len + count_ones(mask) != keyWidth)  // any remaining 0s in the prefix?
+                        ::error(ErrorType::ERR_INVALID, "%1%: invalid mask for LPM key", k);
                     else
-                        ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported exact key expression",
-                                k);
-                } else if (matchType == corelib.ternaryMatch.name) {
-                    if (k->is<IR::Mask>()) {
-                        auto km = k->to<IR::Mask>();
-                        key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(km->right->to<IR::Constant>()->value, k8));
-                    } else if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("mask", stringRepr(0, k8));
-                    } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED,
-                                "%1%: unsupported ternary key expression", k);
-                    }
-                } else if (matchType == corelib.lpmMatch.name) {
-                    if (k->is<IR::Mask>()) {
-                        auto km = k->to<IR::Mask>();
-                        key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
-                        auto trailing_zeros = [](unsigned long n, unsigned long keyWidth) {
-                            return n ? __builtin_ctzl(n) : static_cast<int>(keyWidth);
-                        };
-                        auto count_ones = [](unsigned long n) {
-                            return n ? __builtin_popcountl(n) : 0;
-                        };
-                        auto mask =
-                            static_cast<unsigned long>(km->right->to<IR::Constant>()->value);
-                        auto len = trailing_zeros(mask, keyWidth);
-                        if (len + count_ones(mask) != keyWidth)  // any remaining 0s in the prefix?
-                            ::error(ErrorType::ERR_INVALID, "%1%: invalid mask for LPM key", k);
-                        else
-                            key->emplace("prefix_length", keyWidth - len);
-                    } else if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("prefix_length", keyWidth);
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("prefix_length", 0);
-                    } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported LPM key expression",
-                                k);
-                    }
-                } else if (matchType == "range") {
-                    if (k->is<IR::Range>()) {
-                        auto kr = k->to<IR::Range>();
-                        key->emplace("start", stringRepr(kr->left->to<IR::Constant>()->value, k8));
-                        key->emplace("end", stringRepr(kr->right->to<IR::Constant>()->value, k8));
-                    } else if (k->is<IR::Constant>()) {
-                        key->emplace("start", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("end", stringRepr(k->to<IR::Constant>()->value, k8));
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("start", stringRepr(0, k8));
-                        key->emplace("end", stringRepr((1 << keyWidth) - 1, k8));  // 2^N -1
-                    } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED, "%1% unsupported range key expression",
-                                k);
-                    }
-                } else if (matchType == "optional") {
-                    // Table key fields with match_kind optional with
-                    // "const entries" in the P4 source code will be
-                    // represented using the same "key" and "mask" keys in
-                    // the BMv2 JSON file as table key fields with
-                    // match_kind ternary.  In the P4 source code we only
-                    // allow exact values or a DefaultExpression (_ or
-                    // default), no &&& expression.
-                    if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("mask", stringRepr(0, k8));
-                    } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED,
-                                "%1%: unsupported optional key expression", k);
-                    }
+                        key->emplace("prefix_length", keyWidth - len);
+                } else if (k->is<IR::Constant>()) {
+                    key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                    key->emplace("prefix_length", keyWidth);
+                } else if (k->is<IR::DefaultExpression>()) {
+                    key->emplace("key", stringRepr(0, k8));
+                    key->emplace("prefix_length", 0);
                 } else {
-                    ::error(ErrorType::ERR_UNKNOWN, "unknown key match type '%2%' for key %1%", k,
-                            matchType);
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported LPM key expression",
+                            k);
+                }
+            } else if (matchType == "range") {
+                if (k->is<IR::Range>()) {
+                    auto kr = k->to<IR::Range>();
+                    key->emplace("start", stringRepr(kr->left->to<IR::Constant>()->value, k8));
+                    key->emplace("end", stringRepr(kr->right->to<IR::Constant>()->value, k8));
+                } else if (k->is<IR::Constant>()) {
+                    key->emplace("start", stringRepr(k->to<IR::Constant>()->value, k8));
+                    key->emplace("end", stringRepr(k->to<IR::Constant>()->value, k8));
+                } else if (k->is<IR::DefaultExpression>()) {
+                    key->emplace("start", stringRepr(0, k8));
+                    key->emplace("end", stringRepr((1 << keyWidth) - 1, k8));  // 2^N -1
+                } else {
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1% unsupported range key expression",
+                            k);
+                }
+            } else if (matchType == "optional") {
+                // Table key fields with match_kind optional with
+                // "const entries" in the P4 source code will be
+                // represented using the same "key" and "mask" keys in
+                // the BMv2 JSON file as table key fields with
+                // match_kind ternary.  In the P4 source code we only
+                // allow exact values or a DefaultExpression (_ or
+                // default), no &&& expression.
+                if (k->is<IR::Constant>()) {
+                    key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                    key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
+                } else if (k->is<IR::DefaultExpression>()) {
+                    key->emplace("key", stringRepr(0, k8));
+                    key->emplace("mask", stringRepr(0, k8));
+                } else {
+                    ::error(ErrorType::ERR_UNSUPPORTED,
+                            "%1%: unsupported optional key expression", k);
                 }
-                matchKeys->append(key);
-                keyIndex++;
-            }
-
-            auto action = new Util::JsonObject();
-            auto actionRef = e->getAction();
-            if (!actionRef->is<IR::MethodCallExpression>())
-                ::error(ErrorType::ERR_INVALID, "Invalid action '%1%' in entries list.", actionRef);
-            auto actionCall = actionRef->to<IR::MethodCallExpression>();
-            auto method = actionCall->method->to<IR::PathExpression>()->path;
-            auto decl = ctxt->refMap->getDeclaration(method, true);
-            auto actionDecl = decl->to<IR::P4Action>();
-            unsigned id = get(ctxt->structure->ids, actionDecl, INVALID_ACTION_ID);
-            BUG_CHECK(id != INVALID_ACTION_ID, "Could not find id for %1%", actionDecl);
-            action->emplace("action_id", id);
-            auto actionData = mkArrayField(action, "action_data");
-            for (auto arg : *actionCall->arguments) {
-                actionData->append(stringRepr(arg->expression->to<IR::Constant>()->value, 0));
-            }
-            entry->emplace("action_entry", action);
-
-            auto priorityAnnotation = e->getAnnotation("priority");
-            if (priorityAnnotation != nullptr) {
-                if (priorityAnnotation->expr.size() > 1)
-                    ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%",
-                            priorityAnnotation->expr);
-                auto priValue = priorityAnnotation->expr.front();
-                if (!priValue->is<IR::Constant>())
-                    ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%; must be constant.",
-                            priorityAnnotation->expr);
-                entry->emplace("priority", priValue->to<IR::Constant>()->value);
             } else {
-                entry->emplace("priority", entryPriority);
+                ::error(ErrorType::ERR_UNKNOWN, "unknown key match type '%2%' for key %1%", k,
+                        matchType);
             }
-            entryPriority += 1;
+            matchKeys->append(key);
+            keyIndex++;
+        }
 
-            entries->append(entry);
+        auto action = new Util::JsonObject();
+        auto actionCall = e->getAction()->to<IR::MethodCallExpression>();
+        action->emplace("action_id", actionId);
+        auto actionData = mkArrayField(action, "action_data");
+        for (auto arg : *actionCall->arguments) {
+            actionData->append(stringRepr(arg->expression->to<IR::Constant>()->value, 0));
+        }
+        entry->emplace("action_entry", action);
+
+        auto priorityAnnotation = e->getAnnotation("priority");
+        if (priorityAnnotation != nullptr) {
+            if (priorityAnnotation->expr.size() > 1)
+                ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%",
+                        priorityAnnotation->expr);
+            auto priValue = priorityAnnotation->expr.front();
+            if (!priValue->is<IR::Constant>())
+                ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%; must be constant.",
+                        priorityAnnotation->expr);
+            entry->emplace("priority", priValue->to<IR::Constant>()->value);
+        } else {
+            entry->emplace("priority", entryPriority);
         }
+        return entry;
     }
     cstring getKeyMatchType(const IR::KeyElement *ke) {
         auto path = ke->matchType->path;
@@ -752,6 +782,8 @@ class ControlConverter : public Inspector {
 
  public:
     const bool emitExterns;
+    /// Optimize the control-flow graph before emitting it, see CFG::optimize.
+    const bool optimizePipeline;
     bool preorder(const IR::P4Control *cont) override {
         auto result = new Util::JsonObject();
 
@@ -763,6 +795,7 @@ class ControlConverter : public Inspector {
         cfg->build(cont, ctxt->refMap, ctxt->typeMap);
         bool success = cfg->checkImplementable();
         if (!success) return false;
+        if (optimizePipeline) cfg->optimize(ctxt->refMap, ctxt->typeMap);
 
         if (cfg->entryPoint->successors.size() == 0) {
             result->emplace("init_table", Util::JsonValue::null);
@@ -827,11 +860,13 @@ class ControlConverter : public Inspector {
         return false;
     }
 
-    explicit ControlConverter(ConversionContext *ctxt, cstring name, const bool &emitExterns_)
+    explicit ControlConverter(ConversionContext *ctxt, cstring name, const bool &emitExterns_,
+                              bool optimizePipeline_ = false)
         : ctxt(ctxt),
           name(name),
           corelib(P4::P4CoreLibrary::instance()),
-          emitExterns(emitExterns_) {
+          emitExterns(emitExterns_),
+          optimizePipeline(optimizePipeline_) {
         setName("ControlConverter");
     }
 };
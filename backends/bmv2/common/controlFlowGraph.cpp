@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "controlFlowGraph.h"
 
+#include <map>
+#include <vector>
+
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/fromv1.0/v1model.h"
 #include "frontends/p4/methodInstance.h"
@@ -308,4 +311,176 @@ void CFG::build(const IR::P4Control *cc, P4::ReferenceMap *refMap, P4::TypeMap *
     LOG2(this);
 }
 
+CFG::Statistics &CFG::statistics() {
+    static Statistics STATISTICS;
+    return STATISTICS;
+}
+
+void CFG::Statistics::dbprint(std::ostream &out) const {
+    out << "Pipeline optimization: merged " << mergedConditionals << " conditionals, removed "
+        << removedConditionals << " conditionals and " << removedTables << " table invocations";
+}
+
+namespace {
+
+/// @returns true if applying @table has no effect: all its actions have empty
+/// bodies, its default action is constant, and it has no properties such as
+/// counters or an implementation which the control plane could observe.
+bool isNoOpTable(const IR::P4Table *table, P4::ReferenceMap *refMap) {
+    bool constDefault = false;
+    for (auto property : table->properties->properties) {
+        auto name = property->name.name;
+        if (name == IR::TableProperties::defaultActionPropertyName) {
+            constDefault = property->isConstant;
+        } else if (name != IR::TableProperties::actionsPropertyName &&
+                   name != IR::TableProperties::keyPropertyName &&
+                   name != IR::TableProperties::entriesPropertyName &&
+                   name != IR::TableProperties::sizePropertyName) {
+            return false;
+        }
+    }
+    if (!constDefault) return false;
+    auto actions = table->getActionList();
+    if (actions == nullptr) return false;
+    for (auto element : actions->actionList) {
+        auto action = refMap->getDeclaration(element->getPath(), true)->to<IR::P4Action>();
+        if (action == nullptr || !action->body->components.empty()) return false;
+    }
+    return true;
+}
+
+/// @returns the node which all @edges lead to, or nullptr if they lead to
+/// different nodes.
+CFG::Node *singleDestination(const CFG::EdgeSet &edges) {
+    CFG::Node *result = nullptr;
+    for (auto e : edges.edges) {
+        if (result != nullptr && e->endpoint != result) return nullptr;
+        result = e->endpoint;
+    }
+    return result;
+}
+
+/// Removes the edges leading to @node from @edges.
+void eraseEdges(CFG::EdgeSet &edges, const CFG::Node *node) {
+    std::vector<CFG::Edge *> stale;
+    for (auto e : edges.edges)
+        if (e->endpoint == node) stale.push_back(e);
+    for (auto e : stale) edges.edges.erase(e);
+}
+
+}  // end anonymous namespace
+
+void CFG::bypass(Node *node, Node *next) {
+    for (auto p : node->predecessors.edges) {
+        for (auto e : p->endpoint->successors.edges)
+            if (e->endpoint == node) e->endpoint = next;
+        next->predecessors.emplace(p);
+    }
+    eraseEdges(next->predecessors, node);
+    allNodes.erase(node);
+}
+
+bool CFG::mergeConditional(IfNode *node, P4::TypeMap *typeMap) {
+    // Indexed by the value of the condition.
+    Edge *branches[2] = {nullptr, nullptr};
+    for (auto e : node->successors.edges) branches[e->getBool()] = e;
+    if (branches[false] == nullptr || branches[true] == nullptr) return false;
+    for (bool value : {true, false}) {
+        auto inner = branches[value]->endpoint->to<IfNode>();
+        if (inner == nullptr || inner->predecessors.size() != 1) continue;
+        Edge *innerBranches[2] = {nullptr, nullptr};
+        for (auto e : inner->successors.edges) innerBranches[e->getBool()] = e;
+        if (innerBranches[false] == nullptr || innerBranches[true] == nullptr) continue;
+        // if (a) { if (b) X else Y } else Y  =>  if (a && b) X else Y
+        // if (a) X else { if (b) X else Y }  =>  if (a || b) X else Y
+        if (innerBranches[!value]->endpoint != branches[!value]->endpoint) continue;
+
+        auto outerStatement = node->statement;
+        auto innerStatement = inner->statement;
+        auto srcInfo = outerStatement->condition->srcInfo;
+        const IR::Expression *condition;
+        if (value) {
+            condition = new IR::LAnd(srcInfo, IR::Type_Boolean::get(), outerStatement->condition,
+                                     innerStatement->condition);
+            node->statement = new IR::IfStatement(outerStatement->srcInfo, condition,
+                                                  innerStatement->ifTrue, outerStatement->ifFalse);
+        } else {
+            condition = new IR::LOr(srcInfo, IR::Type_Boolean::get(), outerStatement->condition,
+                                    innerStatement->condition);
+            node->statement = new IR::IfStatement(outerStatement->srcInfo, condition,
+                                                  outerStatement->ifTrue, innerStatement->ifFalse);
+        }
+        typeMap->setType(condition, IR::Type_Boolean::get());
+        LOG2("Merged " << inner->name << " into " << node->name);
+
+        auto next = innerBranches[value]->endpoint;
+        branches[value]->endpoint = next;
+        for (auto e : next->predecessors.edges)
+            if (e->endpoint == inner && e->getBool() == value) e->endpoint = node;
+        eraseEdges(innerBranches[!value]->endpoint->predecessors, inner);
+        allNodes.erase(inner);
+        return true;
+    }
+    return false;
+}
+
+void CFG::optimize(P4::ReferenceMap *refMap, P4::TypeMap *typeMap) {
+    std::map<const IR::P4Table *, unsigned> tableNodes;
+    for (auto n : allNodes) {
+        if (auto tn = n->to<TableNode>()) tableNodes[tn->table]++;
+    }
+    // Redirecting the edges of a table which appears in several nodes could
+    // make it unimplementable (see checkMergeable), so those are left alone.
+    auto isShared = [&](const Node *n) {
+        auto tn = n->to<TableNode>();
+        return tn != nullptr && tableNodes[tn->table] > 1;
+    };
+    auto canBypass = [&](const Node *n) {
+        for (auto p : n->predecessors.edges)
+            if (isShared(p->endpoint)) return false;
+        return true;
+    };
+
+    auto &stats = statistics();
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto node : std::vector<Node *>(allNodes.begin(), allNodes.end())) {
+            if (allNodes.count(node) == 0) continue;
+            auto next = singleDestination(node->successors);
+            if (auto tn = node->to<TableNode>()) {
+                if (next == nullptr) continue;
+                if (isNoOpTable(tn->table, refMap) && canBypass(node)) {
+                    LOG2("Removing " << node->name);
+                    bypass(node, next);
+                    stats.removedTables++;
+                    if (--tableNodes[tn->table] == 0 &&
+                        tn->table->getAnnotation(IR::Annotation::hiddenAnnotation) == nullptr)
+                        stats.removedTableNames.insert(tn->table->controlPlaneName());
+                    changed = true;
+                } else if (node->successors.size() > 1 && !isShared(node)) {
+                    // All actions, or both hit and miss, continue with the same node.  BMv2
+                    // still applies the table, this only shortens its next_tables.
+                    LOG2("Collapsing the successors of " << node->name);
+                    eraseEdges(next->predecessors, node);
+                    next->predecessors.emplace(new Edge(node));
+                    node->successors.edges.clear();
+                    node->successors.emplace(new Edge(next));
+                    changed = true;
+                }
+            } else if (auto in = node->to<IfNode>()) {
+                if (next != nullptr && canBypass(node)) {
+                    LOG2("Removing " << node->name);
+                    bypass(node, next);
+                    stats.removedConditionals++;
+                    changed = true;
+                } else if (mergeConditional(in, typeMap)) {
+                    stats.mergedConditionals++;
+                    changed = true;
+                }
+            }
+        }
+    }
+    LOG2(this);
+}
+
 }  // namespace BMV2
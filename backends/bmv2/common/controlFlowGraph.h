@@ -17,6 +17,8 @@ limitations under the License.
 #ifndef BACKENDS_BMV2_COMMON_CONTROLFLOWGRAPH_H_
 #define BACKENDS_BMV2_COMMON_CONTROLFLOWGRAPH_H_
 
+#include <set>
+
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
@@ -182,6 +184,33 @@ class CFG final : public IHasDbPrint {
     /// Thie method checks whether a CFG is implementable.
     bool checkImplementable() const;
 
+    /// Counters for the optimizations of all CFGs.
+    struct Statistics {
+        /// Conditionals merged into the conditional preceding them.
+        unsigned mergedConditionals = 0;
+        /// Conditionals removed because both branches lead to the same node.
+        unsigned removedConditionals = 0;
+        /// Table invocations removed because the table can only run actions which do nothing.
+        unsigned removedTables = 0;
+        /// Control-plane names of the tables which are no longer invoked at all, and so are
+        /// left out of the JSON.  Unless they are @hidden, they are still in the P4Info.
+        std::set<cstring> removedTableNames;
+
+        void dbprint(std::ostream &out) const;
+    };
+
+    /// @returns the statistics of all optimized CFGs.
+    static Statistics &statistics();
+
+    /// Reduces the number of nodes BMv2 visits for each packet.  Chains of
+    /// conditionals which share a branch are merged into a single conditional
+    /// using && or ||; conditionals whose branches meet immediately are removed;
+    /// tables whose actions all have empty bodies and whose default action is
+    /// constant are removed; tables whose hit and miss branches lead to the same
+    /// node get a single next node, which simplifies the JSON but saves no step.
+    /// Must be called on an implementable CFG and keeps it implementable.
+    void optimize(P4::ReferenceMap *refMap, P4::TypeMap *typeMap);
+
  private:
     bool dfs(Node *node, std::set<Node *> &visited, std::set<const IR::P4Table *> &stack) const;
     /// This is a set of table nodes that all represent the same
@@ -190,6 +219,11 @@ class CFG final : public IHasDbPrint {
     /// This requires their successor edgesets to be "compatible" with
     /// each other.  This is a constraint specific to BMv2.
     bool checkMergeable(std::set<TableNode *> nodes) const;
+    /// Removes @node from the graph; its predecessors jump to @next instead.
+    void bypass(Node *node, Node *next);
+    /// Merges the conditional following one branch of @node into @node.
+    /// @returns true if a conditional was merged.
+    bool mergeConditional(IfNode *node, P4::TypeMap *typeMap);
 };
 
 }  // namespace BMV2
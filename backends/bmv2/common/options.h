@@ -31,8 +31,11 @@ class BMV2Options : public CompilerOptions {
     cstring outputFile = nullptr;
     /// Read from json.
     bool loadIRFromJson = false;
+    /// Optimize the control-flow graphs of the pipelines.
+    bool optimizePipeline = false;
 
     BMV2Options() {
+        registerBinarySnapshotOptions();
         registerOption(
             "--emit-externs", nullptr,
             [this](const char *) {
@@ -57,6 +60,16 @@ class BMV2Options : public CompilerOptions {
             },
             "Use IR representation from JsonFile dumped previously,"
             "the compilation starts with reduced midEnd.");
+        registerOption(
+            "--optimize-pipeline", nullptr,
+            [this](const char *) {
+                optimizePipeline = true;
+                return true;
+            },
+            "[BMv2 back-end] Merge chains of conditionals, and remove conditionals and tables\n"
+            "which have no effect, to reduce the pipeline steps per packet.  Removed tables\n"
+            "can not be accessed by the control plane, but are still in the P4Runtime\n"
+            "output; a warning lists them.  A summary is printed to stderr with -v.");
     }
 };
 
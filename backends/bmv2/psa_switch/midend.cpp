@@ -87,7 +87,8 @@ class PsaEnumOn32Bits : public P4::ChooseEnumRepresentation {
     explicit PsaEnumOn32Bits(cstring filename) : filename(filename) {}
 };
 
-PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStream)
+PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStream,
+                                 bool cachedProgram)
     : MidEnd(options) {
     auto convertEnums = new P4::ConvertEnums(&refMap, &typeMap, new PsaEnumOn32Bits("psa.p4"));
     auto evaluator = new P4::EvaluatorPass(&refMap, &typeMap);
@@ -104,7 +105,9 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStre
             return false;
         return true;
     };
-    if (BMV2::PsaSwitchContext::get().options().loadIRFromJson == false) {
+    const auto &psaOptions = BMV2::PsaSwitchContext::get().options();
+    // A program loaded from a dump or the cache has already been through these passes.
+    if (!cachedProgram && !psaOptions.loadIRFromJson && !psaOptions.loadIRFromBinary) {
         addPasses({
             options.ndebug ? new P4::RemoveAssertAssume(&refMap, &typeMap) : nullptr,
             new P4::RemoveMiss(&refMap, &typeMap),
@@ -28,7 +28,10 @@ namespace BMV2 {
 class PsaSwitchMidEnd : public MidEnd {
  public:
     // If p4c is run with option '--listMidendPasses', outStream is used for printing passes names
-    explicit PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStream = nullptr);
+    /// If @p cachedProgram, the program is a mid-end result from the compilation cache, and
+    /// only the passes that compute the maps and the top-level block run.
+    explicit PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStream = nullptr,
+                             bool cachedProgram = false);
 };
 
 }  // namespace BMV2
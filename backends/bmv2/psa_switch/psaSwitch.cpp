@@ -218,11 +218,12 @@ void PsaCodeGenerator::createActions(ConversionContext *ctxt) {
 }
 
 void PsaCodeGenerator::createControls(ConversionContext *ctxt) {
-    auto cvt = new BMV2::ControlConverter<Standard::Arch::PSA>(ctxt, "ingress", true);
+    auto cvt =
+        new BMV2::ControlConverter<Standard::Arch::PSA>(ctxt, "ingress", true, optimizePipeline);
     auto ingress = pipelines.at("ingress");
     ingress->apply(*cvt);
 
-    cvt = new BMV2::ControlConverter<Standard::Arch::PSA>(ctxt, "egress", true);
+    cvt = new BMV2::ControlConverter<Standard::Arch::PSA>(ctxt, "egress", true, optimizePipeline);
     auto egress = pipelines.at("egress");
     egress->apply(*cvt);
 }
@@ -250,6 +251,7 @@ void PsaCodeGenerator::createGlobals() {
 void PsaSwitchBackend::convert(const IR::ToplevelBlock *tlb) {
     CHECK_NULL(tlb);
     PsaCodeGenerator structure(refMap, typeMap);
+    structure.optimizePipeline = options.optimizePipeline;
 
     auto parsePsaArch = new ParsePsaArchitecture(&structure);
     auto main = tlb->getMain();
@@ -96,6 +96,9 @@ class PsaSwitchExpressionConverter : public ExpressionConverter {
 
 class PsaCodeGenerator : public PsaProgramStructure {
  public:
+    /// Optimize the control-flow graphs of the pipelines, see CFG::optimize.
+    bool optimizePipeline = false;
+
     PsaCodeGenerator(P4::ReferenceMap *refMap, P4::TypeMap *typeMap)
         : PsaProgramStructure(refMap, typeMap) {}
 
@@ -16,22 +16,27 @@ limitations under the License.
 
 #include <cstdio>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "backends/bmv2/common/JsonObjects.h"
+#include "backends/bmv2/common/controlFlowGraph.h"
 #include "backends/bmv2/simple_switch/midend.h"
 #include "backends/bmv2/simple_switch/options.h"
 #include "backends/bmv2/simple_switch/simpleSwitch.h"
 #include "backends/bmv2/simple_switch/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compilationCache.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/frontend.h"
 #include "fstream"
+#include "ir/binary_snapshot.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
 #include "lib/algorithm.h"
+#include "lib/arena.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/gc.h"
@@ -40,6 +45,7 @@ limitations under the License.
 
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
+    Util::IRArena irArena;
 
     AutoCompileContext autoBMV2Context(new BMV2::SimpleSwitchContext);
     auto &options = BMV2::SimpleSwitchContext::get().options();
@@ -47,7 +53,7 @@ int main(int argc, char *const argv[]) {
     options.compilerVersion = BMV2_SIMPLESWITCH_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
     }
     if (::errorCount() > 0) return 1;
 
@@ -59,7 +65,7 @@ int main(int argc, char *const argv[]) {
     const IR::P4Program *program = nullptr;
     const IR::ToplevelBlock *toplevel = nullptr;
 
-    if (options.loadIRFromJson == false) {
+    if (!options.loadIRFromJson && !options.loadIRFromBinary) {
         program = P4::parseP4File(options);
 
         if (program == nullptr || ::errorCount() > 0) return 1;
@@ -75,32 +81,53 @@ int main(int argc, char *const argv[]) {
             return 1;
         }
         if (program == nullptr || ::errorCount() > 0) return 1;
-    } else {
-        std::filebuf fb;
-        if (fb.open(options.file, std::ios::in) == nullptr) {
-            ::error(ErrorType::ERR_IO, "%s: No such file or directory.", options.file);
-            return 1;
-        }
-        std::istream inJson(&fb);
-        JSONLoader jsonFileLoader(inJson);
-        if (jsonFileLoader.json == nullptr) {
-            ::error(ErrorType::ERR_IO, "%s: Not valid json input file", options.file);
+    } else if (options.loadIRFromBinary) {
+        auto *node = IR::readBinarySnapshot(options.file);
+        if (node == nullptr) return 1;
+        program = node->to<IR::P4Program>();
+        if (program == nullptr) {
+            ::error(ErrorType::ERR_INVALID, "%1% is not a P4Program snapshot", options.file);
             return 1;
         }
+    } else {
+        auto *json = loadJsonFile(options.file);
+        if (json == nullptr) return 1;
+        JSONLoader jsonFileLoader(json);
         program = new IR::P4Program(jsonFileLoader);
-        fb.close();
     }
 
     P4::serializeP4RuntimeIfRequired(program, options);
     if (::errorCount() > 0) return 1;
 
-    BMV2::SimpleSwitchMidEnd midEnd(options);
+    // The mid-end result and the JSON output are cached under the same key as the
+    // front-end result.  Logs, dumps and debug hooks need the passes to run.
+    bool useCache = options.compilationCacheDir && !options.loadIRFromJson &&
+                    !options.loadIRFromBinary && options.top4.empty() && !Log::verbose();
+    std::string json;
+    if (useCache && !options.dumpJsonFile && !options.dumpBinaryFile &&
+        !options.outputFile.isNullOrEmpty() &&
+        P4::CompilationCache::lookupOutput(options, "bmv2.json", json)) {
+        std::ostream *out = openFile(options.outputFile, false);
+        if (out != nullptr) {
+            *out << json;
+            out->flush();
+        }
+        return ::errorCount() > 0;
+    }
+    const IR::P4Program *cached =
+        useCache ? P4::CompilationCache::lookup(options, program, "midend") : nullptr;
+    if (cached != nullptr) program = cached;
+
+    BMV2::SimpleSwitchMidEnd midEnd(options, nullptr, cached != nullptr);
     midEnd.addDebugHook(hook);
     try {
         toplevel = midEnd.process(program);
         if (::errorCount() > 1 || toplevel == nullptr || toplevel->getMain() == nullptr) return 1;
+        if (useCache && cached == nullptr) P4::CompilationCache::store(options, program, "midend");
         if (options.dumpJsonFile && !options.loadIRFromJson)
             JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+        if (options.dumpBinaryFile && !options.loadIRFromBinary)
+            IR::writeBinarySnapshot(*openFile(options.dumpBinaryFile, true), program);
     } catch (const std::exception &bug) {
         std::cerr << bug.what() << std::endl;
         return 1;
@@ -119,10 +146,28 @@ int main(int argc, char *const argv[]) {
         return 1;
     }
     if (::errorCount() > 0) return 1;
+    if (options.optimizePipeline) {
+        if (Log::verbose()) std::cerr << BMV2::CFG::statistics() << std::endl;
+        const auto &removed = BMV2::CFG::statistics().removedTableNames;
+        if (!removed.empty() &&
+            (!options.p4RuntimeFile.isNullOrEmpty() || !options.p4RuntimeFiles.isNullOrEmpty() ||
+             !options.p4RuntimeEntriesFile.isNullOrEmpty() ||
+             !options.p4RuntimeEntriesFiles.isNullOrEmpty()))
+            ::warning(ErrorType::WARN_MISMATCH,
+                      "--optimize-pipeline removed tables which are still in the P4Runtime "
+                      "output, but can not be accessed by the control plane: %1%",
+                      cstring::join(removed.begin(), removed.end()));
+    }
 
     if (!options.outputFile.isNullOrEmpty()) {
         std::ostream *out = openFile(options.outputFile, false);
-        if (out != nullptr) {
+        if (out != nullptr && useCache) {
+            std::stringstream output;
+            backend->serialize(output);
+            P4::CompilationCache::storeOutput(options, "bmv2.json", output.str());
+            *out << output.str();
+            out->flush();
+        } else if (out != nullptr) {
             backend->serialize(*out);
             out->flush();
         }
@@ -66,10 +66,13 @@ limitations under the License.
 
 namespace BMV2 {
 
-SimpleSwitchMidEnd::SimpleSwitchMidEnd(CompilerOptions &options, std::ostream *outStream)
+SimpleSwitchMidEnd::SimpleSwitchMidEnd(CompilerOptions &options, std::ostream *outStream,
+                                       bool cachedProgram)
     : MidEnd(options) {
     auto *evaluator = new P4::EvaluatorPass(&refMap, &typeMap);
-    if (BMV2::SimpleSwitchContext::get().options().loadIRFromJson == false) {
+    const auto &bmv2Options = BMV2::SimpleSwitchContext::get().options();
+    // A program loaded from a dump or the cache has already been through these passes.
+    if (!cachedProgram && !bmv2Options.loadIRFromJson && !bmv2Options.loadIRFromBinary) {
         auto *convertEnums =
             new P4::ConvertEnums(&refMap, &typeMap, new EnumOn32Bits("v1model.p4"));
         addPasses(
@@ -1249,12 +1249,13 @@ void SimpleSwitchBackend::convert(const IR::ToplevelBlock *tlb) {
     createActions(ctxt, structure);
 
     ctxt->blockConverted = BlockConverted::Ingress;
-    auto cconv =
-        new ControlConverter<Standard::Arch::V1MODEL>(ctxt, "ingress", options.emitExterns);
+    auto cconv = new ControlConverter<Standard::Arch::V1MODEL>(
+        ctxt, "ingress", options.emitExterns, options.optimizePipeline);
     structure->ingress->apply(*cconv);
 
     ctxt->blockConverted = BlockConverted::Egress;
-    cconv = new ControlConverter<Standard::Arch::V1MODEL>(ctxt, "egress", options.emitExterns);
+    cconv = new ControlConverter<Standard::Arch::V1MODEL>(ctxt, "egress", options.emitExterns,
+                                                          options.optimizePipeline);
     structure->egress->apply(*cconv);
 
     ctxt->blockConverted = BlockConverted::Deparser;
@@ -19,6 +19,7 @@ limitations under the License.
 #include "backend.h"
 #include "control-plane/bfruntime_ext.h"
 #include "dpdkUtils.h"
+#include "lib/json_writer.h"
 #include "printUtils.h"
 namespace DPDK {
 
@@ -478,76 +479,85 @@ bool DpdkContextGenerator::addRefTables(const cstring tbl_name, const IR::P4Tabl
 // Add tables to the context json
 void DpdkContextGenerator::addMatchTables(Util::JsonArray *tablesJson) {
     for (auto t : tables) {
-        auto tbl = t->to<IR::P4Table>();
-        auto tableAttr = ::get(tableAttrmap, tbl->name.originalName);
-        auto *tableJson = initTableCommonJson(tbl->name.originalName, tableAttr);
-        bool hasActionProfileSelector = false;
-        bool isMatchTable = tableAttr.tableType == "match";
-        const IR::P4Table *memberTable = nullptr;
-        if (tableAttr.tableType != "selection") {
-            if (isMatchTable) {
-                hasActionProfileSelector = addRefTables(tbl->name, &memberTable, tableJson);
-                auto match_keys = tbl->getKey();
-                if (match_keys) {
-                    auto *keyJson = new Util::JsonArray();
-                    int position = 0;
-                    for (auto matchKeyFromPrg : tableAttr.tableKeys) {
-                        addKeyField(keyJson, matchKeyFromPrg.first, matchKeyFromPrg.second,
-                                    match_keys->keyElements.at(position), position);
-                        position++;
-                    }
-                    tableJson->emplace("match_key_fields", keyJson);
+        tablesJson->append(genTableJson(t->to<IR::P4Table>()));
+    }
+}
+
+// This function creates the JSON object of a single table.
+Util::JsonObject *DpdkContextGenerator::genTableJson(const IR::P4Table *tbl) {
+    auto tableAttr = ::get(tableAttrmap, tbl->name.originalName);
+    auto *tableJson = initTableCommonJson(tbl->name.originalName, tableAttr);
+    bool hasActionProfileSelector = false;
+    bool isMatchTable = tableAttr.tableType == "match";
+    const IR::P4Table *memberTable = nullptr;
+    if (tableAttr.tableType != "selection") {
+        if (isMatchTable) {
+            hasActionProfileSelector = addRefTables(tbl->name, &memberTable, tableJson);
+            auto match_keys = tbl->getKey();
+            if (match_keys) {
+                auto *keyJson = new Util::JsonArray();
+                int position = 0;
+                for (auto matchKeyFromPrg : tableAttr.tableKeys) {
+                    addKeyField(keyJson, matchKeyFromPrg.first, matchKeyFromPrg.second,
+                                match_keys->keyElements.at(position), position);
+                    position++;
                 }
+                tableJson->emplace("match_key_fields", keyJson);
             }
-            // If table implementation is action profile or action selector, all actions from member
-            // table should be output for the base table.
-            const IR::P4Table *table = nullptr;
-            if (hasActionProfileSelector) {
-                table = memberTable;
-            } else {
-                table = tbl;
-            }
+        }
+        // If table implementation is action profile or action selector, all actions from member
+        // table should be output for the base table.
+        const IR::P4Table *table = nullptr;
+        if (hasActionProfileSelector) {
+            table = memberTable;
+        } else {
+            table = tbl;
+        }
 
-            setActionAttributes(table);
-            setDefaultActionHandle(table);
+        setActionAttributes(table);
+        setDefaultActionHandle(table);
 
-            tableAttr = ::get(tableAttrmap, table->name.originalName);
-            tableJson->emplace("actions", addActions(table, tableAttr.controlName, isMatchTable));
-            if (isMatchTable) {
-                tableJson->emplace("match_attributes",
-                                   addMatchAttributes(table, tableAttr.controlName));
-            }
-            tableJson->emplace("default_action_handle", tableAttr.default_action_handle);
-        } else {
-            SelectionTable sel;
-            sel.setAttributes(tbl, tableAttrmap);
-            tableJson->emplace("max_n_groups", sel.max_n_groups);
-            tableJson->emplace("max_n_members_per_group", sel.max_n_members_per_group);
-            tableJson->emplace("bound_to_action_data_table_handle",
-                               sel.bound_to_action_data_table_handle);
+        tableAttr = ::get(tableAttrmap, table->name.originalName);
+        tableJson->emplace("actions", addActions(table, tableAttr.controlName, isMatchTable));
+        if (isMatchTable) {
+            tableJson->emplace("match_attributes",
+                               addMatchAttributes(table, tableAttr.controlName));
         }
-        tablesJson->append(tableJson);
+        tableJson->emplace("default_action_handle", tableAttr.default_action_handle);
+    } else {
+        SelectionTable sel;
+        sel.setAttributes(tbl, tableAttrmap);
+        tableJson->emplace("max_n_groups", sel.max_n_groups);
+        tableJson->emplace("max_n_members_per_group", sel.max_n_members_per_group);
+        tableJson->emplace("bound_to_action_data_table_handle",
+                           sel.bound_to_action_data_table_handle);
     }
+    return tableJson;
 }
 
 // Add extern information to the context json
 void DpdkContextGenerator::addExternInfo(Util::JsonArray *externsJson) {
     for (auto t : externs) {
-        auto externAttr = ::get(externAttrMap, t->name.name);
-        auto *externJson = new Util::JsonObject();
-        externJson->emplace("name", externAttr.externalName);
-        externJson->emplace("target_name", t->name.name);
-        externJson->emplace("type", externAttr.externType);
-        auto *attrJson = new Util::JsonObject();
-        if (externAttr.externType == "Counter" || externAttr.externType == "DirectCounter") {
-            attrJson->emplace("type", externAttr.counterType);
-        }
-        if (externAttr.externType == "DirectCounter" || externAttr.externType == "DirectMeter") {
-            attrJson->emplace("table_id", externAttr.table_id);
-        }
-        externJson->emplace("attributes", attrJson);
-        externsJson->append(externJson);
+        externsJson->append(genExternJson(t));
+    }
+}
+
+// This function creates the JSON object of a single extern instance.
+Util::JsonObject *DpdkContextGenerator::genExternJson(const IR::Declaration_Instance *t) {
+    auto externAttr = ::get(externAttrMap, t->name.name);
+    auto *externJson = new Util::JsonObject();
+    externJson->emplace("name", externAttr.externalName);
+    externJson->emplace("target_name", t->name.name);
+    externJson->emplace("type", externAttr.externType);
+    auto *attrJson = new Util::JsonObject();
+    if (externAttr.externType == "Counter" || externAttr.externType == "DirectCounter") {
+        attrJson->emplace("type", externAttr.counterType);
+    }
+    if (externAttr.externType == "DirectCounter" || externAttr.externType == "DirectMeter") {
+        attrJson->emplace("table_id", externAttr.table_id);
     }
+    externJson->emplace("attributes", attrJson);
+    return externJson;
 }
 
 const Util::JsonObject *DpdkContextGenerator::genContextJsonObject() {
@@ -569,11 +579,32 @@ const Util::JsonObject *DpdkContextGenerator::genContextJsonObject() {
     return json;
 }
 
+// Writes the context json while it is generated. Only the object of the current table or
+// extern is kept in memory. The output is identical to serializing genContextJsonObject().
 void DpdkContextGenerator::serializeContextJson(std::ostream *destination) {
     collectHandleId();
     CollectTablesAndSetAttributes();
-    auto *json = genContextJsonObject();
-    json->serialize(*destination);
+    struct TopLevelCtxt tlinfo;
+    tlinfo.initTopLevelCtxt(options);
+    Util::JsonWriter writer(*destination);
+    writer.beginObject();
+    writer.field("program_name", tlinfo.progName);
+    writer.field("build_date", tlinfo.buildDate);
+    writer.field("compile_command", tlinfo.compileCommand);
+    writer.field("compiler_version", tlinfo.compilerVersion);
+    writer.field("schema_version", cstring("0.1"));
+    writer.field("target", cstring("DPDK"));
+    writer.key("tables").beginArray();
+    for (auto t : tables) {
+        writer.value(genTableJson(t->to<IR::P4Table>()));
+    }
+    writer.endArray();
+    writer.key("externs").beginArray();
+    for (auto t : externs) {
+        writer.value(genExternJson(t));
+    }
+    writer.endArray();
+    writer.endObject();
     destination->flush();
 }
 
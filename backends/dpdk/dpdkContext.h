@@ -152,9 +152,11 @@ class DpdkContextGenerator : public Inspector {
     void serializeContextJson(std::ostream *destination);
     const Util::JsonObject *genContextJsonObject();
     void addMatchTables(Util::JsonArray *tablesJson);
+    Util::JsonObject *genTableJson(const IR::P4Table *tbl);
     size_t getHandleId(cstring name);
     void collectHandleId();
     void addExternInfo(Util::JsonArray *externsJson);
+    Util::JsonObject *genExternJson(const IR::Declaration_Instance *t);
     Util::JsonObject *initTableCommonJson(const cstring name, const struct TableAttributes &attr);
     void addKeyField(Util::JsonArray *keyJson, const cstring name, const cstring annon,
                      const IR::KeyElement *key, int position);
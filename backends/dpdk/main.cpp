@@ -31,8 +31,10 @@ limitations under the License.
 #include "frontends/common/parseInput.h"
 #include "frontends/common/parser_options.h"
 #include "frontends/p4/frontend.h"
+#include "ir/binary_snapshot.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
@@ -62,6 +64,7 @@ void generateTDIBfrtJson(bool isTDI, const IR::P4Program *program, DPDK::DpdkOpt
 
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
+    Util::IRArena irArena;
 
     AutoCompileContext autoDpdkContext(new DPDK::DpdkContext);
     auto &options = DPDK::DpdkContext::get().options();
@@ -69,7 +72,7 @@ int main(int argc, char *const argv[]) {
     options.compilerVersion = DPDK_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
     }
     if (::errorCount() > 0) return 1;
 
@@ -78,7 +81,7 @@ int main(int argc, char *const argv[]) {
     const IR::P4Program *program = nullptr;
     const IR::ToplevelBlock *toplevel = nullptr;
 
-    if (options.loadIRFromJson == false) {
+    if (!options.loadIRFromJson && !options.loadIRFromBinary) {
         program = P4::parseP4File(options);
 
         if (program == nullptr || ::errorCount() > 0) return 1;
@@ -94,20 +97,19 @@ int main(int argc, char *const argv[]) {
             return 1;
         }
         if (program == nullptr || ::errorCount() > 0) return 1;
-    } else {
-        std::filebuf fb;
-        if (fb.open(options.file, std::ios::in) == nullptr) {
-            ::error(ErrorType::ERR_NOT_FOUND, "%s: No such file or directory.", options.file);
-            return 1;
-        }
-        std::istream inJson(&fb);
-        JSONLoader jsonFileLoader(inJson);
-        if (jsonFileLoader.json == nullptr) {
-            ::error(ErrorType::ERR_INVALID, "Not valid input file");
+    } else if (options.loadIRFromBinary) {
+        auto *node = IR::readBinarySnapshot(options.file);
+        if (node == nullptr) return 1;
+        program = node->to<IR::P4Program>();
+        if (program == nullptr) {
+            ::error(ErrorType::ERR_INVALID, "%1% is not a P4Program snapshot", options.file);
             return 1;
         }
+    } else {
+        auto *json = loadJsonFile(options.file);
+        if (json == nullptr) return 1;
+        JSONLoader jsonFileLoader(json);
         program = new IR::P4Program(jsonFileLoader);
-        fb.close();
     }
 
     P4::serializeP4RuntimeIfRequired(program, options);
@@ -133,6 +135,8 @@ int main(int argc, char *const argv[]) {
         if (::errorCount() > 1 || toplevel == nullptr || toplevel->getMain() == nullptr) return 1;
         if (options.dumpJsonFile)
             JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+        if (options.dumpBinaryFile)
+            IR::writeBinarySnapshot(*openFile(options.dumpBinaryFile, true), program);
     } catch (const std::exception &bug) {
         std::cerr << bug.what() << std::endl;
         return 1;
@@ -168,7 +168,9 @@ DpdkMidEnd::DpdkMidEnd(CompilerOptions &options, std::ostream *outStream) {
         }
     };
 
-    if (DPDK::DpdkContext::get().options().loadIRFromJson == false) {
+    const auto &dpdkOptions = DPDK::DpdkContext::get().options();
+    // A program loaded from a dump has already been through these passes.
+    if (!dpdkOptions.loadIRFromJson && !dpdkOptions.loadIRFromBinary) {
         addPasses({
             options.ndebug ? new P4::RemoveAssertAssume(&refMap, &typeMap) : nullptr,
             new P4::RemoveMiss(&refMap, &typeMap),
@@ -38,6 +38,7 @@ class DpdkOptions : public CompilerOptions {
     bool enableEgress = false;
 
     DpdkOptions() {
+        registerBinarySnapshotOptions();
         registerOption(
             "--listMidendPasses", nullptr,
             [this](const char *) {
@@ -23,8 +23,10 @@ limitations under the License.
 #include "fstream"
 #include "graph_visitor.h"
 #include "graphs.h"
+#include "ir/binary_snapshot.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
 #include "lib/crash.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
@@ -68,6 +70,7 @@ class Options : public CompilerOptions {
     bool fullGraph = false;
     bool jsonOut = false;
     Options() {
+        registerBinarySnapshotOptions();
         registerOption(
             "--graphs-dir", "dir",
             [this](const char *arg) {
@@ -124,6 +127,7 @@ using GraphsContext = P4CContextWithOptions<Options>;
 
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
+    Util::IRArena irArena;
     setup_signals();
 
     AutoCompileContext autoGraphsContext(new ::graphs::GraphsContext);
@@ -132,7 +136,7 @@ int main(int argc, char *const argv[]) {
     options.compilerVersion = P4C_GRAPHS_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
     }
     if (::errorCount() > 0) return 1;
 
@@ -141,20 +145,18 @@ int main(int argc, char *const argv[]) {
     const IR::P4Program *program = nullptr;
 
     if (options.loadIRFromJson) {
-        std::filebuf fb;
-        if (fb.open(options.file, std::ios::in) == nullptr) {
-            ::error(ErrorType::ERR_IO, "%s: No such file or directory.", options.file);
-            return 1;
-        }
-
-        std::istream inJson(&fb);
-        JSONLoader jsonFileLoader(inJson);
-        if (jsonFileLoader.json == nullptr) {
-            ::error(ErrorType::ERR_IO, "Not valid input file");
+        auto *json = loadJsonFile(options.file);
+        if (json == nullptr) return 1;
+        JSONLoader jsonFileLoader(json);
+        program = new IR::P4Program(jsonFileLoader);
+    } else if (options.loadIRFromBinary) {
+        auto *node = IR::readBinarySnapshot(options.file);
+        if (node == nullptr) return 1;
+        program = node->to<IR::P4Program>();
+        if (program == nullptr) {
+            ::error(ErrorType::ERR_INVALID, "%1% is not a P4Program snapshot", options.file);
             return 1;
         }
-        program = new IR::P4Program(jsonFileLoader);
-        fb.close();
     } else {
         program = P4::parseP4File(options);
         if (program == nullptr || ::errorCount() > 0) return 1;
@@ -180,6 +182,8 @@ int main(int argc, char *const argv[]) {
         top = midEnd.process(program);
         if (options.dumpJsonFile)
             JSONGenerator(*openFile(options.dumpJsonFile, true)) << program << std::endl;
+        if (options.dumpBinaryFile)
+            IR::writeBinarySnapshot(*openFile(options.dumpBinaryFile, true), program);
     } catch (const std::exception &bug) {
         std::cerr << bug.what() << std::endl;
         return 1;
@@ -24,8 +24,10 @@ limitations under the License.
 #include "frontends/p4/evaluator/evaluator.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/p4/toP4/toP4.h"
+#include "ir/binary_snapshot.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
 #include "lib/crash.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
@@ -40,6 +42,7 @@ class P4TestOptions : public CompilerOptions {
     bool validateOnly = false;
     bool loadIRFromJson = false;
     P4TestOptions() {
+        registerBinarySnapshotOptions();
         registerOption(
             "--listMidendPasses", nullptr,
             [this](const char *) {
@@ -102,6 +105,7 @@ static void log_dump(const IR::Node *node, const char *head) {
 
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
+    Util::IRArena irArena;
     setup_signals();
 
     AutoCompileContext autoP4TestContext(new P4TestContext);
@@ -110,21 +114,23 @@ int main(int argc, char *const argv[]) {
     options.compilerVersion = P4TEST_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
     }
     if (::errorCount() > 0) return 1;
     const IR::P4Program *program = nullptr;
     auto hook = options.getDebugHook();
     if (options.loadIRFromJson) {
-        std::ifstream json(options.file);
-        if (json) {
+        if (auto *json = loadJsonFile(options.file)) {
             JSONLoader loader(json);
             const IR::Node *node = nullptr;
             loader >> node;
             if (!(program = node->to<IR::P4Program>()))
                 error(ErrorType::ERR_INVALID, "%s is not a P4Program in json format", options.file);
-        } else {
-            error(ErrorType::ERR_IO, "Can't open %s", options.file);
+        }
+    } else if (options.loadIRFromBinary) {
+        if (auto *node = IR::readBinarySnapshot(options.file)) {
+            if (!(program = node->to<IR::P4Program>()))
+                error(ErrorType::ERR_INVALID, "%s is not a P4Program snapshot", options.file);
         }
     } else {
         program = P4::parseP4File(options);
@@ -177,6 +183,8 @@ int main(int argc, char *const argv[]) {
         if (program) {
             if (options.dumpJsonFile)
                 JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+            if (options.dumpBinaryFile)
+                IR::writeBinarySnapshot(*openFile(options.dumpBinaryFile, true), program);
             if (options.debugJson) {
                 std::stringstream ss1, ss2;
                 JSONGenerator gen1(ss1), gen2(ss2);
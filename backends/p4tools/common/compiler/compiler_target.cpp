@@ -13,8 +13,10 @@
 #include "frontends/common/parseInput.h"
 #include "frontends/common/parser_options.h"
 #include "frontends/p4/frontend.h"
+#include "ir/binary_snapshot.h"
 #include "lib/compile_context.h"
 #include "lib/error.h"
+#include "lib/nullstream.h"
 
 namespace P4Tools {
 
@@ -67,7 +69,10 @@ CompilerResultOrError CompilerTarget::runCompilerImpl(const IR::P4Program *progr
 }
 
 ICompileContext *CompilerTarget::makeContextImpl() const {
-    return new CompileContext<CompilerOptions>();
+    auto *context = new CompileContext<CompilerOptions>();
+    // See runParser and runFrontend.
+    context->options().registerBinarySnapshotOptions();
+    return context;
 }
 
 std::vector<const char *> *CompilerTarget::initCompilerImpl(int argc, char **argv) const {
@@ -76,7 +81,19 @@ std::vector<const char *> *CompilerTarget::initCompilerImpl(int argc, char **arg
 }
 
 const IR::P4Program *CompilerTarget::runParser() {
-    auto &options = P4CContext::get().options();
+    auto &options = dynamic_cast<CompilerOptions &>(P4CContext::get().options());
+
+    if (options.loadIRFromBinary) {
+        const auto *node = IR::readBinarySnapshot(options.file);
+        if (node == nullptr) {
+            return nullptr;
+        }
+        const auto *program = node->to<IR::P4Program>();
+        if (program == nullptr) {
+            ::error(ErrorType::ERR_INVALID, "%1% is not a P4Program snapshot", options.file);
+        }
+        return program;
+    }
 
     const auto *program = P4::parseP4File(options);
     if (::errorCount() > 0) {
@@ -89,6 +106,11 @@ const IR::P4Program *CompilerTarget::runFrontend(const IR::P4Program *program) c
     // Dynamic cast to get the CompilerOptions from ParserOptions
     auto &options = dynamic_cast<CompilerOptions &>(P4CContext::get().options());
 
+    // A snapshot written by --toBinary has already been through the front end.
+    if (options.loadIRFromBinary) {
+        return program;
+    }
+
     P4::P4COptionPragmaParser optionsPragmaParser;
     program->apply(P4::ApplyOptionsPragmas(optionsPragmaParser));
 
@@ -98,6 +120,9 @@ const IR::P4Program *CompilerTarget::runFrontend(const IR::P4Program *program) c
     if ((program == nullptr) || ::errorCount() > 0) {
         return nullptr;
     }
+    if (!options.dumpBinaryFile.isNullOrEmpty()) {
+        IR::writeBinarySnapshot(*openFile(options.dumpBinaryFile, true), program);
+    }
     return program;
 }
 
@@ -0,0 +1,91 @@
+#include "backends/p4tools/common/core/constraint_slicer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <numeric>
+
+#include "ir/ir.h"
+#include "ir/visitor.h"
+
+namespace P4Tools {
+
+namespace {
+
+/// Collects the symbolic variables of an expression.
+class CollectSymbolicVariables : public Inspector {
+    SymbolicSet &result;
+
+ public:
+    explicit CollectSymbolicVariables(SymbolicSet &result) : result(result) {}
+
+    bool preorder(const IR::SymbolicVariable *var) override {
+        result.insert(var);
+        return false;
+    }
+};
+
+/// Finds the representative of @p index, compressing the path on the way.
+size_t findRoot(std::vector<size_t> &parents, size_t index) {
+    while (parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+}  // namespace
+
+const SymbolicSet &ConstraintSlicer::getVariables(const Constraint *constraint) {
+    auto [it, inserted] = variables.try_emplace(constraint);
+    if (inserted) {
+        constraint->apply(CollectSymbolicVariables(it->second));
+    }
+    return it->second;
+}
+
+SymbolicSet ConstraintSlicer::getVariables(const Group &group) {
+    SymbolicSet result;
+    for (const auto *constraint : group) {
+        const auto &vars = getVariables(constraint);
+        result.insert(vars.begin(), vars.end());
+    }
+    return result;
+}
+
+std::vector<ConstraintSlicer::Group> ConstraintSlicer::slice(
+    const std::vector<const Constraint *> &constraints) {
+    // Union-find over the constraints: two constraints end up in the same set if they are
+    // connected by a chain of shared symbolic variables.
+    std::vector<size_t> parents(constraints.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    std::map<const IR::SymbolicVariable *, size_t, SymbolicVarComp> owners;
+    for (size_t index = 0; index < constraints.size(); ++index) {
+        for (const auto *var : getVariables(constraints[index])) {
+            auto [it, inserted] = owners.emplace(var, index);
+            if (!inserted) {
+                auto root = findRoot(parents, it->second);
+                auto self = findRoot(parents, index);
+                // Keep the earliest constraint as the representative, so groups are ordered by
+                // their first constraint.
+                parents[std::max(root, self)] = std::min(root, self);
+            }
+        }
+    }
+
+    std::vector<Group> groups;
+    std::vector<size_t> groupOfRoot(constraints.size(), constraints.size());
+    for (size_t index = 0; index < constraints.size(); ++index) {
+        auto root = findRoot(parents, index);
+        if (groupOfRoot[root] == constraints.size()) {
+            groupOfRoot[root] = groups.size();
+            groups.emplace_back();
+        }
+        groups[groupOfRoot[root]].push_back(constraints[index]);
+    }
+    return groups;
+}
+
+void ConstraintSlicer::clear() { variables.clear(); }
+
+}  // namespace P4Tools
@@ -0,0 +1,39 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_CORE_CONSTRAINT_SLICER_H_
+#define BACKENDS_P4TOOLS_COMMON_CORE_CONSTRAINT_SLICER_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "ir/solver.h"
+
+namespace P4Tools {
+
+/// Partitions a list of constraints into groups which share no symbolic variables. Such groups
+/// are independent of each other: the list is satisfiable if and only if every group is, and
+/// the union of the models of the groups is a model of the list.
+class ConstraintSlicer {
+ public:
+    using Group = std::vector<const Constraint *>;
+
+    /// @returns the independent groups of @param constraints. Each group keeps the constraints
+    /// in their original order, and the groups are ordered by their first constraint.
+    std::vector<Group> slice(const std::vector<const Constraint *> &constraints);
+
+    /// @returns the symbolic variables of the constraints in @param group.
+    SymbolicSet getVariables(const Group &group);
+
+    /// Forgets the symbolic variables of all constraints seen so far.
+    void clear();
+
+ private:
+    /// The symbolic variables of each constraint seen so far. Constraints are immutable, so
+    /// entries never go stale.
+    std::unordered_map<const Constraint *, SymbolicSet> variables;
+
+    /// @returns the symbolic variables of @param constraint.
+    const SymbolicSet &getVariables(const Constraint *constraint);
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_CORE_CONSTRAINT_SLICER_H_ */
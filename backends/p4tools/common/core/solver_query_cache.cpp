@@ -0,0 +1,162 @@
+#include "backends/p4tools/common/core/solver_query_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "lib/hash.h"
+
+namespace P4Tools {
+
+SolverQueryCache::Query SolverQueryCache::canonicalize(
+    const std::vector<const Constraint *> &asserts) {
+    Query query(asserts.begin(), asserts.end());
+    std::sort(query.begin(), query.end(), std::less<const Constraint *>());
+    query.erase(std::unique(query.begin(), query.end()), query.end());
+    return query;
+}
+
+size_t SolverQueryCache::QueryHash::operator()(const Query &query) const {
+    return Util::hash(query.data(), query.size() * sizeof(Query::value_type));
+}
+
+SolverQueryCache::Entry *SolverQueryCache::findSatSuperset(const Query &query) const {
+    if (query.empty()) {
+        return nullptr;
+    }
+    // Every superset of the query contains all of its constraints. Only examine the entries of
+    // the rarest one.
+    const std::vector<Entry *> *candidates = nullptr;
+    for (const auto *constraint : query) {
+        auto it = satIndex.find(constraint);
+        if (it == satIndex.end()) {
+            return nullptr;
+        }
+        if (candidates == nullptr || it->second.size() < candidates->size()) {
+            candidates = &it->second;
+        }
+    }
+    size_t examined = 0;
+    for (auto it = candidates->rbegin(); it != candidates->rend(); ++it) {
+        if (++examined > MAX_CANDIDATES) {
+            break;
+        }
+        const auto &superset = (*it)->query;
+        if (std::includes(superset.begin(), superset.end(), query.begin(), query.end(),
+                          std::less<const Constraint *>())) {
+            return *it;
+        }
+    }
+    return nullptr;
+}
+
+SolverQueryCache::Entry *SolverQueryCache::findUnsatSubset(const Query &query) const {
+    size_t examined = 0;
+    for (const auto *constraint : query) {
+        auto it = unsatIndex.find(constraint);
+        if (it == unsatIndex.end()) {
+            continue;
+        }
+        for (const auto *entry : it->second) {
+            if (++examined > MAX_CANDIDATES) {
+                return nullptr;
+            }
+            const auto &subset = entry->query;
+            if (std::includes(query.begin(), query.end(), subset.begin(), subset.end(),
+                              std::less<const Constraint *>())) {
+                return entry;
+            }
+        }
+    }
+    return nullptr;
+}
+
+SolverQueryCache::Entry *SolverQueryCache::find(const Query &query) {
+    if (entries.size() >= MAX_ENTRIES || constraintCount >= MAX_CONSTRAINTS) {
+        evict();
+    }
+    auto &stats = statistics();
+    stats.queries++;
+    auto it = entries.find(query);
+    if (it != entries.end()) {
+        stats.exactHits++;
+        it->second.lastUsed = ++clock;
+        return &it->second;
+    }
+    if (auto *superset = findSatSuperset(query)) {
+        stats.satSupersetHits++;
+        const auto *model = superset->model;
+        superset->lastUsed = ++clock;
+        auto *entry = insert(query, true);
+        entry->model = model;
+        return entry;
+    }
+    if (auto *subset = findUnsatSubset(query)) {
+        stats.unsatSubsetHits++;
+        subset->lastUsed = ++clock;
+        return insert(query, false);
+    }
+    return nullptr;
+}
+
+SolverQueryCache::Entry *SolverQueryCache::insert(Query query, bool isSat) {
+    auto [it, inserted] = entries.emplace(query, Entry{query, isSat});
+    if (inserted) {
+        constraintCount += it->second.query.size();
+        index(it->second);
+    }
+    it->second.lastUsed = ++clock;
+    return &it->second;
+}
+
+void SolverQueryCache::index(Entry &entry) {
+    auto &index = entry.isSat ? satIndex : unsatIndex;
+    for (const auto *constraint : entry.query) {
+        index[constraint].push_back(&entry);
+    }
+}
+
+void SolverQueryCache::evict() {
+    std::vector<uint64_t> ages;
+    ages.reserve(entries.size());
+    for (const auto &[query, entry] : entries) {
+        ages.push_back(entry.lastUsed);
+    }
+    auto median = ages.begin() + ages.size() / 2;
+    std::nth_element(ages.begin(), median, ages.end());
+    auto &stats = statistics();
+    satIndex.clear();
+    unsatIndex.clear();
+    constraintCount = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.lastUsed < *median) {
+            stats.evictions++;
+            it = entries.erase(it);
+            continue;
+        }
+        constraintCount += it->second.query.size();
+        index(it->second);
+        ++it;
+    }
+    // The index lists are searched from the back, so keep the most recent entries there.
+    auto byAge = [](const Entry *left, const Entry *right) {
+        return left->lastUsed < right->lastUsed;
+    };
+    for (auto &[constraint, list] : satIndex) {
+        std::sort(list.begin(), list.end(), byAge);
+    }
+}
+
+void SolverQueryCache::clear() {
+    entries.clear();
+    satIndex.clear();
+    unsatIndex.clear();
+    constraintCount = 0;
+}
+
+SolverQueryCache::Statistics &SolverQueryCache::statistics() {
+    static Statistics STATISTICS;
+    return STATISTICS;
+}
+
+}  // namespace P4Tools
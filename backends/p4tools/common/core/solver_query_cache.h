@@ -0,0 +1,124 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_CORE_SOLVER_QUERY_CACHE_H_
+#define BACKENDS_P4TOOLS_COMMON_CORE_SOLVER_QUERY_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ir/solver.h"
+
+namespace P4Tools {
+
+/// Remembers the results of satisfiability checks, so that a solver does not prove the same
+/// thing twice. Queries are sets of constraints, compared by node identity. Besides exact
+/// matches, a query is known to be
+///   - satisfiable if it is a subset of a satisfiable query, whose model also satisfies it, and
+///   - unsatisfiable if it is a superset of an unsatisfiable query.
+/// The cache holds on to the constraints of its queries. Its size is bounded by the number of
+/// entries and by the number of constraints they hold; once either bound is exceeded, the least
+/// recently used half of the entries is dropped.
+class SolverQueryCache {
+ public:
+    /// A query in canonical form: sorted and free of duplicates.
+    using Query = std::vector<const Constraint *>;
+
+    struct Entry {
+        /// The constraints of this query.
+        Query query;
+
+        /// Whether the query is satisfiable.
+        bool isSat;
+
+        /// A model satisfying the query, once one has been computed. Only satisfiable queries
+        /// have a model.
+        const SymbolicMapping *model = nullptr;
+
+        /// The value of @ref clock when this entry was last looked up or inserted.
+        uint64_t lastUsed = 0;
+    };
+
+    /// Counters shared by all caches, reported by printPerformanceReport.
+    struct Statistics {
+        /// Satisfiability checks requested from the solver by its users. A check may look up
+        /// several queries, one for each of its independent groups.
+        std::atomic<uint64_t> checks = 0;
+        std::atomic<uint64_t> queries = 0;
+        std::atomic<uint64_t> exactHits = 0;
+        std::atomic<uint64_t> satSupersetHits = 0;
+        std::atomic<uint64_t> unsatSubsetHits = 0;
+        /// Checks which were sent to the solver itself.
+        std::atomic<uint64_t> solverCalls = 0;
+        /// Entries dropped to keep caches within their bounds.
+        std::atomic<uint64_t> evictions = 0;
+    };
+
+    /// @returns the canonical form of @param asserts.
+    static Query canonicalize(const std::vector<const Constraint *> &asserts);
+
+    /// Looks up the canonical @param query. If the result follows from a different query, an
+    /// entry for @param query itself is added, which inherits the model of a satisfiable
+    /// superset. If the cache is full, old entries are evicted first. Entries stay valid until
+    /// the next call to @ref find or @ref clear.
+    /// @returns the entry for @param query, or nullptr if its result is unknown.
+    Entry *find(const Query &query);
+
+    /// Records the result of the canonical @param query, unless it is known already.
+    /// @returns the entry for @param query.
+    Entry *insert(Query query, bool isSat);
+
+    /// Forgets all results.
+    void clear();
+
+    /// @returns the global cache statistics.
+    static Statistics &statistics();
+
+ private:
+    /// Upper bound on the number of entries.
+    static constexpr size_t MAX_ENTRIES = 1 << 16;
+
+    /// Upper bound on the number of constraints referenced by all entries together. Path
+    /// constraints grow with the depth of a path, so this bounds the memory held by the cache
+    /// better than the number of entries alone.
+    static constexpr size_t MAX_CONSTRAINTS = 1 << 22;
+
+    /// Upper bound on the number of candidate entries examined for subset and superset matches
+    /// of a single query.
+    static constexpr size_t MAX_CANDIDATES = 64;
+
+    struct QueryHash {
+        size_t operator()(const Query &query) const;
+    };
+
+    /// All known results, indexed by their query.
+    std::unordered_map<Query, Entry, QueryHash> entries;
+
+    /// Maps each constraint to the satisfiable entries whose query contains it.
+    std::unordered_map<const Constraint *, std::vector<Entry *>> satIndex;
+
+    /// Maps each constraint to the unsatisfiable entries whose query contains it.
+    std::unordered_map<const Constraint *, std::vector<Entry *>> unsatIndex;
+
+    /// Counts lookups and insertions, to order entries by their last use.
+    uint64_t clock = 0;
+
+    /// The number of constraints referenced by all entries.
+    size_t constraintCount = 0;
+
+    /// Drops the least recently used half of the entries and rebuilds the indices.
+    void evict();
+
+    /// Adds @param entry to the index matching its result.
+    void index(Entry &entry);
+
+    /// @returns a satisfiable entry whose query contains @param query.
+    Entry *findSatSuperset(const Query &query) const;
+
+    /// @returns an unsatisfiable entry whose query is contained in @param query.
+    Entry *findUnsatSubset(const Query &query) const;
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_CORE_SOLVER_QUERY_CACHE_H_ */
@@ -9,6 +9,7 @@
 #include <iterator>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include <boost/multiprecision/cpp_int.hpp>
@@ -83,6 +84,7 @@ z3::expr Z3Solver::declareVar(const IR::SymbolicVariable &var) {
     // Need to take the reference here to avoid accidental copies.
     auto *latestVars = &declaredVarsById.back();
     latestVars->emplace(expr.id(), &var);
+    contextVars.emplace(expr.id(), &var);
     return expr;
 }
 
@@ -96,6 +98,13 @@ void Z3Solver::reset() {
 void Z3Solver::clearMemory() {
     auto p4AssertionsBuf = p4Assertions;
     reset();
+    queryCache.clear();
+    slicer.clear();
+    // Cached translations refer to the old context and must go before it.
+    translations.clear();
+    contextVars.clear();
+    lastSatEntry = nullptr;
+    answeredFromCache = false;
     Z3_finalize_memory();
     z3solver = z3::solver(*new z3::context());
     p4Assertions.clear();
@@ -185,16 +194,159 @@ std::optional<bool> Z3Solver::interpretSolverResult(z3::check_result result) {
 
 std::optional<bool> Z3Solver::checkSat() {
     Util::ScopedTimer ctCheckSat("checkSat");
+    SolverQueryCache::statistics().solverCalls++;
     return interpretSolverResult(z3solver.check());
 }
 
 std::optional<bool> Z3Solver::checkSat(const z3::expr_vector &asserts) {
     Util::ScopedTimer ctCheckSat("checkSat");
+    SolverQueryCache::statistics().solverCalls++;
     return interpretSolverResult(z3solver.check(asserts));
 }
 
 std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &asserts) {
     Util::ScopedTimer ctZ3("z3");
+    SolverQueryCache::statistics().checks++;
+    lastSatEntry = nullptr;
+    answeredFromCache = false;
+    auto query = SolverQueryCache::canonicalize(asserts);
+    SolverQueryCache::Entry *entry = nullptr;
+    {
+        Util::ScopedTimer ctQueryCache("query_cache");
+        entry = queryCache.find(query);
+    }
+    if (entry == nullptr) {
+        std::vector<ConstraintSlicer::Group> groups;
+        {
+            Util::ScopedTimer ctSlicing("slicing");
+            groups = slicer.slice(asserts);
+        }
+        std::optional<bool> result;
+        if (groups.size() > 1) {
+            Z3_LOG("checking %zu independent groups", groups.size());
+            result = checkSatBySlices(groups);
+            answeredFromCache = true;
+        } else {
+            result = solve(asserts);
+        }
+        // Timeouts are not cached, a later query may have more time.
+        if (!result.has_value()) {
+            return std::nullopt;
+        }
+        entry = queryCache.insert(std::move(query), *result);
+    } else {
+        Z3_LOG("answered from cache:%s", entry->isSat ? "sat" : "unsat");
+        answeredFromCache = true;
+    }
+    if (entry->isSat) {
+        lastSatEntry = entry;
+        if (answeredFromCache) {
+            lastQuery = asserts;
+        }
+    }
+    return entry->isSat;
+}
+
+std::optional<bool> Z3Solver::checkSatBySlices(const std::vector<ConstraintSlicer::Group> &groups) {
+    std::optional<bool> result = true;
+    for (const auto &group : groups) {
+        auto query = SolverQueryCache::canonicalize(group);
+        std::optional<bool> groupResult;
+        if (const auto *entry = queryCache.find(query)) {
+            groupResult = entry->isSat;
+        } else {
+            groupResult = solve(group);
+            if (groupResult.has_value()) {
+                queryCache.insert(std::move(query), *groupResult);
+            }
+        }
+        // A single unsatisfiable group decides the query, even if another group timed out.
+        if (groupResult == false) {
+            return false;
+        }
+        if (!groupResult.has_value()) {
+            result = std::nullopt;
+        }
+    }
+    return result;
+}
+
+std::vector<std::optional<bool>> Z3Solver::checkSatAlternatives(
+    const std::vector<std::vector<const Constraint *>> &queries) {
+    // A single query benefits more from slicing.
+    if (queries.size() == 1) {
+        return {checkSat(queries.front())};
+    }
+    Util::ScopedTimer ctZ3("z3");
+    SolverQueryCache::statistics().checks += queries.size();
+    lastSatEntry = nullptr;
+    answeredFromCache = true;
+    std::vector<std::optional<bool>> results(queries.size());
+    std::vector<size_t> unknown;
+    {
+        Util::ScopedTimer ctQueryCache("query_cache");
+        for (size_t idx = 0; idx < queries.size(); ++idx) {
+            if (const auto *entry = queryCache.find(SolverQueryCache::canonicalize(queries[idx]))) {
+                results[idx] = entry->isSat;
+            } else {
+                unknown.push_back(idx);
+            }
+        }
+    }
+    // Alternatives made of independent groups are checked group by group, like in @ref checkSat.
+    // Groups shared with other alternatives, such as those of the common prefix, are then
+    // answered from the cache.
+    std::vector<size_t> unsliced;
+    for (auto idx : unknown) {
+        std::vector<ConstraintSlicer::Group> groups;
+        {
+            Util::ScopedTimer ctSlicing("slicing");
+            groups = slicer.slice(queries[idx]);
+        }
+        if (groups.size() <= 1) {
+            unsliced.push_back(idx);
+            continue;
+        }
+        Z3_LOG("checking %zu independent groups", groups.size());
+        results[idx] = checkSatBySlices(groups);
+        // Timeouts are not cached, a later query may have more time.
+        if (results[idx].has_value()) {
+            queryCache.insert(SolverQueryCache::canonicalize(queries[idx]), *results[idx]);
+        }
+    }
+    unknown = std::move(unsliced);
+    if (unknown.empty()) {
+        return results;
+    }
+    // Assert the longest prefix shared by all unknown queries once.
+    const auto &first = queries[unknown.front()];
+    size_t prefixLen = first.size();
+    for (auto idx : unknown) {
+        const auto &query = queries[idx];
+        auto end = first.begin() + std::min(prefixLen, query.size());
+        prefixLen = std::distance(first.begin(),
+                                  std::mismatch(first.begin(), end, query.begin()).first);
+    }
+    setAssertions({first.begin(), first.begin() + prefixLen});
+    Z3_LOG("checking %zu alternatives sharing %zu assertions", unknown.size(), prefixLen);
+    for (auto idx : unknown) {
+        const auto &query = queries[idx];
+        push();
+        for (auto it = query.begin() + prefixLen; it != query.end(); ++it) {
+            asrt(*it);
+        }
+        auto result = isIncremental ? checkSat() : checkSat(z3Assertions);
+        pop();
+        // Timeouts are not cached, a later query may have more time.
+        if (result.has_value()) {
+            queryCache.insert(SolverQueryCache::canonicalize(query), *result);
+        }
+        results[idx] = result;
+    }
+    return results;
+}
+
+void Z3Solver::setAssertions(const std::vector<const Constraint *> &asserts) {
     if (isIncremental) {
         // Find common prefix with the previous invocation's list of assertions
         auto from = asserts.begin();
@@ -214,6 +366,10 @@ std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &as
         push();
         asrt(asserts[i]);
     }
+}
+
+std::optional<bool> Z3Solver::solve(const std::vector<const Constraint *> &asserts) {
+    setAssertions(asserts);
     Z3_LOG("checking satisfiability for %d assertions",
            isIncremental ? z3solver.assertions().size() : z3Assertions.size());
     return isIncremental ? checkSat() : checkSat(z3Assertions);
@@ -244,12 +400,52 @@ void Z3Solver::asrt(const z3::expr &assertion) {
 
 const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     Util::ScopedTimer ctZ3("z3");
+    if (lastSatEntry != nullptr && lastSatEntry->model != nullptr) {
+        return *lastSatEntry->model;
+    }
+    if (!answeredFromCache) {
+        const auto &model = getZ3Model();
+        if (lastSatEntry != nullptr) {
+            lastSatEntry->model = &model;
+        }
+        return model;
+    }
+    BUG_CHECK(lastSatEntry != nullptr, "Z3Solver: the last query is unsatisfiable");
+    // Z3 has not seen the last query as a whole. Combine the models of its independent groups,
+    // solving the groups that have none yet. This does not change the logical state of the
+    // solver, it merely catches up on the query.
+    auto *self = const_cast<Z3Solver *>(this);
+    auto *result = new SymbolicMapping();
+    for (const auto &group : self->slicer.slice(lastQuery)) {
+        // The model of a group may be inherited from a satisfiable superset, which also assigns
+        // the variables of other groups. Only take the variables of this group from it.
+        auto vars = self->slicer.getVariables(group);
+        for (const auto &[var, value] : self->getGroupModel(group)) {
+            if (vars.count(var) != 0) {
+                result->emplace(var, value);
+            }
+        }
+    }
+    lastSatEntry->model = result;
+    return *result;
+}
+
+const SymbolicMapping &Z3Solver::getGroupModel(const ConstraintSlicer::Group &group) {
+    auto *entry = queryCache.insert(SolverQueryCache::canonicalize(group), true);
+    if (entry->model == nullptr) {
+        auto result = solve(group);
+        BUG_CHECK(result.value_or(false), "Z3Solver: can not reproduce a cached result");
+        entry->model = &getZ3Model();
+    }
+    return *entry->model;
+}
+
+const SymbolicMapping &Z3Solver::getZ3Model() const {
     auto *result = new SymbolicMapping();
     // First, collect a map of all the declared variables we have encountered in the stack.
     std::map<unsigned int, const IR::SymbolicVariable *> declaredVars;
     for (auto it = declaredVarsById.rbegin(); it != declaredVarsById.rend(); ++it) {
-        auto latestVars = *it;
-        for (auto var : latestVars) {
+        for (const auto &var : *it) {
             declaredVars.emplace(var);
         }
     }
@@ -270,9 +466,14 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
 
             // Convert to a symbolic variable and value.
             auto exprId = z3Expr.id();
-            BUG_CHECK(declaredVars.count(exprId) > 0, "Z3Solver: unknown variable declaration: %1%",
+            const IR::SymbolicVariable *symbolicVar = nullptr;
+            if (auto it = declaredVars.find(exprId); it != declaredVars.end()) {
+                symbolicVar = it->second;
+            } else if (auto it = contextVars.find(exprId); it != contextVars.end()) {
+                symbolicVar = it->second;
+            }
+            BUG_CHECK(symbolicVar != nullptr, "Z3Solver: unknown variable declaration: %1%",
                       z3Expr);
-            const auto *symbolicVar = declaredVars.at(exprId);
             const auto *value = toLiteral(z3Value, symbolicVar->type);
             result->emplace(symbolicVar, value);
         }
@@ -380,11 +581,9 @@ bool Z3Translator::preorder(const IR::Node *node) {
 }
 
 bool Z3Translator::preorder(const IR::Cast *cast) {
-    Z3Translator tCast(solver);
-    cast->expr->apply(tCast);
     uint64_t exprSize = 0;
     const auto *const castExtrType = cast->expr->type;
-    auto castExpr = tCast.result;
+    auto castExpr = translateCached(cast->expr);
     if (const auto *tb = cast->destType->to<IR::Type_Bits>()) {
         uint64_t destSize = tb->width_bits();
         if (const auto *exprType = castExtrType->to<IR::Type_Bits>()) {
@@ -499,9 +698,7 @@ const ShiftType *Z3Translator::rewriteShift(const ShiftType *shift) const {
 /// General function for unary operations.
 bool Z3Translator::recurseUnary(const IR::Operation_Unary *unary, Z3UnaryOp f) {
     BUG_CHECK(unary, "Z3Translator: encountered null node during translation");
-    Z3Translator tExpr(solver);
-    unary->expr->apply(tExpr);
-    result = f(tExpr.result);
+    result = f(translateCached(unary->expr));
     return false;
 }
 
@@ -584,11 +781,9 @@ bool Z3Translator::preorder(const IR::Concat *op) { return recurseBinary(op, z3:
 /// general function for binary operations
 bool Z3Translator::recurseBinary(const IR::Operation_Binary *binary, Z3BinaryOp f) {
     BUG_CHECK(binary, "Z3Translator: encountered null node during translation");
-    Z3Translator tLeft(solver);
-    Z3Translator tRight(solver);
-    binary->left->apply(tLeft);
-    binary->right->apply(tRight);
-    result = f(tLeft.result, tRight.result);
+    auto left = translateCached(binary->left);
+    auto right = translateCached(binary->right);
+    result = f(left, right);
     return false;
 }
 
@@ -604,21 +799,30 @@ bool Z3Translator::preorder(const IR::Slice *op) {
 /// general function for ternary operations
 bool Z3Translator::recurseTernary(const IR::Operation_Ternary *ternary, Z3TernaryOp f) {
     BUG_CHECK(ternary, "Z3Translator: encountered null node during translation");
-    Z3Translator t0(solver);
-    Z3Translator t1(solver);
-    Z3Translator t2(solver);
-    ternary->e0->apply(t0);
-    ternary->e1->apply(t1);
-    ternary->e2->apply(t2);
-    result = f(t0.result, t1.result, t2.result);
+    auto e0 = translateCached(ternary->e0);
+    auto e1 = translateCached(ternary->e1);
+    auto e2 = translateCached(ternary->e2);
+    result = f(e0, e1, e2);
     return false;
 }
 
 z3::expr Z3Translator::getResult() { return result; }
 
+z3::expr Z3Translator::translateCached(const IR::Expression *expression) {
+    auto &translations = solver.get().translations;
+    auto it = translations.find(expression);
+    if (it != translations.end()) {
+        return it->second;
+    }
+    Z3Translator translator(solver);
+    expression->apply(translator);
+    translations.emplace(expression, translator.result);
+    return translator.result;
+}
+
 z3::expr Z3Translator::translate(const IR::Expression *expression) {
     try {
-        expression->apply(*this);
+        result = translateCached(expression);
     } catch (z3::exception &e) {
         BUG("Z3Translator: Z3 exception: %1%\nExpression %2%", e.msg(), expression);
     }
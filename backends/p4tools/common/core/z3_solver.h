@@ -7,8 +7,11 @@
 #include <iosfwd>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "backends/p4tools/common/core/constraint_slicer.h"
+#include "backends/p4tools/common/core/solver_query_cache.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/solver.h"
@@ -44,6 +47,15 @@ class Z3Solver : public AbstractSolver {
 
     std::optional<bool> checkSat(const std::vector<const Constraint *> &asserts) override;
 
+    /// Checks each of the alternative @param queries, which typically share a long common prefix,
+    /// such as the path constraints of sibling branches. Queries which split into independent
+    /// groups are checked group by group. For the others, in incremental mode, the common prefix
+    /// is asserted once and every query only pushes and pops its own suffix. Afterwards, the
+    /// solver holds no model.
+    /// @returns the result of each query, std::nullopt if it timed out.
+    std::vector<std::optional<bool>> checkSatAlternatives(
+        const std::vector<std::vector<const Constraint *>> &queries);
+
     /// Z3Solver specific checkSat function. Calls check on the input z3::expr_vector.
     /// Only relies on the incrementality mode of the Z3 solver.
     std::optional<bool> checkSat(const z3::expr_vector &asserts);
@@ -116,6 +128,23 @@ class Z3Solver : public AbstractSolver {
     /// Helper function which converts a z3::check_result to a std::optional<bool>.
     static std::optional<bool> interpretSolverResult(z3::check_result result);
 
+    /// Checks @param asserts with Z3, bypassing @ref queryCache.
+    std::optional<bool> solve(const std::vector<const Constraint *> &asserts);
+
+    /// Makes @param asserts the active assertions of the solver. In incremental mode, only the
+    /// assertions after the common prefix with the active assertions are popped and pushed.
+    void setAssertions(const std::vector<const Constraint *> &asserts);
+
+    /// Checks the independent @param groups of a query one at a time. Groups with a known result
+    /// are not sent to Z3.
+    std::optional<bool> checkSatBySlices(const std::vector<ConstraintSlicer::Group> &groups);
+
+    /// @returns a model of the satisfiable @param group, solving it if no model is cached.
+    const SymbolicMapping &getGroupModel(const ConstraintSlicer::Group &group);
+
+    /// Converts the model of the last Z3 check.
+    [[nodiscard]] const SymbolicMapping &getZ3Model() const;
+
     /// The underlying Z3 instance.
     z3::solver z3solver;
 
@@ -143,6 +172,33 @@ class Z3Solver : public AbstractSolver {
     /// Stores the timeout, as last set by @ref timeout.
     std::optional<unsigned> timeout_;
 
+    /// Results of previous calls to @ref checkSat.
+    SolverQueryCache queryCache;
+
+    /// The cache entry of the last query, if that query was satisfiable. @ref getSymbolicMapping
+    /// stores the model it computes in this entry.
+    SolverQueryCache::Entry *lastSatEntry = nullptr;
+
+    /// Whether the last query was answered from @ref queryCache or group by group. Z3 then does
+    /// not hold a model for it.
+    bool answeredFromCache = false;
+
+    /// The last query, as passed to @ref checkSat. Only kept if Z3 does not hold its model.
+    std::vector<const Constraint *> lastQuery;
+
+    /// Splits queries into independent groups of constraints.
+    ConstraintSlicer slicer;
+
+    /// Translations of P4 expressions to Z3, shared by all translators of this solver. Entries
+    /// are valid for the lifetime of the Z3 context, so the cache is dropped with the context in
+    /// @ref clearMemory. Holding on to the Z3 expressions also keeps Z3 from reusing their IDs.
+    std::unordered_map<const IR::Expression *, z3::expr> translations;
+
+    /// Every variable declared in the current Z3 context, by Z3 expression ID. Assertions whose
+    /// translation is cached do not declare their variables again, so models are matched
+    /// against this map when a variable is not in @ref declaredVarsById.
+    std::unordered_map<unsigned, const IR::SymbolicVariable *> contextVars;
+
     DECLARE_TYPEINFO(Z3Solver, AbstractSolver);
 };
 
@@ -228,6 +284,10 @@ class Z3Translator : public virtual Inspector {
     /// @returns false.
     bool recurseTernary(const IR::Operation_Ternary *ternary, Z3TernaryOp f);
 
+    /// @returns the translation of the subexpression @param expression, which is only computed if
+    /// the solver has not translated @param expression before.
+    z3::expr translateCached(const IR::Expression *expression);
+
     /// Rewrites a shift operation so that the type of the shift amount matches that of the number
     /// being shifted.
     ///
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <unordered_map>
 
+#include "backends/p4tools/common/core/solver_query_cache.h"
 #include "lib/log.h"
 #include "lib/timer.h"
 
@@ -38,6 +39,32 @@ void printPerformanceReport(const std::optional<std::filesystem::path> &basePath
         }
         timerList.emplace_back(timerData);
     }
+    // Report how many solver queries were answered without invoking the solver.
+    const auto &cacheStats = SolverQueryCache::statistics();
+    if (cacheStats.queries > 0) {
+        uint64_t queries = cacheStats.queries;
+        uint64_t exactHits = cacheStats.exactHits;
+        uint64_t satSupersetHits = cacheStats.satSupersetHits;
+        uint64_t unsatSubsetHits = cacheStats.unsatSubsetHits;
+        uint64_t evictions = cacheStats.evictions;
+        uint64_t hits = exactHits + satSupersetHits + unsatSubsetHits;
+        auto hitRate = static_cast<float>(hits) / queries * 100;
+        printFeature("performance", 4,
+                     "Solver query cache: %i of %i queries answered (%0.2f %%): %i exact, %i "
+                     "from satisfiable supersets, %i from unsatisfiable subsets; %i entries "
+                     "evicted",
+                     hits, queries, hitRate, exactHits, satSupersetHits, unsatSubsetHits,
+                     evictions);
+        timerList.push_back({{"name", "query_cache_hits"},
+                             {"time", std::to_string(hits)},
+                             {"pct", std::to_string(hitRate)}});
+    }
+    if (cacheStats.solverCalls > 0) {
+        uint64_t solverCalls = cacheStats.solverCalls;
+        printFeature("performance", 4, "Solver calls: %i", solverCalls);
+        timerList.push_back(
+            {{"name", "solver_calls"}, {"time", std::to_string(solverCalls)}, {"pct", "0"}});
+    }
     // Write the report to the file, if one was provided.
     if (basePath.has_value()) {
         auto perfFilePath = basePath.value();
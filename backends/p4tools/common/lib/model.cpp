@@ -92,6 +92,11 @@ const IR::Literal *Model::evaluate(const IR::Expression *expr, bool doComplete,
     return literal;
 }
 
+const IR::Literal *Model::tryEvaluate(const IR::Expression *expr, bool doComplete) const {
+    const auto *substituted = expr->apply(SubstVisitor(*this, doComplete));
+    return P4::optimizeExpression(substituted)->to<IR::Literal>();
+}
+
 const IR::Expression *Model::get(const IR::SymbolicVariable *var, bool checked) const {
     auto it = symbolicMap.find(var);
     if (it != symbolicMap.end()) {
@@ -5,16 +5,16 @@
 #include <utility>
 #include <vector>
 
-#include <boost/container/flat_map.hpp>
-
+#include "backends/p4tools/common/lib/persistent_map.h"
 #include "ir/ir.h"
 #include "ir/solver.h"
 #include "ir/visitor.h"
 
 namespace P4Tools {
 
-/// Symbolic maps map a state variable to a IR::Expression.
-using SymbolicMapType = boost::container::flat_map<IR::StateVariable, const IR::Expression *>;
+/// Symbolic maps map a state variable to a IR::Expression. Execution states are forked often and
+/// share most of their variables, so copies of a symbolic map share their structure.
+using SymbolicMapType = PersistentMap<IR::StateVariable, const IR::Expression *>;
 
 /// Represents a solution found by the solver. A model is a concretized form of a symbolic
 /// environment. All the expressions in a Model must be of type IR::Literal.
@@ -65,6 +65,11 @@ class Model {
     const IR::Literal *evaluate(const IR::Expression *expr, bool doComplete,
                                 ExpressionMap *resolvedExpressions = nullptr) const;
 
+    /// Like @ref evaluate, but @returns nullptr if the expression does not fold to a literal,
+    /// for example because it contains a concolic call which has not been resolved.
+    [[nodiscard]] const IR::Literal *tryEvaluate(const IR::Expression *expr,
+                                                 bool doComplete) const;
+
     // Evaluates a P4 StructExpression in the context of this model. Recursively calls into
     // @evaluate and substitutes all members of this list with a Value type.
     const IR::StructExpression *evaluateStructExpr(
@@ -0,0 +1,342 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_MAP_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace P4Tools {
+
+/// An ordered map with value semantics whose copies share their structure. The map is a balanced
+/// (AVL) search tree of immutable nodes. An update copies the path from the root to the updated
+/// node and shares everything else with the previous version. Copying a map is O(1), lookups and
+/// updates are O(log n). Entries can not be removed.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class PersistentMap {
+ public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+ private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node {
+        value_type entry;
+        NodePtr left;
+        NodePtr right;
+
+        /// The height of the subtree rooted at this node.
+        int height;
+
+        Node(value_type entry, NodePtr left, NodePtr right)
+            : entry(std::move(entry)),
+              left(std::move(left)),
+              right(std::move(right)),
+              height(1 + std::max(heightOf(this->left), heightOf(this->right))) {}
+    };
+
+    /// The root of the tree. Null if the map is empty.
+    NodePtr root;
+
+    /// The number of entries in the map.
+    size_t count = 0;
+
+    static int heightOf(const NodePtr &node) { return node ? node->height : 0; }
+
+    static NodePtr makeNode(value_type entry, NodePtr left, NodePtr right) {
+        return std::make_shared<const Node>(std::move(entry), std::move(left), std::move(right));
+    }
+
+    /// @returns a node holding @param entry over the subtrees @param left and @param right, whose
+    /// heights may differ by at most two. Rotates the new node if they differ by two.
+    static NodePtr balance(const value_type &entry, const NodePtr &left, const NodePtr &right) {
+        auto leftHeight = heightOf(left);
+        auto rightHeight = heightOf(right);
+        if (leftHeight > rightHeight + 1) {
+            if (heightOf(left->left) >= heightOf(left->right)) {
+                return makeNode(left->entry, left->left, makeNode(entry, left->right, right));
+            }
+            const auto &pivot = left->right;
+            return makeNode(pivot->entry, makeNode(left->entry, left->left, pivot->left),
+                            makeNode(entry, pivot->right, right));
+        }
+        if (rightHeight > leftHeight + 1) {
+            if (heightOf(right->right) >= heightOf(right->left)) {
+                return makeNode(right->entry, makeNode(entry, left, right->left), right->right);
+            }
+            const auto &pivot = right->left;
+            return makeNode(pivot->entry, makeNode(entry, left, pivot->left),
+                            makeNode(right->entry, pivot->right, right->right));
+        }
+        return makeNode(entry, left, right);
+    }
+
+    /// @returns a copy of the tree at @param node in which @param key is mapped to @param value.
+    /// Sets @param inserted if @param key was not present before.
+    static NodePtr insert(const NodePtr &node, const Key &key, const Value &value,
+                          bool &inserted) {
+        if (!node) {
+            inserted = true;
+            return makeNode(value_type(key, value), nullptr, nullptr);
+        }
+        Compare less;
+        if (less(key, node->entry.first)) {
+            return balance(node->entry, insert(node->left, key, value, inserted), node->right);
+        }
+        if (less(node->entry.first, key)) {
+            return balance(node->entry, node->left, insert(node->right, key, value, inserted));
+        }
+        return makeNode(value_type(node->entry.first, value), node->left, node->right);
+    }
+
+ public:
+    /// Iterates over the entries of a map in key order.
+    class const_iterator {
+        friend class PersistentMap;
+
+        /// The current node on top, and below it the ancestors whose entries come after it.
+        std::vector<const Node *> path;
+
+        /// Pushes @param node and its chain of left children.
+        void descend(const Node *node) {
+            for (; node != nullptr; node = node->left.get()) {
+                path.push_back(node);
+            }
+        }
+
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        reference operator*() const { return path.back()->entry; }
+        pointer operator->() const { return &path.back()->entry; }
+
+        const_iterator &operator++() {
+            const auto *node = path.back();
+            path.pop_back();
+            descend(node->right.get());
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            if (path.empty() || other.path.empty()) {
+                return path.empty() && other.path.empty();
+            }
+            return path.back() == other.path.back();
+        }
+
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+    };
+
+    /// @returns the value of @param key, or nullptr if the map does not contain @param key. The
+    /// pointer stays valid as long as this version of the map is alive.
+    [[nodiscard]] const Value *find(const Key &key) const {
+        Compare less;
+        const auto *node = root.get();
+        while (node != nullptr) {
+            if (less(key, node->entry.first)) {
+                node = node->left.get();
+            } else if (less(node->entry.first, key)) {
+                node = node->right.get();
+            } else {
+                return &node->entry.second;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @returns whether the map contains @param key.
+    [[nodiscard]] bool contains(const Key &key) const { return find(key) != nullptr; }
+
+    /// Maps @param key to @param value. Copies of this map are not affected.
+    void set(const Key &key, const Value &value) {
+        bool inserted = false;
+        root = insert(root, key, value, inserted);
+        if (inserted) {
+            count++;
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] const_iterator begin() const {
+        const_iterator result;
+        result.descend(root.get());
+        return result;
+    }
+
+    [[nodiscard]] const_iterator end() const { return {}; }
+};
+
+/// An ordered set with value semantics whose copies share their structure, like PersistentMap.
+/// Copying a set is O(1), lookups and insertions are O(log n). Elements can not be removed.
+template <typename Key, typename Compare = std::less<Key>>
+class PersistentSet {
+    using Map = PersistentMap<Key, bool, Compare>;
+
+    /// Maps every element of the set to true.
+    Map elements;
+
+ public:
+    using value_type = Key;
+
+    /// Iterates over the elements of a set in order.
+    class const_iterator {
+        friend class PersistentSet;
+
+        typename Map::const_iterator it;
+
+        explicit const_iterator(typename Map::const_iterator it) : it(std::move(it)) {}
+
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Key *;
+        using reference = const Key &;
+
+        const_iterator() = default;
+
+        reference operator*() const { return it->first; }
+        pointer operator->() const { return &it->first; }
+
+        const_iterator &operator++() {
+            ++it;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator &other) const { return it == other.it; }
+
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+    };
+
+    /// Adds @param key to the set. Copies of this set are not affected.
+    /// @returns true if @param key was not in the set before.
+    bool insert(const Key &key) {
+        if (elements.contains(key)) {
+            return false;
+        }
+        elements.set(key, true);
+        return true;
+    }
+
+    /// @returns whether the set contains @param key.
+    [[nodiscard]] bool contains(const Key &key) const { return elements.contains(key); }
+
+    [[nodiscard]] size_t size() const { return elements.size(); }
+
+    [[nodiscard]] bool empty() const { return elements.empty(); }
+
+    [[nodiscard]] const_iterator begin() const { return const_iterator(elements.begin()); }
+
+    [[nodiscard]] const_iterator end() const { return const_iterator(elements.end()); }
+};
+
+/// A sequence with value semantics whose copies share their structure, for sequences that only
+/// grow at the end. It maps positions to elements in a PersistentMap: copying a sequence is O(1),
+/// appending and indexing are O(log n).
+template <typename T>
+class PersistentVector {
+    using Map = PersistentMap<size_t, T>;
+
+    Map elements;
+
+ public:
+    using value_type = T;
+
+    /// Iterates over the elements of a sequence in order.
+    class const_iterator {
+        friend class PersistentVector;
+
+        typename Map::const_iterator it;
+
+        explicit const_iterator(typename Map::const_iterator it) : it(std::move(it)) {}
+
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+
+        reference operator*() const { return it->second; }
+        pointer operator->() const { return &it->second; }
+
+        const_iterator &operator++() {
+            ++it;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator &other) const { return it == other.it; }
+
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+    };
+
+    /// Appends @param value. Copies of this sequence are not affected.
+    void push_back(const T &value) { elements.set(elements.size(), value); }
+
+    /// @returns the element at @param index, which must be smaller than size().
+    [[nodiscard]] const T &operator[](size_t index) const { return *elements.find(index); }
+
+    [[nodiscard]] size_t size() const { return elements.size(); }
+
+    [[nodiscard]] bool empty() const { return elements.empty(); }
+
+    [[nodiscard]] const_iterator begin() const { return const_iterator(elements.begin()); }
+
+    [[nodiscard]] const_iterator end() const { return const_iterator(elements.end()); }
+
+    /// @returns the elements in a vector, for consumers that need contiguous storage.
+    [[nodiscard]] std::vector<T> toVector() const { return {begin(), end()}; }
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_MAP_H_ */
@@ -17,19 +17,18 @@
 namespace P4Tools {
 
 const IR::Expression *SymbolicEnv::get(const IR::StateVariable &var) const {
-    auto it = map.find(var);
-    if (it != map.end()) {
-        return it->second;
+    if (const auto *value = map.find(var)) {
+        return *value;
     }
     BUG("Unable to find var %s in the symbolic environment.", var);
 }
 
-bool SymbolicEnv::exists(const IR::StateVariable &var) const { return map.find(var) != map.end(); }
+bool SymbolicEnv::exists(const IR::StateVariable &var) const { return map.contains(var); }
 
 void SymbolicEnv::set(const IR::StateVariable &var, const IR::Expression *value) {
     BUG_CHECK(value->type && !value->type->is<IR::Type_Unknown>(),
               "Cannot set value with unspecified type: %1%", value);
-    map[var] = value;
+    map.set(var, value);
 }
 
 const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
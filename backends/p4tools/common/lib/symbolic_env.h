@@ -8,7 +8,8 @@
 namespace P4Tools {
 
 /// A symbolic environment maps variables to their symbolic value. A symbolic value is just an
-/// expression on the program's initial state.
+/// expression on the program's initial state. Copies of an environment share their variables, so
+/// copying is O(1) and every update is O(log n) in the number of variables.
 class SymbolicEnv {
  private:
     SymbolicMapType map;
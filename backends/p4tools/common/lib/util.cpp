@@ -27,7 +27,7 @@ namespace P4Tools {
 
 std::optional<uint32_t> Utils::currentSeed = std::nullopt;
 
-boost::random::mt19937 Utils::rng(0);
+thread_local boost::random::mt19937 Utils::rng(0);
 
 std::string Utils::getTimeStamp() {
     // get current time
@@ -56,6 +56,12 @@ void Utils::setRandomSeed(int seed) {
 
 std::optional<uint32_t> Utils::getCurrentSeed() { return currentSeed; }
 
+void Utils::seedWorker(unsigned workerIndex) {
+    if (currentSeed.has_value()) {
+        rng.seed(currentSeed.value() + workerIndex);
+    }
+}
+
 uint64_t Utils::getRandInt(uint64_t max) {
     if (!currentSeed) {
         return 0;
@@ -48,8 +48,9 @@ class Utils {
      *  Seeds, timestamps, randomness.
      * ========================================================================================= */
  private:
-    /// The random generator of this project. It is initialized with the input seed.
-    static boost::random::mt19937 rng;
+    /// The random generator of this project. It is initialized with the input seed. Every thread
+    /// has its own generator, see @ref seedWorker.
+    static thread_local boost::random::mt19937 rng;
 
     /// Stores the state of the PRNG.
     static std::optional<uint32_t> currentSeed;
@@ -67,6 +68,10 @@ class Utils {
     /// @returns currentSeed.
     static std::optional<uint32_t> getCurrentSeed();
 
+    /// Seed the random generator of the calling thread for parallel worker @param workerIndex.
+    /// Workers derive their seed from @var currentSeed, so runs remain reproducible.
+    static void seedWorker(unsigned workerIndex);
+
     /// @returns a random integer in the range [0, @param max]. Always return 0 if no seed is set.
     static uint64_t getRandInt(uint64_t max);
 
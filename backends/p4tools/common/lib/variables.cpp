@@ -3,6 +3,9 @@
 #include <map>
 #include <string>
 #include <tuple>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 
 #include "ir/id.h"
 
@@ -41,6 +44,10 @@ const IR::TaintExpression *getTaintExpression(const IR::Type *type) {
     // type.
     using key_t = std::tuple<int, bool>;
     static std::map<key_t, const IR::TaintExpression *> TAINTS;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::lock_guard<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
 
     auto *&result = TAINTS[{tb->width_bits(), tb->isSigned}];
     if (result == nullptr) {
@@ -11,6 +11,7 @@
 #include "backends/p4tools/common/core/target.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "backends/p4tools/common/version.h"
+#include "frontends/common/options.h"
 #include "frontends/common/parser_options.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
@@ -64,19 +65,29 @@ std::optional<ICompileContext *> AbstractP4cToolOptions::process(
               cstring::join(unprocessedCompilerArgs->begin(), unprocessedCompilerArgs->end(), " "));
 
     // Remaining arguments should be source files. Ensure we have exactly one and send it to the
-    // compiler.
-    if (remainingArgs->size() > 1) {
-        ::error("Only one input file can be specified. Duplicate args:\n%1%",
-                cstring::join(remainingArgs->begin(), remainingArgs->end(), "\n  "));
-        usage();
-        return std::nullopt;
-    }
-    if (remainingArgs->empty()) {
-        ::error("No input files specified");
-        usage();
-        return std::nullopt;
+    // compiler. A snapshot given with --fromBinary has already replaced the input file.
+    auto &compilerOptions = dynamic_cast<CompilerOptions &>(P4CContext::get().options());
+    if (compilerOptions.loadIRFromBinary) {
+        if (!remainingArgs->empty()) {
+            ::error("--fromBinary replaces the input file. Unexpected args:\n%1%",
+                    cstring::join(remainingArgs->begin(), remainingArgs->end(), "\n  "));
+            usage();
+            return std::nullopt;
+        }
+    } else {
+        if (remainingArgs->size() > 1) {
+            ::error("Only one input file can be specified. Duplicate args:\n%1%",
+                    cstring::join(remainingArgs->begin(), remainingArgs->end(), "\n  "));
+            usage();
+            return std::nullopt;
+        }
+        if (remainingArgs->empty()) {
+            ::error("No input files specified");
+            usage();
+            return std::nullopt;
+        }
+        compilerOptions.file = remainingArgs->at(0);
     }
-    P4CContext::get().options().file = remainingArgs->at(0);
 
     if (!validateOptions()) {
         return std::nullopt;
@@ -169,6 +180,12 @@ AbstractP4cToolOptions::AbstractP4cToolOptions(cstring message) : Options(messag
          {}},
         {"--dump", "folder", "Folder where P4 programs are dumped.", {}},
         {"-v", nullptr, "Increase verbosity level (can be repeated)", {}},
+        {"--toBinary", "file",
+         "Dumps the program after the front end as a binary snapshot in the given file.", {}},
+        {"--fromBinary", "file",
+         "Reads the program from a snapshot written by --toBinary instead of parsing it and\n"
+         "running the front end.  The snapshot replaces the input file.",
+         {}},
     };
 
     registerOption(
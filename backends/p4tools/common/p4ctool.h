@@ -8,6 +8,7 @@
 #include "backends/p4tools/common/compiler/compiler_target.h"
 #include "backends/p4tools/common/lib/logging.h"
 #include "backends/p4tools/common/options.h"
+#include "lib/arena.h"
 
 namespace P4Tools {
 
@@ -31,6 +32,9 @@ class AbstractP4cTool {
     ///     Contains the path to the executable, followed by the command-line arguments for this
     ///     tool.
     int main(const std::vector<const char *> &args) {
+        // The IR arena, if any, has to outlive the compiler result passed to mainImpl.
+        Util::IRArena irArena;
+
         // Register supported compiler targets.
         registerTarget();
 
@@ -59,6 +63,9 @@ class AbstractP4cTool {
         if (!compilerResult.has_value()) {
             return EXIT_FAILURE;
         }
+        // Only the compiled program stays in the IR arena; what the tool allocates from now on
+        // goes to the garbage-collected heap.
+        irArena.endCompilation();
         return mainImpl(compilerResult.value());
     }
 };
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Merges the coverage of the checkpoints of a sharded P4Testgen run into a single report.
+
+Every shard of a run started with `--shard i/N --checkpoint <file>` saves the nodes it covered
+when it finishes. This script combines the checkpoints of all shards.
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+
+PARSER = argparse.ArgumentParser()
+
+PARSER.add_argument(
+    "checkpoints",
+    nargs="+",
+    type=Path,
+    help="The checkpoint files written by the shards of the run.",
+)
+PARSER.add_argument(
+    "-o",
+    "--output",
+    dest="output",
+    type=Path,
+    help="Write the merged coverage to this file as JSON.",
+)
+
+
+def main(options):
+    num_coverable_nodes = None
+    num_shards = None
+    shards = set()
+    visited_nodes = set()
+    test_count = 0
+    unexplored_branches = 0
+    for checkpoint_path in options.checkpoints:
+        with checkpoint_path.open() as checkpoint_file:
+            checkpoint = json.load(checkpoint_file)
+        if num_coverable_nodes is None:
+            num_coverable_nodes = checkpoint["num_coverable_nodes"]
+            num_shards = checkpoint["num_shards"]
+        if checkpoint["num_coverable_nodes"] != num_coverable_nodes:
+            print(f"{checkpoint_path} belongs to a different program.", file=sys.stderr)
+            return 1
+        if checkpoint["num_shards"] != num_shards:
+            print(f"{checkpoint_path} belongs to a different partition.", file=sys.stderr)
+            return 1
+        if checkpoint["shard_index"] in shards:
+            print(f"Shard {checkpoint['shard_index']} occurs twice.", file=sys.stderr)
+            return 1
+        shards.add(checkpoint["shard_index"])
+        visited_nodes.update(checkpoint["visited_nodes"])
+        test_count += checkpoint["test_count"]
+        unexplored_branches += len(checkpoint["unexplored_branches"])
+
+    missing_shards = sorted(set(range(num_shards)) - shards)
+    if missing_shards:
+        print(f"Missing shards: {missing_shards}", file=sys.stderr)
+    if unexplored_branches > 0:
+        print(f"{unexplored_branches} branches are still unexplored.", file=sys.stderr)
+
+    coverage = len(visited_nodes) / num_coverable_nodes if num_coverable_nodes else 1.0
+    print(f"Tests: {test_count}")
+    print(f"Nodes covered: {coverage} ({len(visited_nodes)}/{num_coverable_nodes})")
+    if options.output:
+        merged = {
+            "test_count": test_count,
+            "num_coverable_nodes": num_coverable_nodes,
+            "visited_nodes": sorted(visited_nodes),
+            "coverage": coverage,
+        }
+        with options.output.open("w") as output_file:
+            json.dump(merged, output_file)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(PARSER.parse_args()))
@@ -0,0 +1,288 @@
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "backends/p4tools/common/core/solver_query_cache.h"
+#include "frontends/common/options.h"
+#include "frontends/common/parser_options.h"
+#include "lib/compile_context.h"
+#include "lib/crash.h"
+#include "lib/timer.h"
+#include "nlohmann/json.hpp"
+
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/testgen.h"
+
+namespace P4Tools::P4Testgen::Benchmark {
+
+namespace {
+
+/// A program of the benchmark corpus.
+struct CorpusProgram {
+    /// The name of the program in the report.
+    const char *name;
+
+    /// The path of the program, relative to the root of the P4C source tree.
+    const char *file;
+
+    /// The path selection policy used for the program.
+    PathSelectionPolicy pathSelectionPolicy;
+
+    /// The number of tests generated for the program.
+    int64_t maxTests;
+};
+
+const std::vector<CorpusProgram> CORPUS = {
+    {"fabric", "testdata/p4_16_samples/fabric_20190420/fabric.p4",
+     PathSelectionPolicy::RandomBacktrack, 200},
+    {"fabric_dfs", "testdata/p4_16_samples/fabric_20190420/fabric.p4",
+     PathSelectionPolicy::DepthFirst, 200},
+    {"basic_routing", "testdata/p4_16_samples/basic_routing-bmv2.p4",
+     PathSelectionPolicy::DepthFirst, 100},
+    {"flowlet_switching", "testdata/p4_16_samples/flowlet_switching-bmv2.p4",
+     PathSelectionPolicy::DepthFirst, 100},
+    {"ipv6_switch_ml", "testdata/p4_16_samples/ipv6-switch-ml-bmv2.p4",
+     PathSelectionPolicy::GreedyStmtCoverage, 100},
+    {"nested_table_calls", "testdata/p4_16_samples/gauntlet_nested_table_calls-bmv2.p4",
+     PathSelectionPolicy::DepthFirst, 100},
+};
+
+/// The seed of every run.
+constexpr uint32_t SEED = 1;
+
+/// @returns the accumulated milliseconds of every timer category.
+std::map<std::string, size_t> getTimerValues() {
+    std::map<std::string, size_t> values;
+    for (const auto &timer : Util::getTimers()) {
+        values[timer.timerName.empty() ? "total" : timer.timerName] = timer.milliseconds;
+    }
+    return values;
+}
+
+/// @returns whether the timer @param name is the outermost solver timer on its path. The solver
+/// time is measured by the "z3" timer, whichever timers it is nested in.
+bool isSolverTimer(const std::string &name) {
+    std::stringstream path(name);
+    std::string component;
+    bool isSolver = false;
+    while (std::getline(path, component, '.')) {
+        if (isSolver) {
+            return false;
+        }
+        isSolver = component == "z3";
+    }
+    return isSolver;
+}
+
+/// @returns the peak resident set size of the process in kilobytes, if it is known.
+std::optional<int64_t> getPeakRss() {
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return std::nullopt;
+    }
+    // ru_maxrss is in kilobytes on Linux.
+    return usage.ru_maxrss;
+}
+
+/// @returns @param count per second of @param seconds.
+double perSecond(uint64_t count, double seconds) { return seconds > 0 ? count / seconds : 0; }
+
+/// Generates the tests for @param program and @returns its measurements.
+nlohmann::json runProgram(const std::filesystem::path &p4cRoot, const CorpusProgram &program) {
+    auto compilerOptions = P4CContextWithOptions<CompilerOptions>::get().options();
+    compilerOptions.target = "bmv2";
+    compilerOptions.arch = "v1model";
+    compilerOptions.preprocessor_options = "-I" + (p4cRoot / "p4include").string();
+    compilerOptions.file = (p4cRoot / program.file).string();
+
+    auto &testgenOptions = TestgenOptions::get();
+    testgenOptions.testBackend = "PROTOBUF_IR";
+    testgenOptions.testBaseName = program.name;
+    testgenOptions.seed = SEED;
+    testgenOptions.minPktSize = 512;
+    testgenOptions.maxPktSize = 512;
+    testgenOptions.pathSelectionPolicy = program.pathSelectionPolicy;
+    testgenOptions.maxTests = program.maxTests;
+
+    // All counters are global, so every run reports the difference to the previous one.
+    auto &executorStats = SymbolicExecutor::statistics();
+    auto &solverStats = SolverQueryCache::statistics();
+    uint64_t steps = executorStats.steps;
+    uint64_t solverQueries = solverStats.checks;
+    uint64_t solverCalls = solverStats.solverCalls;
+    auto timersBefore = getTimerValues();
+
+    auto start = std::chrono::steady_clock::now();
+    auto tests = Testgen::generateTests(compilerOptions, testgenOptions);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    nlohmann::json result;
+    result["name"] = program.name;
+    result["file"] = program.file;
+    result["seconds"] = elapsed.count();
+    if (!tests.has_value()) {
+        result["error"] = "P4Testgen failed to generate tests.";
+        return result;
+    }
+    steps = executorStats.steps - steps;
+    solverQueries = solverStats.checks - solverQueries;
+    solverCalls = solverStats.solverCalls - solverCalls;
+    result["tests"] = tests.value().size();
+    result["tests_per_second"] = perSecond(tests.value().size(), elapsed.count());
+    result["steps"] = steps;
+    result["steps_per_second"] = perSecond(steps, elapsed.count());
+    result["solver_queries"] = solverQueries;
+    result["solver_calls"] = solverCalls;
+    auto &timers = result["timers_ms"];
+    timers = nlohmann::json::object();
+    for (const auto &[name, milliseconds] : getTimerValues()) {
+        auto it = timersBefore.find(name);
+        timers[name] = milliseconds - (it == timersBefore.end() ? 0 : it->second);
+    }
+    size_t solverMilliseconds = 0;
+    for (const auto &[name, milliseconds] : timers.items()) {
+        if (isSolverTimer(name)) {
+            solverMilliseconds += milliseconds.get<size_t>();
+        }
+    }
+    result["solver_ms"] = solverMilliseconds;
+    // The peak is that of the whole process so far. Run a program alone with --program to
+    // measure its own peak.
+    if (auto peakRss = getPeakRss()) {
+        result["peak_rss_kb"] = peakRss.value();
+    }
+    return result;
+}
+
+/// The measurements compared with a baseline report. Larger is better for the rates.
+const std::vector<const char *> COMPARED_MEASUREMENTS = {"tests_per_second", "steps_per_second",
+                                                         "solver_ms", "peak_rss_kb"};
+
+/// Prints how the measurements in @param report changed relative to @param baseline.
+void compareWithBaseline(const nlohmann::json &report, const nlohmann::json &baseline) {
+    std::map<std::string, const nlohmann::json *> baselinePrograms;
+    for (const auto &program : baseline["programs"]) {
+        baselinePrograms[program["name"].get<std::string>()] = &program;
+    }
+    for (const auto &program : report["programs"]) {
+        auto name = program["name"].get<std::string>();
+        auto it = baselinePrograms.find(name);
+        if (it == baselinePrograms.end()) {
+            std::cerr << name << ": not in the baseline\n";
+            continue;
+        }
+        const auto &before = *it->second;
+        std::cerr << name << ":";
+        for (const auto *measurement : COMPARED_MEASUREMENTS) {
+            if (!program.contains(measurement) || !before.contains(measurement)) {
+                continue;
+            }
+            auto oldValue = before[measurement].get<double>();
+            auto newValue = program[measurement].get<double>();
+            std::cerr << " " << measurement << " " << oldValue << " -> " << newValue;
+            if (oldValue > 0) {
+                std::cerr << " (" << std::showpos << (newValue / oldValue - 1) * 100
+                          << std::noshowpos << "%)";
+            }
+        }
+        std::cerr << "\n";
+    }
+}
+
+/// Measures the throughput of P4Testgen on @ref CORPUS and writes the results as JSON. Compare the
+/// reports of two builds, or pass the report of the other build with --baseline, to catch
+/// throughput and memory regressions.
+/// Usage: testgen-bench [--p4c-root <dir>] [--output <file>] [--program <name>]
+///                      [--baseline <file>]
+int run(int argc, char **argv) {
+    // By default, the programs are taken from the source tree this benchmark was built from.
+    std::filesystem::path p4cRoot = P4C_SOURCE_DIR;
+    std::optional<std::filesystem::path> outputFile;
+    std::optional<std::string> programName;
+    std::optional<nlohmann::json> baseline;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--p4c-root" && i + 1 < argc) {
+            p4cRoot = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg == "--program" && i + 1 < argc) {
+            programName = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            std::ifstream baselineFile(argv[++i]);
+            if (baselineFile.is_open()) {
+                baseline = nlohmann::json::parse(baselineFile, nullptr, false);
+            }
+            if (!baseline.has_value() || baseline->is_discarded() ||
+                !baseline->contains("programs")) {
+                std::cerr << "Unable to read the baseline report " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--p4c-root <dir>] [--output <file>] [--program <name>]"
+                         " [--baseline <file>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    AutoCompileContext autoContext(new P4CContextWithOptions<CompilerOptions>());
+    nlohmann::json report;
+    report["seed"] = SEED;
+    auto &programs = report["programs"];
+    programs = nlohmann::json::array();
+    int result = EXIT_SUCCESS;
+    for (const auto &program : CORPUS) {
+        if (programName.has_value() && programName.value() != program.name) {
+            continue;
+        }
+        std::cerr << "Running " << program.name << "...\n";
+        programs.push_back(runProgram(p4cRoot, program));
+        if (programs.back().contains("error")) {
+            result = EXIT_FAILURE;
+        }
+    }
+    if (programs.empty()) {
+        std::cerr << "No program of the corpus is named " << programName.value() << "\n";
+        return EXIT_FAILURE;
+    }
+    if (auto peakRss = getPeakRss()) {
+        report["peak_rss_kb"] = peakRss.value();
+    }
+    if (baseline.has_value()) {
+        compareWithBaseline(report, baseline.value());
+    }
+
+    if (!outputFile.has_value()) {
+        std::cout << report.dump(4) << "\n";
+        return result;
+    }
+    std::ofstream file(outputFile.value());
+    if (!file.good()) {
+        std::cerr << "Unable to write " << outputFile.value() << "\n";
+        return EXIT_FAILURE;
+    }
+    file << report.dump(4) << "\n";
+    return result;
+}
+
+}  // namespace
+
+}  // namespace P4Tools::P4Testgen::Benchmark
+
+int main(int argc, char **argv) {
+    setup_signals();
+    return P4Tools::P4Testgen::Benchmark::run(argc, argv);
+}
@@ -1,15 +1,21 @@
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <iterator>
+#include <optional>
+#include <utility>
 #include <vector>
 
+#include "ir/node.h"
 #include "ir/solver.h"
 #include "lib/error.h"
 #include "lib/timer.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
 #include "backends/p4tools/modules/testgen/lib/exceptions.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -19,6 +25,84 @@ namespace P4Tools::P4Testgen {
 DepthFirstSearch::DepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo)
     : SymbolicExecutor(solver, programInfo) {}
 
+Checkpoint DepthFirstSearch::getCheckpoint() const {
+    const auto &testgenOptions = TestgenOptions::get();
+    Checkpoint checkpoint;
+    checkpoint.shardIndex = testgenOptions.shardIndex;
+    checkpoint.numShards = testgenOptions.numShards;
+    checkpoint.numCoverableNodes = coverableNodes.size();
+    size_t index = 0;
+    for (const auto *node : coverableNodes) {
+        if (visitedNodes.count(node) != 0) {
+            checkpoint.visitedNodes.push_back(index);
+        }
+        index++;
+    }
+    for (const auto &branch : unexploredBranches) {
+        checkpoint.unexploredBranches.push_back(branch.nextState.get().getSelectedBranches());
+    }
+    return checkpoint;
+}
+
+void DepthFirstSearch::resume(const Callback &callBack, const Checkpoint &checkpoint) {
+    const auto &testgenOptions = TestgenOptions::get();
+    if (checkpoint.shardIndex != testgenOptions.shardIndex ||
+        checkpoint.numShards != testgenOptions.numShards) {
+        ::error("The checkpoint was saved by shard %1%/%2%.", checkpoint.shardIndex,
+                checkpoint.numShards);
+        return;
+    }
+    if (checkpoint.numCoverableNodes != coverableNodes.size()) {
+        ::error("The checkpoint was saved for a program with %1% coverable nodes, not %2%.",
+                checkpoint.numCoverableNodes, coverableNodes.size());
+        return;
+    }
+    std::vector<const IR::Node *> nodes(coverableNodes.begin(), coverableNodes.end());
+    for (auto index : checkpoint.visitedNodes) {
+        visitedNodes.insert(nodes.at(index));
+    }
+    for (const auto &decisions : checkpoint.unexploredBranches) {
+        auto branch = replay(decisions);
+        if (!branch.has_value()) {
+            ::warning("Unable to replay an unexplored branch of the checkpoint. Skipping it.");
+            continue;
+        }
+        unexploredBranches.push_back(branch.value());
+    }
+    // The exploration is complete.
+    if (unexploredBranches.empty()) {
+        return;
+    }
+    auto executionState = unexploredBranches.back().nextState;
+    unexploredBranches.pop_back();
+    runImpl(callBack, executionState);
+}
+
+void DepthFirstSearch::setCheckpointHook(std::chrono::steady_clock::duration interval,
+                                         std::function<void(const Checkpoint &)> hook) {
+    checkpointInterval = interval;
+    checkpointHook = std::move(hook);
+    lastCheckpoint = std::chrono::steady_clock::now();
+}
+
+void DepthFirstSearch::checkpointIfDue(const ExecutionState &executionState) {
+    if (!checkpointHook) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    // A path without branch decisions can not be replayed. It is the first path of the
+    // exploration, so there is nothing to save yet.
+    const auto &decisions = executionState.getSelectedBranches();
+    if (now - lastCheckpoint < checkpointInterval || decisions.empty()) {
+        return;
+    }
+    auto checkpoint = getCheckpoint();
+    // The current path is explored first on resume, as it would have been now.
+    checkpoint.unexploredBranches.push_back(decisions);
+    checkpointHook(checkpoint);
+    lastCheckpoint = now;
+}
+
 std::optional<ExecutionStateReference> DepthFirstSearch::pickSuccessor(StepResult successors) {
     if (successors->empty()) {
         return std::nullopt;
@@ -26,20 +110,21 @@ std::optional<ExecutionStateReference> DepthFirstSearch::pickSuccessor(StepResul
 
     // If there is only one successor, choose it and move on.
     if (successors->size() == 1) {
-        return successors->at(0).nextState;
+        return takeBranch(successors->at(0));
     }
 
     // If there are multiple successors, try to pick one.
     // Pick a successor branch at random to preserve some non-determinism.
-    auto newState = popRandomBranch(*successors).nextState;
+    auto branch = popRandomBranch(*successors);
     // Add the remaining tests to the unexplored branches. Consume the remainder.
     unexploredBranches.insert(unexploredBranches.end(), make_move_iterator(successors->begin()),
                               make_move_iterator(successors->end()));
-    return newState;
+    return takeBranch(branch);
 }
 
 void DepthFirstSearch::runImpl(const Callback &callBack, ExecutionStateReference executionState) {
     while (true) {
+        checkpointIfDue(executionState);
         try {
             if (executionState.get().isTerminal()) {
                 // We've reached the end of the program. Call back and (if desired) end execution.
@@ -73,14 +158,18 @@ void DepthFirstSearch::runImpl(const Callback &callBack, ExecutionStateReference
         // Roll back to a previous branch and continue execution from there, but if there are no
         // more branches to explore, finish execution. Not all branches are viable, so we loop
         // until either we run out of unexplored branches or we find a viable branch.
-        if (unexploredBranches.empty()) {
-            return;
+        std::optional<ExecutionStateReference> nextState;
+        while (!nextState.has_value()) {
+            if (unexploredBranches.empty()) {
+                return;
+            }
+            // Select a new branch by iterating over all branches
+            Util::ScopedTimer chooseBranchtimer("branch_selection");
+            // Pick the top branch from the stack
+            nextState = takeBranch(unexploredBranches.back());
+            unexploredBranches.pop_back();
         }
-        // Select a new branch by iterating over all branches
-        Util::ScopedTimer chooseBranchtimer("branch_selection");
-        // Pick the top branch from the stack
-        executionState = unexploredBranches.back().nextState;
-        unexploredBranches.pop_back();
+        executionState = nextState.value();
     }
 }
 
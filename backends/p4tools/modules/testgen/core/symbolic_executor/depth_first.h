@@ -1,12 +1,15 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DEPTH_FIRST_H_
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DEPTH_FIRST_H_
 
+#include <chrono>
+#include <functional>
 #include <vector>
 
 #include "ir/solver.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
 
 namespace P4Tools::P4Testgen {
 
@@ -24,14 +27,40 @@ class DepthFirstSearch : public SymbolicExecutor {
     /// Constructor for this strategy, considering inheritance
     DepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo);
 
+    /// @returns the unexplored branches and the visited nodes of the exploration so far. The test
+    /// count is left to the caller.
+    [[nodiscard]] Checkpoint getCheckpoint() const;
+
+    /// Restores the visited nodes of @param checkpoint and continues the exploration with its
+    /// unexplored branches, which are replayed from the initial state.
+    void resume(const Callback &callBack, const Checkpoint &checkpoint);
+
+    /// Calls @param hook with a checkpoint of the exploration at most every @param interval, from
+    /// the exploration loop, so that checkpoints are also taken while no tests are found. The
+    /// path being explored is saved with the unexplored branches and is explored again on resume.
+    void setCheckpointHook(std::chrono::steady_clock::duration interval,
+                           std::function<void(const Checkpoint &)> hook);
+
  private:
+    /// Called periodically with a checkpoint, see setCheckpointHook.
+    std::function<void(const Checkpoint &)> checkpointHook;
+
+    /// The minimum time between two calls of the checkpoint hook.
+    std::chrono::steady_clock::duration checkpointInterval{};
+
+    /// When the checkpoint hook was last called.
+    std::chrono::steady_clock::time_point lastCheckpoint;
+
+    /// Calls the checkpoint hook if it is due, with @param executionState as the current path.
+    void checkpointIfDue(const ExecutionState &executionState);
+
     /// General unexplored branches.
     // Each element on this vector represents a set of alternative choices that could have been
     /// made along the current execution path.
     ///
     /// Invariants:
     ///   - Each element of this vector is non-empty.
-    ///   - Each element's path constraints are satisfiable.
+    ///   - Each element's path constraints are satisfiable, unless feasibility is checked lazily.
     ///   - There are no statements associated with the element's execution state that are
     ///   uncovered.
     std::vector<Branch> unexploredBranches;
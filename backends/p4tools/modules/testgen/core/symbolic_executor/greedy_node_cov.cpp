@@ -53,7 +53,7 @@ std::optional<ExecutionStateReference> GreedyNodeSelection::pickSuccessor(StepRe
     }
     // If there is only one successor, choose it and move on.
     if (successors->size() == 1) {
-        return successors->at(0).nextState;
+        return takeBranch(successors->at(0));
     }
 
     stepsWithoutTest++;
@@ -65,17 +65,16 @@ std::optional<ExecutionStateReference> GreedyNodeSelection::pickSuccessor(StepRe
         // If we succeed, pick the branch and add the remainder to the list of
         // potential branches.
         if (branch.has_value()) {
-            auto &nextState = branch.value().nextState;
             potentialBranches.insert(potentialBranches.end(), successors->begin(),
                                      successors->end());
-            return nextState;
+            return takeBranch(branch.value());
         }
     }
     // If we can not cover anything new, pick a branch at random.
-    auto nextState = popRandomBranch(*successors).nextState;
+    auto branch = popRandomBranch(*successors);
     // Add the remaining tests to the unexplored branches.
     unexploredBranches.insert(unexploredBranches.end(), successors->begin(), successors->end());
-    return nextState;
+    return takeBranch(branch);
 }
 
 void GreedyNodeSelection::runImpl(const Callback &callBack,
@@ -115,23 +114,27 @@ void GreedyNodeSelection::runImpl(const Callback &callBack,
         // Roll back to a previous branch and continue execution from there, but if there are no
         // more branches to explore, finish execution. Not all branches are viable, so we loop
         // until either we run out of unexplored branches or we find a viable branch.
-        if (potentialBranches.empty() && unexploredBranches.empty()) {
-            return;
-        }
-        // Select a new branch by iterating over all branches
-        Util::ScopedTimer chooseBranchtimer("branch_selection");
-        auto branch = popPotentialBranch(getVisitedNodes(), potentialBranches);
-        if (branch.has_value()) {
-            executionState = branch.value().nextState;
-            continue;
+        std::optional<ExecutionStateReference> nextState;
+        while (!nextState.has_value()) {
+            if (potentialBranches.empty() && unexploredBranches.empty()) {
+                return;
+            }
+            // Select a new branch by iterating over all branches
+            Util::ScopedTimer chooseBranchtimer("branch_selection");
+            auto branch = popPotentialBranch(getVisitedNodes(), potentialBranches);
+            if (branch.has_value()) {
+                nextState = takeBranch(branch.value());
+                continue;
+            }
+            // We did not find a single branch that could cover new state.
+            // Add all potential branches to the list of unexplored branches.
+            unexploredBranches.insert(unexploredBranches.end(), potentialBranches.begin(),
+                                      potentialBranches.end());
+            potentialBranches.clear();
+            // If we did not find any new nodes, fall back to random.
+            nextState = takeBranch(popRandomBranch(unexploredBranches));
         }
-        // We did not find a single branch that could cover new state.
-        // Add all potential branches to the list of unexplored branches.
-        unexploredBranches.insert(unexploredBranches.end(), potentialBranches.begin(),
-                                  potentialBranches.end());
-        potentialBranches.clear();
-        // If we did not find any new nodes, fall back to random.
-        executionState = popRandomBranch(unexploredBranches).nextState;
+        executionState = nextState.value();
     }
 }
 
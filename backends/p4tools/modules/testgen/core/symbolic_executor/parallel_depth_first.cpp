@@ -0,0 +1,313 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/util.h"
+#include "ir/solver.h"
+#include "lib/error.h"
+#include "lib/timer.h"
+#include "lib/worker_pool.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/small_step/small_step.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+
+namespace P4Tools::P4Testgen {
+
+struct ParallelDepthFirstSearch::Worker {
+    /// Z3 contexts must not be shared between threads, so every worker has its own solver.
+    Z3Solver solver;
+
+    /// The evaluator stepping through the program with @var solver.
+    SmallStepEvaluator evaluator;
+
+    /// Unexplored branches. The owner pops from the back, thieves take from the front.
+    std::deque<PendingBranch> branches;
+
+    /// Protects @var branches.
+    std::mutex lock;
+
+    explicit Worker(const ProgramInfo &programInfo) : evaluator(solver, programInfo) {}
+};
+
+ParallelDepthFirstSearch::ParallelDepthFirstSearch(AbstractSolver &solver,
+                                                   const ProgramInfo &programInfo, int numWorkers)
+    : SymbolicExecutor(solver, programInfo) {
+#ifndef MULTITHREAD
+    if (numWorkers > 1) {
+        ::warning("--num-workers requires a build with multithreading support. Using one worker.");
+        numWorkers = 1;
+    }
+#endif  // MULTITHREAD
+    // A few terminal states per worker keep the workers busy while the earliest path finishes.
+    maxFinishedPaths = 4 * std::max(numWorkers, 1);
+    auto seed = Utils::getCurrentSeed();
+    for (int index = 0; index < numWorkers; ++index) {
+        workers.push_back(std::make_unique<Worker>(programInfo));
+        // If there is no seed provided, do not randomize the solver.
+        if (seed != std::nullopt) {
+            workers.back()->solver.seed(*seed);
+        }
+    }
+}
+
+ParallelDepthFirstSearch::~ParallelDepthFirstSearch() = default;
+
+void ParallelDepthFirstSearch::runImpl(const Callback &callBack,
+                                       ExecutionStateReference executionState) {
+    done = false;
+    pendingBranches = 1;
+    livePaths = {PathKey()};
+    finishedPaths.clear();
+    workers.front()->branches.push_back({PathKey(), executionState});
+
+    // An exception of a worker stops the others and is rethrown here.
+    Util::WorkerPool::get().run(workers.size(), workers.size(), [this, &callBack](size_t index) {
+        // Give every worker its own, reproducible sequence of random choices.
+        Utils::seedWorker(index);
+        work(index, callBack);
+    });
+}
+
+void ParallelDepthFirstSearch::work(size_t index, const Callback &callBack) {
+    auto &worker = *workers[index];
+    try {
+        while (!done) {
+            size_t seen = 0;
+            {
+                std::lock_guard<std::mutex> acquire(idleLock);
+                seen = wakeups;
+            }
+            auto branch = nextBranch(index);
+            if (!branch.has_value()) {
+                // Other workers may still produce branches or finish the earliest path. Stop once
+                // nothing is left.
+                std::unique_lock<std::mutex> acquire(idleLock);
+                idle.wait(acquire, [this, seen]() {
+                    return done || pendingBranches == 0 || wakeups != seen;
+                });
+                if (pendingBranches == 0) {
+                    return;
+                }
+                continue;
+            }
+            explore(worker, callBack, std::move(branch.value()));
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+void ParallelDepthFirstSearch::stop() {
+    done = true;
+    wakeIdleWorkers();
+}
+
+void ParallelDepthFirstSearch::wakeIdleWorkers() {
+    {
+        std::lock_guard<std::mutex> acquire(idleLock);
+        wakeups++;
+    }
+    idle.notify_all();
+}
+
+std::optional<ParallelDepthFirstSearch::PendingBranch> ParallelDepthFirstSearch::nextBranch(
+    size_t index) {
+    {
+        // With a full buffer, only the earliest live path lets the buffered states be reported.
+        std::unique_lock<std::mutex> acquire(pathLock);
+        if (finishedPaths.size() >= maxFinishedPaths) {
+            if (livePaths.empty()) {
+                return std::nullopt;
+            }
+            auto earliest = *livePaths.begin();
+            acquire.unlock();
+            return takeBranch(earliest);
+        }
+    }
+    {
+        auto &own = *workers[index];
+        std::lock_guard<std::mutex> acquire(own.lock);
+        if (!own.branches.empty()) {
+            auto branch = std::move(own.branches.back());
+            own.branches.pop_back();
+            return branch;
+        }
+    }
+    for (size_t offset = 1; offset < workers.size(); ++offset) {
+        auto &victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> acquire(victim.lock);
+        if (!victim.branches.empty()) {
+            auto branch = std::move(victim.branches.front());
+            victim.branches.pop_front();
+            return branch;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<ParallelDepthFirstSearch::PendingBranch> ParallelDepthFirstSearch::takeBranch(
+    const PathKey &key) {
+    for (auto &worker : workers) {
+        std::lock_guard<std::mutex> acquire(worker->lock);
+        auto it = std::find_if(worker->branches.begin(), worker->branches.end(),
+                               [&key](const PendingBranch &branch) { return branch.key == key; });
+        if (it != worker->branches.end()) {
+            auto branch = std::move(*it);
+            worker->branches.erase(it);
+            return branch;
+        }
+    }
+    return std::nullopt;
+}
+
+void ParallelDepthFirstSearch::explore(Worker &worker, const Callback &callBack,
+                                       PendingBranch branch) {
+    auto key = std::move(branch.key);
+    auto executionState = branch.state;
+    while (!done) {
+        try {
+            if (executionState.get().isTerminal()) {
+                // We've reached the end of the program. Hand the state to the callback.
+                reportTerminalState(worker, callBack, key, executionState);
+                return;
+            }
+            StepResult successors = nullptr;
+            {
+                Util::ScopedTimer st("step");
+                successors = worker.evaluator.step(executionState);
+            }
+            statistics().steps++;
+            labelSuccessors(*successors);
+            // Remove any successors that are unsatisfiable.
+            successors->erase(std::remove_if(successors->begin(), successors->end(),
+                                             [&worker](const Branch &b) -> bool {
+                                                 return !evaluateBranch(b, worker.solver);
+                                             }),
+                              successors->end());
+            if (successors->empty()) {
+                break;
+            }
+            if (successors->size() == 1) {
+                executionState = successors->at(0).nextState;
+                continue;
+            }
+            // Pick a successor branch at random and queue the others for this or other workers.
+            // The newest branch is popped first, so push them in reverse order.
+            auto chosen = Utils::getRandInt(successors->size() - 1);
+            std::vector<PendingBranch> others;
+            for (size_t idx = successors->size(); idx-- > 0;) {
+                if (idx != chosen) {
+                    auto childKey = key;
+                    childKey.push_back(static_cast<uint32_t>(idx));
+                    others.push_back({std::move(childKey), successors->at(idx).nextState});
+                }
+            }
+            {
+                std::lock_guard<std::mutex> acquire(pathLock);
+                livePaths.erase(livePaths.find(key));
+                for (const auto &other : others) {
+                    livePaths.insert(other.key);
+                }
+                key.push_back(static_cast<uint32_t>(chosen));
+                livePaths.insert(key);
+            }
+            executionState = successors->at(chosen).nextState;
+            pendingBranches += others.size();
+            {
+                std::lock_guard<std::mutex> acquire(worker.lock);
+                for (auto &other : others) {
+                    worker.branches.push_back(std::move(other));
+                }
+            }
+            wakeIdleWorkers();
+        } catch (TestgenUnimplemented &e) {
+            // If strict is enabled, bubble the exception up.
+            if (TestgenOptions::get().strict) {
+                throw;
+            }
+            // Otherwise we abandon this path and continue with the next branch.
+            ::warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+            break;
+        }
+    }
+    finishPath(worker, callBack, key);
+}
+
+void ParallelDepthFirstSearch::reportTerminalState(Worker &worker, const Callback &callBack,
+                                                   const PathKey &key,
+                                                   const ExecutionState &terminalState) {
+    if (!isInShard(terminalState, true)) {
+        finishPath(worker, callBack, key);
+        return;
+    }
+    // Check the solver for satisfiability. If it times out or reports non-satisfiability, issue
+    // a warning and continue on a different path.
+    auto solverResult = worker.solver.checkSat(terminalState.getPathConstraint());
+    if (!solverResult) {
+        ::warning("Solver timed out");
+        finishPath(worker, callBack, key);
+        return;
+    }
+
+    if (!*solverResult) {
+        ::warning("Path constraints unsatisfiable");
+        finishPath(worker, callBack, key);
+        return;
+    }
+
+    // The model is computed in parallel, but tests are produced one at a time.
+    const FinalState finalState(worker.solver, terminalState);
+    finishPath(worker, callBack, key, &terminalState, &finalState.getFinalModel());
+}
+
+void ParallelDepthFirstSearch::finishPath(Worker &worker, const Callback &callBack,
+                                          const PathKey &key, const ExecutionState *terminalState,
+                                          const Model *model) {
+    {
+        std::lock_guard<std::mutex> acquire(pathLock);
+        livePaths.erase(livePaths.find(key));
+        if (terminalState != nullptr) {
+            finishedPaths.emplace(key, std::make_pair(terminalState, model));
+        }
+    }
+    reportFinishedPaths(worker, callBack);
+    --pendingBranches;
+    // The earliest live path may have changed and the buffer may have drained.
+    wakeIdleWorkers();
+}
+
+void ParallelDepthFirstSearch::reportFinishedPaths(Worker &worker, const Callback &callBack) {
+    std::lock_guard<std::mutex> reporting(callbackLock);
+    while (!done) {
+        std::pair<const ExecutionState *, const Model *> next;
+        {
+            // Paths before the first live path are complete, so their tests can be numbered.
+            std::lock_guard<std::mutex> acquire(pathLock);
+            if (finishedPaths.empty() ||
+                (!livePaths.empty() && !(finishedPaths.begin()->first < *livePaths.begin()))) {
+                return;
+            }
+            next = finishedPaths.begin()->second;
+            finishedPaths.erase(finishedPaths.begin());
+        }
+        // The solver is used for concolic resolution, so it has to be the one of the worker
+        // running on this thread.
+        if (callBack(FinalState(worker.solver, *next.first, *next.second))) {
+            stop();
+        }
+    }
+}
+
+}  // namespace P4Tools::P4Testgen
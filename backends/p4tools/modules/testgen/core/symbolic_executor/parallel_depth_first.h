@@ -0,0 +1,133 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "backends/p4tools/common/lib/model.h"
+
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+namespace P4Tools::P4Testgen {
+
+/// A depth-first traversal strategy which explores paths with several worker threads.
+/// Every worker owns a Z3 solver and a small-step evaluator and follows one path at a time, like
+/// @ref DepthFirstSearch. The alternatives of a branch point are pushed onto the worker's own
+/// queue, which the worker pops in LIFO order. Idle workers steal the oldest (shallowest) branch
+/// of another worker, which tends to hand them the largest unexplored subtree.
+/// Terminal states are passed to the callback one at a time, so test back ends and the set of
+/// visited nodes need no synchronization of their own. They are passed in the order of their
+/// position in the execution tree rather than in the order in which workers reach them, so
+/// tests are numbered the same way in every run with the same seed. Terminal states which wait
+/// for an earlier path are buffered; once the buffer is full, workers only pick up the earliest
+/// live path, so the buffer stays bounded and the callback is reached without delay.
+/// Workers run on the Util::WorkerPool; without MULTITHREAD support, they run one after the
+/// other on the calling thread.
+class ParallelDepthFirstSearch : public SymbolicExecutor {
+ public:
+    /// Executes the P4 program along randomly chosen paths on all workers. When the program
+    /// terminates, the given callback is invoked. If the callback returns true, then all workers
+    /// stop. Otherwise, execution continues until no unexplored branches are left.
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
+
+    /// Constructor for this strategy. @param numWorkers is the number of worker threads.
+    ParallelDepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo,
+                             int numWorkers);
+
+    ~ParallelDepthFirstSearch() override;
+
+ private:
+    /// The position of a path in the execution tree: the index of the successor taken at each
+    /// branch point.
+    using PathKey = std::vector<uint32_t>;
+
+    /// A branch which still has to be explored.
+    struct PendingBranch {
+        PathKey key;
+        ExecutionStateReference state;
+    };
+
+    /// The per-thread state of a worker: its solver, its evaluator, and its queue of unexplored
+    /// branches.
+    struct Worker;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /// The number of branches which are queued or currently being explored. Exploration is over
+    /// once this drops to zero.
+    std::atomic<size_t> pendingBranches = 0;
+
+    /// Set when the callback asks to terminate or a worker failed.
+    std::atomic<bool> done = false;
+
+    /// The number of terminal states which may wait in @var finishedPaths before workers stop
+    /// picking up branches other than the earliest live path.
+    size_t maxFinishedPaths;
+
+    /// Idle workers wait on @var idle until @var wakeups changes, that is, until a branch is
+    /// queued, a path finishes, or exploration ends.
+    std::mutex idleLock;
+    std::condition_variable idle;
+    size_t wakeups = 0;
+
+    /// Serializes the invocations of the callback.
+    std::mutex callbackLock;
+
+    /// Protects @var livePaths and @var finishedPaths.
+    std::mutex pathLock;
+
+    /// The keys of the branches which are queued or currently being explored.
+    std::multiset<PathKey> livePaths;
+
+    /// Terminal states and their models which wait for the paths before them to finish.
+    std::map<PathKey, std::pair<const ExecutionState *, const Model *>> finishedPaths;
+
+    /// The main loop of worker @param index.
+    void work(size_t index, const Callback &callBack);
+
+    /// Stop all workers and wake up those waiting for branches.
+    void stop();
+
+    /// Wake up the workers waiting for branches.
+    void wakeIdleWorkers();
+
+    /// Pop the newest branch of worker @param index or, if it has none, steal the oldest branch
+    /// of another worker. If @var finishedPaths is full, only the earliest live path is taken.
+    std::optional<PendingBranch> nextBranch(size_t index);
+
+    /// Take the queued branch @param key from any worker, if it is queued.
+    std::optional<PendingBranch> takeBranch(const PathKey &key);
+
+    /// Follow a single path starting at @param branch until it terminates or becomes
+    /// infeasible. Alternative branches are queued on @param worker.
+    void explore(Worker &worker, const Callback &callBack, PendingBranch branch);
+
+    /// Check the path constraints of @param terminalState with the solver of @param worker and
+    /// finish its path.
+    void reportTerminalState(Worker &worker, const Callback &callBack, const PathKey &key,
+                             const ExecutionState &terminalState);
+
+    /// Remove the path @param key from the live paths and record its terminal state and model,
+    /// if any. Then report the finished paths.
+    void finishPath(Worker &worker, const Callback &callBack, const PathKey &key,
+                    const ExecutionState *terminalState = nullptr, const Model *model = nullptr);
+
+    /// Hand the terminal states of all finished paths which precede every live path to the
+    /// callback, in the order of their keys, using the solver of @param worker.
+    void reportFinishedPaths(Worker &worker, const Callback &callBack);
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_ */
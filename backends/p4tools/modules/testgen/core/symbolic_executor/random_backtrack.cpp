@@ -1,6 +1,7 @@
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/random_backtrack.h"
 
 #include <functional>
+#include <optional>
 #include <vector>
 
 #include "ir/solver.h"
@@ -24,13 +25,13 @@ std::optional<ExecutionStateReference> RandomBacktrack::pickSuccessor(StepResult
     }
     // If there is only one successor, choose it and move on.
     if (successors->size() == 1) {
-        return successors->at(0).nextState;
+        return takeBranch(successors->at(0));
     }
     // Pick a branch at random.
-    auto nextState = popRandomBranch(*successors).nextState;
+    auto branch = popRandomBranch(*successors);
     // Add the remaining tests to the unexplored branches.
     unexploredBranches.insert(unexploredBranches.end(), successors->begin(), successors->end());
-    return nextState;
+    return takeBranch(branch);
 }
 
 void RandomBacktrack::runImpl(const Callback &callBack, ExecutionStateReference executionState) {
@@ -68,13 +69,17 @@ void RandomBacktrack::runImpl(const Callback &callBack, ExecutionStateReference
         // Roll back to a previous branch and continue execution from there, but if there are no
         // more branches to explore, finish execution. Not all branches are viable, so we loop
         // until either we run out of unexplored branches or we find a viable branch.
-        if (unexploredBranches.empty()) {
-            return;
+        std::optional<ExecutionStateReference> nextState;
+        while (!nextState.has_value()) {
+            if (unexploredBranches.empty()) {
+                return;
+            }
+            // Select a new branch by iterating over all branches
+            Util::ScopedTimer chooseBranchtimer("branch_selection");
+            // Pick a state at random.
+            nextState = takeBranch(popRandomBranch(unexploredBranches));
         }
-        // Select a new branch by iterating over all branches
-        Util::ScopedTimer chooseBranchtimer("branch_selection");
-        // Pick a state at random.
-        executionState = popRandomBranch(unexploredBranches).nextState;
+        executionState = nextState.value();
     }
 }
 
@@ -1,16 +1,19 @@
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <fstream>
 #include <iterator>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "ir/ir.h"
 #include "ir/solver.h"
 #include "lib/error.h"
+#include "lib/hash.h"
 #include "lib/timer.h"
 #include "midend/coverage.h"
 
@@ -19,6 +22,7 @@
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 #include "backends/p4tools/modules/testgen/lib/logging.h"
+#include "backends/p4tools/modules/testgen/options.h"
 
 namespace P4Tools::P4Testgen {
 
@@ -29,20 +33,113 @@ SymbolicExecutor::StepResult SymbolicExecutor::step(ExecutionState &state) {
         Util::ScopedTimer st("step");
         successors = evaluator.step(state);
     }
+    statistics().steps++;
+    labelSuccessors(*successors);
+    if (TestgenOptions::get().lazyFeasibility) {
+        // Only remove successors which are trivially unsatisfiable. The others are checked once
+        // they are taken.
+        auto isFalse = [](const Branch &b) -> bool {
+            const auto *boolLiteral = b.constraint->to<IR::BoolLiteral>();
+            return boolLiteral != nullptr && !boolLiteral->value;
+        };
+        successors->erase(std::remove_if(successors->begin(), successors->end(), isFalse),
+                          successors->end());
+        return successors;
+    }
     // Remove any successors that are unsatisfiable.
-    successors->erase(
-        std::remove_if(successors->begin(), successors->end(),
-                       [this](const Branch &b) -> bool { return !evaluateBranch(b, solver); }),
-        successors->end());
+    auto feasible = evaluateBranches(*successors, solver);
+    size_t kept = 0;
+    for (size_t idx = 0; idx < successors->size(); ++idx) {
+        if (feasible[idx]) {
+            (*successors)[kept++] = (*successors)[idx];
+        }
+    }
+    successors->erase(successors->begin() + static_cast<std::ptrdiff_t>(kept), successors->end());
     return successors;
 }
 
+std::optional<ExecutionStateReference> SymbolicExecutor::takeBranch(const Branch &branch) {
+    if (TestgenOptions::get().lazyFeasibility && !evaluateBranch(branch, solver)) {
+        return std::nullopt;
+    }
+    return branch.nextState;
+}
+
 void SymbolicExecutor::run(const Callback &callBack) {
     runImpl(callBack, ExecutionState::create(&programInfo.getP4Program()));
 }
 
+void SymbolicExecutor::labelSuccessors(std::vector<Branch> &successors) {
+    const auto &testgenOptions = TestgenOptions::get();
+    if (successors.size() < 2 ||
+        (testgenOptions.numShards == 1 && !testgenOptions.checkpointFile.has_value())) {
+        return;
+    }
+    for (uint64_t bIdx = 0; bIdx < successors.size(); ++bIdx) {
+        successors[bIdx].nextState.get().pushBranchDecision(bIdx + 1);
+    }
+    successors.erase(std::remove_if(successors.begin(), successors.end(),
+                                    [](const Branch &b) -> bool {
+                                        return !isInShard(b.nextState, false);
+                                    }),
+                     successors.end());
+}
+
+size_t SymbolicExecutor::getShardPrefixLength(int numShards) {
+    // With mostly binary branch points, this yields about eight subtrees per shard.
+    size_t length = 3;
+    for (int subtrees = 1; subtrees < numShards; subtrees *= 2) {
+        length++;
+    }
+    return length;
+}
+
+bool SymbolicExecutor::isInShard(const ExecutionState &state, bool isTerminal) {
+    const auto &testgenOptions = TestgenOptions::get();
+    if (testgenOptions.numShards == 1) {
+        return true;
+    }
+    const auto &decisions = state.getSelectedBranches();
+    auto prefixLength = getShardPrefixLength(testgenOptions.numShards);
+    // Longer paths were assigned when their prefix was taken. Shorter paths may still branch
+    // into different shards, unless they end here.
+    if (decisions.size() > prefixLength || (decisions.size() < prefixLength && !isTerminal)) {
+        return true;
+    }
+    auto hash = Util::hash(decisions.data(), decisions.size() * sizeof(uint64_t));
+    return hash % testgenOptions.numShards == static_cast<uint64_t>(testgenOptions.shardIndex);
+}
+
+std::optional<SymbolicExecutor::Branch> SymbolicExecutor::replay(
+    const std::vector<uint64_t> &decisions) {
+    std::optional<Branch> branch;
+    ExecutionStateReference executionState = ExecutionState::create(&programInfo.getP4Program());
+    while (executionState.get().getSelectedBranches().size() < decisions.size()) {
+        if (executionState.get().isTerminal()) {
+            return std::nullopt;
+        }
+        StepResult successors = step(executionState);
+        // Only branch points add a decision, so the decisions of the matching successor are a
+        // prefix of @p decisions.
+        auto matches = [&decisions](const Branch &b) {
+            const auto &taken = b.nextState.get().getSelectedBranches();
+            return std::equal(taken.begin(), taken.end(), decisions.begin());
+        };
+        auto it = std::find_if(successors->begin(), successors->end(), matches);
+        if (it == successors->end()) {
+            return std::nullopt;
+        }
+        branch.emplace(*it);
+        executionState = it->nextState;
+    }
+    return branch;
+}
+
 bool SymbolicExecutor::handleTerminalState(const Callback &callback,
                                            const ExecutionState &terminalState) {
+    if (!isInShard(terminalState, true)) {
+        return false;
+    }
     // Check the solver for satisfiability. If it times out or reports non-satisfiability, issue
     // a warning and continue on a different path.
     auto solverResult = solver.checkSat(terminalState.getPathConstraint());
@@ -79,6 +176,40 @@ bool SymbolicExecutor::evaluateBranch(const SymbolicExecutor::Branch &branch,
     return solverResult.value_or(false);
 }
 
+std::vector<bool> SymbolicExecutor::evaluateBranches(const std::vector<Branch> &branches,
+                                                     AbstractSolver &solver) {
+    std::vector<bool> feasible(branches.size(), false);
+    auto *z3Solver = solver.to<Z3Solver>();
+    if (z3Solver == nullptr) {
+        for (size_t idx = 0; idx < branches.size(); ++idx) {
+            feasible[idx] = evaluateBranch(branches[idx], solver);
+        }
+        return feasible;
+    }
+    std::vector<size_t> pending;
+    std::vector<std::vector<const Constraint *>> queries;
+    for (size_t idx = 0; idx < branches.size(); ++idx) {
+        // Do not bother invoking the solver for a trivial case.
+        if (const auto *boolLiteral = branches[idx].constraint->to<IR::BoolLiteral>()) {
+            feasible[idx] = boolLiteral->value;
+            continue;
+        }
+        pending.push_back(idx);
+        queries.push_back(branches[idx].nextState.get().getPathConstraint());
+    }
+    if (queries.empty()) {
+        return feasible;
+    }
+    auto results = z3Solver->checkSatAlternatives(queries);
+    for (size_t idx = 0; idx < pending.size(); ++idx) {
+        if (results[idx] == std::nullopt) {
+            ::warning("Solver timed out");
+        }
+        feasible[pending[idx]] = results[idx].value_or(false);
+    }
+    return feasible;
+}
+
 SymbolicExecutor::Branch SymbolicExecutor::popRandomBranch(
     std::vector<SymbolicExecutor::Branch> &candidateBranches) {
     auto branchIdx = Utils::getRandInt(candidateBranches.size() - 1);
@@ -100,7 +231,7 @@ SymbolicExecutor::SymbolicExecutor(AbstractSolver &solver, const ProgramInfo &pr
     }
 }
 
-bool SymbolicExecutor::updateVisitedNodes(const P4::Coverage::CoverageSet &newNodes) {
+bool SymbolicExecutor::updateVisitedNodes(const VisitedNodes &newNodes) {
     auto hasUpdated = false;
     for (auto newNode : newNodes) {
         hasUpdated |= visitedNodes.insert(newNode).second;
@@ -110,6 +241,11 @@ bool SymbolicExecutor::updateVisitedNodes(const P4::Coverage::CoverageSet &newNo
 
 const P4::Coverage::CoverageSet &SymbolicExecutor::getVisitedNodes() { return visitedNodes; }
 
+SymbolicExecutor::Statistics &SymbolicExecutor::statistics() {
+    static Statistics STATISTICS;
+    return STATISTICS;
+}
+
 void SymbolicExecutor::printCurrentTraceAndBranches(std::ostream &out,
                                                     const ExecutionState &executionState) {
     const auto &branchesList = executionState.getSelectedBranches();
@@ -1,8 +1,12 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_SYMBOLIC_EXECUTOR_H_
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_SYMBOLIC_EXECUTOR_H_
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
+#include <optional>
 #include <vector>
 
 #include "ir/solver.h"
@@ -39,6 +43,15 @@ class SymbolicExecutor {
 
     using StepResult = SmallStepEvaluator::Result;
 
+    /// Counters shared by all executors.
+    struct Statistics {
+        /// Steps taken through the program.
+        std::atomic<uint64_t> steps = 0;
+    };
+
+    /// @returns the global executor statistics.
+    static Statistics &statistics();
+
     /// Executes the P4 program along a randomly chosen path. When the program terminates, the
     /// given callback is invoked. If the callback returns true, then the executor terminates.
     /// Otherwise, execution of the P4 program continues on a different random path.
@@ -55,7 +68,7 @@ class SymbolicExecutor {
     const P4::Coverage::CoverageSet &getVisitedNodes();
 
     /// Update the set of visited nodes. Returns true if there was an update.
-    [[nodiscard]] bool updateVisitedNodes(const P4::Coverage::CoverageSet &newNodes);
+    [[nodiscard]] bool updateVisitedNodes(const VisitedNodes &newNodes);
 
  protected:
     /// Target-specific information about the P4 program.
@@ -76,14 +89,45 @@ class SymbolicExecutor {
     /// on a different path.
     bool handleTerminalState(const Callback &callback, const ExecutionState &terminalState);
 
-    /// Take one step in the program and return list of possible branches.
+    /// Take one step in the program and return list of possible branches. Unless lazy
+    /// feasibility checks are enabled, successors with unsatisfiable path constraints are removed.
     StepResult step(ExecutionState &state);
 
+    /// @returns the state of @param branch, which is about to be explored. With lazy feasibility
+    /// checks, the path constraints of @param branch are checked here and std::nullopt is
+    /// returned if they are unsatisfiable.
+    std::optional<ExecutionStateReference> takeBranch(const Branch &branch);
+
     /// Take a branch and a solver as input.
     /// Compute the branch's path conditions using the solver.
     /// Return true if the solver can find a solution and does not time out.
     static bool evaluateBranch(const SymbolicExecutor::Branch &branch, AbstractSolver &solver);
 
+    /// Like @ref evaluateBranch, but checks the sibling @param branches together. A Z3 solver
+    /// asserts the common prefix of their path constraints only once.
+    /// @returns whether each branch is satisfiable.
+    static std::vector<bool> evaluateBranches(const std::vector<Branch> &branches,
+                                              AbstractSolver &solver);
+
+    /// If sharding or checkpoints are enabled, labels each of @param successors of a branch
+    /// point with a branch decision, which identifies its path for @ref isInShard and
+    /// @ref replay, and removes the successors which belong to a different shard.
+    static void labelSuccessors(std::vector<Branch> &successors);
+
+    /// Paths are assigned to shards by their first @returns branch decisions. Every shard
+    /// explores the paths up to that depth.
+    static size_t getShardPrefixLength(int numShards);
+
+    /// @returns whether the path leading to @param state belongs to the shard explored by this
+    /// run. Paths which terminate before @ref getShardPrefixLength decisions are assigned to a
+    /// shard once they reach @param isTerminal.
+    static bool isInShard(const ExecutionState &state, bool isTerminal);
+
+    /// Steps from the initial state along the branch decisions @param decisions.
+    /// @returns the branch reached by the last decision or std::nullopt if the decisions do not
+    /// describe a feasible path.
+    std::optional<Branch> replay(const std::vector<uint64_t> &decisions);
+
     /// Select a branch at random from the input @param candidateBranches.
     //  Remove the branch from the container.
     static SymbolicExecutor::Branch popRandomBranch(
@@ -0,0 +1,63 @@
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+
+#include <exception>
+#include <fstream>
+#include <string>
+
+#include "lib/error.h"
+#include "nlohmann/json.hpp"
+
+namespace P4Tools::P4Testgen {
+
+void Checkpoint::save(const std::filesystem::path &path) const {
+    nlohmann::json checkpoint;
+    checkpoint["test_count"] = testCount;
+    checkpoint["shard_index"] = shardIndex;
+    checkpoint["num_shards"] = numShards;
+    checkpoint["num_coverable_nodes"] = numCoverableNodes;
+    checkpoint["visited_nodes"] = visitedNodes;
+    checkpoint["unexplored_branches"] = unexploredBranches;
+    auto &sizes = checkpoint["test_file_sizes"];
+    sizes = nlohmann::json::object();
+    for (const auto &[testFile, size] : testFileSizes) {
+        sizes[testFile.string()] = size;
+    }
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath);
+        if (!file.good()) {
+            ::error("Unable to write checkpoint %1%.", tmpPath.c_str());
+            return;
+        }
+        file << checkpoint;
+    }
+    std::filesystem::rename(tmpPath, path);
+}
+
+std::optional<Checkpoint> Checkpoint::load(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    if (!file.good()) {
+        return std::nullopt;
+    }
+    Checkpoint result;
+    try {
+        auto checkpoint = nlohmann::json::parse(file);
+        checkpoint.at("test_count").get_to(result.testCount);
+        checkpoint.at("shard_index").get_to(result.shardIndex);
+        checkpoint.at("num_shards").get_to(result.numShards);
+        checkpoint.at("num_coverable_nodes").get_to(result.numCoverableNodes);
+        checkpoint.at("visited_nodes").get_to(result.visitedNodes);
+        checkpoint.at("unexplored_branches").get_to(result.unexploredBranches);
+        for (const auto &[testFile, size] : checkpoint.at("test_file_sizes").items()) {
+            result.testFileSizes.emplace(testFile, size.get<uintmax_t>());
+        }
+    } catch (const std::exception &e) {
+        ::error("Malformed checkpoint %1%: %2%", path.c_str(), e.what());
+        return std::nullopt;
+    }
+    return result;
+}
+
+}  // namespace P4Tools::P4Testgen
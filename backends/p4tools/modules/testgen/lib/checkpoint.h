@@ -0,0 +1,50 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace P4Tools::P4Testgen {
+
+/// The progress of an exploration of the branch tree, which can be saved to a file to resume the
+/// exploration in a later run. Execution states can not be serialized, so unexplored branches are
+/// recorded as the branch decisions leading to them and are replayed on resumption.
+struct Checkpoint {
+    /// The number of tests generated so far.
+    int64_t testCount = 0;
+
+    /// The shard of the branch tree that was explored.
+    int shardIndex = 0;
+
+    /// The number of shards the branch tree is partitioned into.
+    int numShards = 1;
+
+    /// The number of coverable nodes of the program.
+    size_t numCoverableNodes = 0;
+
+    /// The visited nodes, as positions in the ordered set of coverable nodes.
+    std::vector<size_t> visitedNodes;
+
+    /// The branch decisions leading to each unexplored branch.
+    std::vector<std::vector<uint64_t>> unexploredBranches;
+
+    /// The size of every test file that tests are appended to. Tests which a killed run appended
+    /// after the checkpoint are cut off on resumption, because they are generated again.
+    std::map<std::filesystem::path, uintmax_t> testFileSizes;
+
+    /// Writes the checkpoint to @param path. The file is replaced atomically, so a run which is
+    /// killed while saving leaves the previous checkpoint intact.
+    void save(const std::filesystem::path &path) const;
+
+    /// @returns the checkpoint stored in @param path, or std::nullopt if there is no such file.
+    /// Reports an error if the file is malformed.
+    static std::optional<Checkpoint> load(const std::filesystem::path &path);
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_ */
@@ -111,8 +111,8 @@ const std::vector<uint64_t> &ExecutionState::getSelectedBranches() const {
     return selectedBranches;
 }
 
-const std::vector<const IR::Expression *> &ExecutionState::getPathConstraint() const {
-    return pathConstraint;
+std::vector<const IR::Expression *> ExecutionState::getPathConstraint() const {
+    return pathConstraint.toVector();
 }
 
 std::optional<const Continuation::Command> ExecutionState::getNextCmd() const {
@@ -174,10 +174,10 @@ void ExecutionState::markVisited(const IR::Node *node) {
     if (node->is<IR::P4Action>() && !coverageOptions.coverActions) {
         return;
     }
-    visitedNodes.emplace(node);
+    visitedNodes.insert(node);
 }
 
-const P4::Coverage::CoverageSet &ExecutionState::getVisited() const { return visitedNodes; }
+const VisitedNodes &ExecutionState::getVisited() const { return visitedNodes; }
 
 /// Compare types, considering Extracted_Varbit and bits equal if the (real/extracted) sizes are
 /// equal. This is because the packet expression can be something like 0 ++
@@ -214,7 +214,8 @@ void ExecutionState::set(const IR::StateVariable &var, const IR::Expression *val
     env.set(var, value);
 }
 
-const std::vector<std::reference_wrapper<const TraceEvent>> &ExecutionState::getTrace() const {
+const PersistentVector<std::reference_wrapper<const TraceEvent>> &ExecutionState::getTrace()
+    const {
     return trace;
 }
 
@@ -281,7 +282,7 @@ ReachabilityEngineState *ExecutionState::getReachabilityEngineState() const {
  *  Trace events.
  * ============================================================================================= */
 
-void ExecutionState::add(const TraceEvent &event) { trace.emplace_back(event); }
+void ExecutionState::add(const TraceEvent &event) { trace.push_back(event); }
 
 void ExecutionState::popBody() { body.pop(); }
 
@@ -14,6 +14,7 @@
 
 #include "backends/p4tools/common/compiler/reachability.h"
 #include "backends/p4tools/common/core/abstract_execution_state.h"
+#include "backends/p4tools/common/lib/persistent_map.h"
 #include "backends/p4tools/common/lib/namespace_context.h"
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/trace_event.h"
@@ -31,6 +32,9 @@
 namespace P4Tools::P4Testgen {
 
 /// Represents state of execution after having reached a program point.
+/// The nodes visited by an execution state, shared between the state and its clones.
+using VisitedNodes = PersistentSet<const IR::Node *, P4::Coverage::SourceIdCmp>;
+
 class ExecutionState : public AbstractExecutionState {
     friend class Test::SmallStepTest;
 
@@ -73,10 +77,10 @@ class ExecutionState : public AbstractExecutionState {
 
  private:
     /// The program trace for the current program point (i.e., how we got to the current state).
-    std::vector<std::reference_wrapper<const TraceEvent>> trace;
+    PersistentVector<std::reference_wrapper<const TraceEvent>> trace;
 
     /// Set of visited nodes. Used for code coverage.
-    P4::Coverage::CoverageSet visitedNodes;
+    VisitedNodes visitedNodes;
 
     /// The remaining body of the current function being executed.
     ///
@@ -120,7 +124,7 @@ class ExecutionState : public AbstractExecutionState {
 
     /// List of path constraints - expressions that must all evaluate to true to reach this
     /// execution state.
-    std::vector<const IR::Expression *> pathConstraint;
+    PersistentVector<const IR::Expression *> pathConstraint;
 
     /// List of branch decisions leading into this state.
     std::vector<uint64_t> selectedBranches;
@@ -145,8 +149,8 @@ class ExecutionState : public AbstractExecutionState {
     /// Determines whether this state represents the end of an execution.
     [[nodiscard]] bool isTerminal() const;
 
-    /// @returns list of paths constraints.
-    [[nodiscard]] const std::vector<const IR::Expression *> &getPathConstraint() const;
+    /// @returns list of paths constraints, copied out of the persistent list of this state.
+    [[nodiscard]] std::vector<const IR::Expression *> getPathConstraint() const;
 
     /// @returns list of branch decisions leading into this state.
     [[nodiscard]] const std::vector<uint64_t> &getSelectedBranches() const;
@@ -170,14 +174,15 @@ class ExecutionState : public AbstractExecutionState {
     void markVisited(const IR::Node *node);
 
     /// @returns list of all nodes visited before reaching this state.
-    [[nodiscard]] const P4::Coverage::CoverageSet &getVisited() const;
+    [[nodiscard]] const VisitedNodes &getVisited() const;
 
     /// Sets the symbolic value of the given state variable to the given value. Constant folding
     /// is done on the given value before updating the symbolic state.
     void set(const IR::StateVariable &var, const IR::Expression *value) override;
 
     /// @returns the current event trace.
-    [[nodiscard]] const std::vector<std::reference_wrapper<const TraceEvent>> &getTrace() const;
+    [[nodiscard]] const PersistentVector<std::reference_wrapper<const TraceEvent>> &getTrace()
+        const;
 
     /// @returns the current body.
     [[nodiscard]] const Continuation::Body &getBody() const;
@@ -387,6 +392,9 @@ class ExecutionState : public AbstractExecutionState {
      * ========================================================================================= */
     /// Allocate a new execution state object with the same state as this object.
     /// Returns a reference, not a pointer.
+    /// The symbolic environment, the trace, the path constraint and the visited nodes are
+    /// persistent and shared with the clone, so that cloning does not copy them. The test objects
+    /// and the other containers are small and copied.
     [[nodiscard]] ExecutionState &clone() const override;
 
     /// Create a new execution state object from the input program.
@@ -17,6 +17,7 @@
 #include "ir/solver.h"
 #include "lib/error.h"
 #include "lib/null.h"
+#include "lib/timer.h"
 
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/lib/packet_vars.h"
@@ -65,6 +66,32 @@ Model &FinalState::processModel(const ExecutionState &finalState, Model &model,
     return model;
 }
 
+Model *FinalState::reuseModel(const ConcolicVariableMap &resolvedConcolicVariables,
+                              const std::vector<const Constraint *> &asserts) const {
+    Util::ScopedTimer timer("concolic_model_reuse");
+    auto *model = new Model(finalModel.get());
+    for (const auto &[concolicVariable, concolicAssignment] : resolvedConcolicVariables) {
+        // Assignments to expressions are only checked through their constraints.
+        if (!std::holds_alternative<IR::ConcolicVariable>(concolicVariable)) {
+            continue;
+        }
+        if (!concolicAssignment->is<IR::Literal>()) {
+            return nullptr;
+        }
+        model->set(std::get<IR::ConcolicVariable>(concolicVariable).clone(), concolicAssignment);
+    }
+    // Variables missing from the model are completed with the same values later on. A constraint
+    // which does not evaluate to a literal under the model is left to the solver.
+    for (const auto *assert : asserts) {
+        const auto *literal = model->tryEvaluate(assert, true);
+        const auto *result = literal == nullptr ? nullptr : literal->to<IR::BoolLiteral>();
+        if (result == nullptr || !result->value) {
+            return nullptr;
+        }
+    }
+    return model;
+}
+
 std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConcolicState(
     const ConcolicVariableMap &resolvedConcolicVariables) const {
     // If there are no new concolic variables, there is nothing to do.
@@ -90,6 +117,9 @@ std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConco
         pathConstraint = P4::optimizeExpression(pathConstraint);
         asserts.push_back(pathConstraint);
     }
+    if (auto *model = reuseModel(resolvedConcolicVariables, asserts)) {
+        return *new FinalState(solver, state, *model);
+    }
     auto solverResult = solver.get().checkSat(asserts);
     if (!solverResult) {
         ::warning("Timed out trying to solve this concolic execution path.");
@@ -117,5 +147,5 @@ const std::vector<std::reference_wrapper<const TraceEvent>> *FinalState::getTrac
     return &trace;
 }
 
-const P4::Coverage::CoverageSet &FinalState::getVisited() const { return state.get().getVisited(); }
+const VisitedNodes &FinalState::getVisited() const { return state.get().getVisited(); }
 }  // namespace P4Tools::P4Testgen
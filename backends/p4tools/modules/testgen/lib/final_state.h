@@ -42,6 +42,13 @@ class FinalState {
     static Model &processModel(const ExecutionState &finalState, Model &model,
                                bool postProcess = true);
 
+    /// Tries to use the model of this state as a hint for concolic resolution. Concolic
+    /// assignments are computed from this model, so they are often consistent with it.
+    /// @returns the model of this state, updated with @param resolvedConcolicVariables, if it
+    /// satisfies @param asserts, or nullptr if the solver needs to be invoked.
+    [[nodiscard]] Model *reuseModel(const ConcolicVariableMap &resolvedConcolicVariables,
+                                    const std::vector<const Constraint *> &asserts) const;
+
  public:
     /// This constructor invokes @ref processModel() to produce the model based on the solver
     /// and the executionState.
@@ -51,7 +58,8 @@ class FinalState {
     FinalState(AbstractSolver &solver, const ExecutionState &finalState, const Model &finalModel);
 
     /// If there are concolic variables in the program, compute a new final state by rerunning the
-    /// solver on the concolic assignments. If the concolic assignment is not satisfiable, return
+    /// solver on the concolic assignments. The solver is skipped if the current model already
+    /// satisfies the concolic assignments. If the concolic assignment is not satisfiable, return
     /// std::nullopt. Otherwise, create a new final state with the new assignment. IMPORTANT: Some
     /// variables in this final state may have been added in post, e.g., the payload size. If the
     /// concolic variables do not recompute these variables, the model will simply copy these
@@ -72,7 +80,7 @@ class FinalState {
     [[nodiscard]] const std::vector<std::reference_wrapper<const TraceEvent>> *getTraces() const;
 
     /// @returns the list of visited nodes of this state.
-    [[nodiscard]] const P4::Coverage::CoverageSet &getVisited() const;
+    [[nodiscard]] const VisitedNodes &getVisited() const;
 };
 
 }  // namespace P4Tools::P4Testgen
@@ -154,7 +154,9 @@ bool TestBackEnd::run(const FinalState &state) {
             printFeature("test_info", 4,
                          "============ Test %1%: Nodes covered: %2% (%3%/%4%) ============",
                          testCount, coverage, visitedNodes.size(), coverableNodes.size());
-            P4::Coverage::logCoverage(coverableNodes, visitedNodes, executionState->getVisited());
+            const auto &newNodes = executionState->getVisited();
+            P4::Coverage::logCoverage(coverableNodes, visitedNodes,
+                                      P4::Coverage::CoverageSet(newNodes.begin(), newNodes.end()));
         }
 
         // Output the test.
@@ -273,6 +275,18 @@ bool TestBackEnd::printTestInfo(const ExecutionState * /*executionState*/, const
 
 int64_t TestBackEnd::getTestCount() const { return testCount; }
 
+void TestBackEnd::flushTests() { testWriter->flushTests(); }
+
+std::map<std::filesystem::path, uintmax_t> TestBackEnd::getTestFileSizes() const {
+    return testWriter->getTestFileSizes();
+}
+
+void TestBackEnd::resumeTests(int64_t testCount,
+                              const std::map<std::filesystem::path, uintmax_t> &testFileSizes) {
+    this->testCount = testCount;
+    testWriter->continueTestFiles(testFileSizes);
+}
+
 float TestBackEnd::getCoverage() const { return coverage; }
 
 const ProgramInfo &TestBackEnd::getProgramInfo() const { return programInfo; }
@@ -2,7 +2,9 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_BACKEND_H_
 
 #include <cstdint>
+#include <filesystem>
 #include <functional>
+#include <map>
 #include <optional>
 #include <vector>
 
@@ -119,6 +121,19 @@ class TestBackEnd {
     /// Returns test count.
     [[nodiscard]] int64_t getTestCount() const;
 
+    /// Waits until all generated tests are written to disk.
+    void flushTests();
+
+    /// @returns the size of every file that tests have been appended to. Call @ref flushTests
+    /// first.
+    [[nodiscard]] std::map<std::filesystem::path, uintmax_t> getTestFileSizes() const;
+
+    /// Continues the tests of an earlier run, which produced @param testCount tests and left
+    /// its shared test files at @param testFileSizes. Later tests are numbered after the earlier
+    /// ones and appended to these files.
+    void resumeTests(int64_t testCount,
+                     const std::map<std::filesystem::path, uintmax_t> &testFileSizes);
+
     /// Returns coverage achieved by all the processed tests.
     [[nodiscard]] float getCoverage() const;
 
@@ -26,6 +26,15 @@ struct TestBackendConfiguration {
 
     /// The initial seed used to generate tests. If it is not set, no seed was used.
     std::optional<unsigned int> seed;
+
+    /// Render and write tests on a background thread.
+    bool asyncTestWriter = false;
+
+    /// Compress the test files with gzip.
+    bool compressTests = false;
+
+    /// The number of files that back ends which put all tests into one file spread them over.
+    int numTestFiles = 1;
 };
 
 }  // namespace P4Tools::P4Testgen
@@ -0,0 +1,242 @@
+#include "backends/p4tools/modules/testgen/lib/test_file_writer.h"
+
+#include <ios>
+#include <system_error>
+#include <utility>
+
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+#include "lib/error.h"
+#include "lib/gc.h"
+
+namespace P4Tools::P4Testgen {
+
+TestFileWriter::TestFileWriter(bool async, bool compress) : compress(compress) {
+#ifdef MULTITHREAD
+    this->async = async;
+    if (async) {
+        thread = std::thread([this]() {
+            gc_register_thread();
+            work();
+            gc_unregister_thread();
+        });
+    }
+#else
+    if (async) {
+        ::warning(
+            "Writing tests asynchronously requires a build with multithreading support. Writing "
+            "them synchronously.");
+    }
+#endif  // MULTITHREAD
+}
+
+TestFileWriter::~TestFileWriter() {
+#ifdef MULTITHREAD
+    if (async) {
+        {
+            std::lock_guard<std::mutex> acquire(lock);
+            stopping = true;
+        }
+        queueChanged.notify_all();
+        thread.join();
+    }
+#endif  // MULTITHREAD
+    reportOpenFailures();
+    closeFiles();
+}
+
+void TestFileWriter::writeFile(std::filesystem::path path, std::string testTemplate,
+                               inja::json data) {
+    submit({std::move(path), std::move(testTemplate), std::move(data), false, false});
+}
+
+void TestFileWriter::appendFile(std::filesystem::path path, std::string testTemplate,
+                                inja::json data) {
+    bool continued = !startedFiles.insert(path).second;
+    submit({std::move(path), std::move(testTemplate), std::move(data), true, continued});
+}
+
+bool TestFileWriter::isStarted(const std::filesystem::path &path) const {
+    return startedFiles.count(path) != 0;
+}
+
+std::map<std::filesystem::path, uintmax_t> TestFileWriter::getStartedFileSizes() const {
+    std::map<std::filesystem::path, uintmax_t> sizes;
+    for (const auto &path : startedFiles) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(getFilePath(path), error);
+        sizes.emplace(path, error ? 0 : size);
+    }
+    return sizes;
+}
+
+void TestFileWriter::continueFiles(const std::map<std::filesystem::path, uintmax_t> &sizes) {
+    for (const auto &[path, size] : sizes) {
+        std::error_code error;
+        std::filesystem::resize_file(getFilePath(path), size, error);
+        if (error) {
+            ::error(ErrorType::ERR_IO, "Unable to continue test file %1%: %2%",
+                    getFilePath(path).c_str(), error.message().c_str());
+            continue;
+        }
+        startedFiles.insert(path);
+    }
+}
+
+void TestFileWriter::submit(Job job) {
+#ifdef MULTITHREAD
+    if (async) {
+        std::unique_lock<std::mutex> acquire(lock);
+        queueChanged.wait(acquire, [this]() { return queue.size() < QUEUE_CAPACITY; });
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        queue.push_back(std::move(job));
+        acquire.unlock();
+        queueChanged.notify_all();
+        reportOpenFailures();
+        return;
+    }
+#endif  // MULTITHREAD
+    process(job);
+}
+
+#ifdef MULTITHREAD
+void TestFileWriter::work() {
+    std::unique_lock<std::mutex> acquire(lock);
+    while (true) {
+        queueChanged.wait(acquire, [this]() { return !queue.empty() || stopping; });
+        if (queue.empty()) {
+            return;
+        }
+        auto job = std::move(queue.front());
+        queue.pop_front();
+        busy = true;
+        acquire.unlock();
+        queueChanged.notify_all();
+        try {
+            process(job);
+        } catch (...) {
+            acquire.lock();
+            if (!failure) {
+                failure = std::current_exception();
+            }
+            acquire.unlock();
+        }
+        acquire.lock();
+        busy = false;
+        queueChanged.notify_all();
+    }
+}
+#endif  // MULTITHREAD
+
+void TestFileWriter::flush() {
+#ifdef MULTITHREAD
+    if (async) {
+        std::unique_lock<std::mutex> acquire(lock);
+        queueChanged.wait(acquire, [this]() { return queue.empty() && !busy; });
+        if (failure) {
+            std::rethrow_exception(std::exchange(failure, nullptr));
+        }
+    }
+#endif  // MULTITHREAD
+    reportOpenFailures();
+    // The background thread is idle now, so the files can be closed from here.
+    closeFiles();
+}
+
+void TestFileWriter::process(const Job &job) {
+    auto it = templates.find(job.testTemplate);
+    if (it == templates.end()) {
+        it = templates.emplace(job.testTemplate, environment.parse(job.testTemplate)).first;
+    }
+    if (!job.append) {
+        auto stream = openStream(job.path, false);
+        if (stream == nullptr) {
+            return;
+        }
+        environment.render_to(*stream, it->second, job.data);
+        stream->reset();
+        return;
+    }
+    if (failedFiles.count(job.path) != 0) {
+        return;
+    }
+    auto &stream = openFiles[job.path];
+    if (stream == nullptr) {
+        // Files which were closed by @ref flush or written by an earlier run are continued.
+        // Concatenated gzip streams are valid.
+        stream = openStream(job.path, job.continued);
+        if (stream == nullptr) {
+            failedFiles.insert(job.path);
+            openFiles.erase(job.path);
+            return;
+        }
+    }
+    environment.render_to(*stream, it->second, job.data);
+    // Compressed streams can only be flushed completely when they are closed.
+    if (!compress) {
+        stream->flush();
+    }
+}
+
+std::filesystem::path TestFileWriter::getFilePath(std::filesystem::path path) const {
+    if (compress) {
+        path += ".gz";
+    }
+    return path;
+}
+
+std::unique_ptr<boost::iostreams::filtering_ostream> TestFileWriter::openStream(
+    const std::filesystem::path &path, bool append) {
+    auto stream = std::make_unique<boost::iostreams::filtering_ostream>();
+    if (compress) {
+        stream->push(boost::iostreams::gzip_compressor());
+    }
+    auto mode = std::ios::out | std::ios::binary;
+    if (append) {
+        mode |= std::ios::app;
+    }
+    auto filePath = getFilePath(path);
+    boost::iostreams::file_sink file(filePath.string(), mode);
+    if (!file.is_open()) {
+        failedToOpen(filePath);
+        return nullptr;
+    }
+    stream->push(file);
+    return stream;
+}
+
+void TestFileWriter::failedToOpen(const std::filesystem::path &path) {
+#ifdef MULTITHREAD
+    if (async) {
+        std::lock_guard<std::mutex> acquire(lock);
+        openFailures.push_back(path);
+        return;
+    }
+#endif  // MULTITHREAD
+    ::error(ErrorType::ERR_IO, "Unable to open test file %1%.", path.c_str());
+}
+
+void TestFileWriter::reportOpenFailures() {
+#ifdef MULTITHREAD
+    std::vector<std::filesystem::path> failures;
+    {
+        std::lock_guard<std::mutex> acquire(lock);
+        failures.swap(openFailures);
+    }
+    for (const auto &path : failures) {
+        ::error(ErrorType::ERR_IO, "Unable to open test file %1%.", path.c_str());
+    }
+#endif  // MULTITHREAD
+}
+
+void TestFileWriter::closeFiles() {
+    for (auto &[path, stream] : openFiles) {
+        stream->reset();
+    }
+    openFiles.clear();
+}
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,162 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_FILE_WRITER_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_FILE_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef MULTITHREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif  // MULTITHREAD
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <inja/inja.hpp>
+
+namespace P4Tools::P4Testgen {
+
+/// Renders tests with their inja templates and writes them to disk. Every template is parsed
+/// once. If the writer is asynchronous, rendering and I/O happen on a background thread, so the
+/// symbolic executor does not wait for them. At most @ref QUEUE_CAPACITY tests wait to be
+/// written; once the queue is full, submitting a test blocks. Asynchronous writing requires
+/// MULTITHREAD support, otherwise tests are written on the calling thread.
+class TestFileWriter {
+ public:
+    /// The maximum number of tests waiting to be written.
+    static constexpr size_t QUEUE_CAPACITY = 256;
+
+    /// @param async selects the background thread. If @param compress is set, files are
+    /// compressed with gzip and ".gz" is appended to their names.
+    TestFileWriter(bool async, bool compress);
+
+    /// Writes all queued tests.
+    ~TestFileWriter();
+
+    TestFileWriter(const TestFileWriter &) = delete;
+    TestFileWriter(TestFileWriter &&) = delete;
+    TestFileWriter &operator=(const TestFileWriter &) = delete;
+    TestFileWriter &operator=(TestFileWriter &&) = delete;
+
+    /// Renders @param data with @param testTemplate into a new file at @param path.
+    void writeFile(std::filesystem::path path, std::string testTemplate, inja::json data);
+
+    /// Renders @param data with @param testTemplate and appends the result to the file at
+    /// @param path. The file is truncated when this writer first appends to it, unless it was
+    /// passed to @ref continueFiles, and stays open until @ref flush.
+    void appendFile(std::filesystem::path path, std::string testTemplate, inja::json data);
+
+    /// @returns whether the file at @param path has been appended to, by this writer or by the
+    /// run passed to @ref continueFiles.
+    [[nodiscard]] bool isStarted(const std::filesystem::path &path) const;
+
+    /// @returns the size on disk of every file which has been appended to. Only complete after
+    /// @ref flush.
+    [[nodiscard]] std::map<std::filesystem::path, uintmax_t> getStartedFileSizes() const;
+
+    /// Continues the files of an earlier run, as returned by its @ref getStartedFileSizes. Each
+    /// file is cut back to its recorded size, which drops whatever the earlier run wrote later,
+    /// and is appended to instead of being truncated.
+    void continueFiles(const std::map<std::filesystem::path, uintmax_t> &sizes);
+
+    /// Waits until all submitted tests are written and closes all files. Rethrows the first
+    /// exception raised while writing in the background. Files which can not be opened are
+    /// reported as errors, and their tests are dropped.
+    void flush();
+
+ private:
+    struct Job {
+        std::filesystem::path path;
+        std::string testTemplate;
+        inja::json data;
+        bool append;
+        /// Whether an appended file already has content, which must be kept.
+        bool continued;
+    };
+
+    /// Whether files are compressed.
+    bool compress;
+
+    inja::Environment environment;
+
+    /// The parsed templates, indexed by their source.
+    std::map<std::string, inja::Template> templates;
+
+    /// The files which are appended to.
+    std::map<std::filesystem::path, std::unique_ptr<boost::iostreams::filtering_ostream>>
+        openFiles;
+
+    /// All files appended to so far, including those continued from an earlier run. Only used
+    /// by the submitting thread.
+    std::set<std::filesystem::path> startedFiles;
+
+    /// The files which could not be opened. Further tests for them are dropped.
+    std::set<std::filesystem::path> failedFiles;
+
+#ifdef MULTITHREAD
+    /// Whether there is a background thread.
+    bool async;
+
+    /// The tests waiting to be written.
+    std::deque<Job> queue;
+
+    /// Whether the background thread is writing a test which is no longer in @var queue.
+    bool busy = false;
+
+    /// Tells the background thread to exit once @var queue is empty.
+    bool stopping = false;
+
+    /// The first exception raised by the background thread.
+    std::exception_ptr failure;
+
+    /// Files which the background thread could not open and which have not been reported yet.
+    std::vector<std::filesystem::path> openFailures;
+
+    /// Protects the members above.
+    std::mutex lock;
+
+    /// Signals changes of @var queue, @var busy and @var stopping.
+    std::condition_variable queueChanged;
+
+    std::thread thread;
+
+    /// The main loop of the background thread.
+    void work();
+#endif  // MULTITHREAD
+
+    /// Writes @param job now or hands it to the background thread.
+    void submit(Job job);
+
+    /// Renders and writes @param job.
+    void process(const Job &job);
+
+    /// @returns the path of the file on disk for @param path.
+    [[nodiscard]] std::filesystem::path getFilePath(std::filesystem::path path) const;
+
+    /// @returns a new stream writing to @param path, which compresses if @var compress is set,
+    /// or nullptr if the file can not be opened. The file is truncated unless @param append is
+    /// set.
+    [[nodiscard]] std::unique_ptr<boost::iostreams::filtering_ostream> openStream(
+        const std::filesystem::path &path, bool append);
+
+    /// Reports that @param path can not be opened. Diagnostics are not thread-safe, so the
+    /// background thread leaves them to @ref reportOpenFailures.
+    void failedToOpen(const std::filesystem::path &path);
+
+    /// Reports the files which the background thread could not open.
+    void reportOpenFailures();
+
+    /// Closes all files which are appended to.
+    void closeFiles();
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_FILE_WRITER_H_ */
@@ -1,20 +1,67 @@
 #include "backends/p4tools/modules/testgen/lib/test_framework.h"
 
+#include <string>
+
+#include "lib/exceptions.h"
+
 #include "backends/p4tools/modules/testgen/lib/exceptions.h"
 
 namespace P4Tools::P4Testgen {
 
 TestFramework::TestFramework(const TestBackendConfiguration &testBackendConfiguration)
-    : testBackendConfiguration(testBackendConfiguration) {}
+    : testBackendConfiguration(testBackendConfiguration) {
+    if (isInFileMode()) {
+        fileWriter = std::make_shared<TestFileWriter>(testBackendConfiguration.asyncTestWriter,
+                                                      testBackendConfiguration.compressTests);
+    }
+}
 
 const TestBackendConfiguration &TestFramework::getTestBackendConfiguration() const {
     return testBackendConfiguration.get();
 }
 
+TestFileWriter &TestFramework::getFileWriter() const {
+    BUG_CHECK(fileWriter != nullptr, "Tests are only written in file mode.");
+    return *fileWriter;
+}
+
+std::filesystem::path TestFramework::getSharedTestFilePath(size_t testId,
+                                                           std::string_view extension) const {
+    const auto &configuration = getTestBackendConfiguration();
+    BUG_CHECK(configuration.fileBasePath.has_value(), "Base path is not set.");
+    auto path = configuration.fileBasePath.value();
+    if (configuration.numTestFiles > 1) {
+        // Test ids start at 1.
+        path.concat("_" + std::to_string((testId - 1) % configuration.numTestFiles));
+    }
+    path.replace_extension(extension);
+    return path;
+}
+
 bool TestFramework::isInFileMode() const {
     return getTestBackendConfiguration().fileBasePath.has_value();
 }
 
+void TestFramework::flushTests() {
+    if (fileWriter != nullptr) {
+        fileWriter->flush();
+    }
+}
+
+std::map<std::filesystem::path, uintmax_t> TestFramework::getTestFileSizes() const {
+    if (fileWriter == nullptr) {
+        return {};
+    }
+    return fileWriter->getStartedFileSizes();
+}
+
+void TestFramework::continueTestFiles(
+    const std::map<std::filesystem::path, uintmax_t> &testFileSizes) {
+    if (fileWriter != nullptr) {
+        fileWriter->continueFiles(testFileSizes);
+    }
+}
+
 AbstractTestReferenceOrError TestFramework::produceTest(const TestSpec * /*spec*/,
                                                         cstring /*selectedBranches*/,
                                                         size_t /*testIdx*/,
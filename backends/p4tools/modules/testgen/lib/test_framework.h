@@ -2,12 +2,15 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_FRAMEWORK_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include <inja/inja.hpp>
@@ -18,6 +21,7 @@
 #include "lib/cstring.h"
 
 #include "backends/p4tools/modules/testgen/lib/test_backend_configuration.h"
+#include "backends/p4tools/modules/testgen/lib/test_file_writer.h"
 #include "backends/p4tools/modules/testgen/lib/test_object.h"
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
 
@@ -54,6 +58,9 @@ class TestFramework {
     /// Configuration options for the test back end.
     std::reference_wrapper<const TestBackendConfiguration> testBackendConfiguration;
 
+    /// Renders and writes the tests. Only set in file mode.
+    std::shared_ptr<TestFileWriter> fileWriter;
+
  protected:
     /// Creates a generic test framework.
     explicit TestFramework(const TestBackendConfiguration &testBackendConfiguration);
@@ -159,6 +166,15 @@ class TestFramework {
     /// Returns the configuration options for the test back end.
     [[nodiscard]] const TestBackendConfiguration &getTestBackendConfiguration() const;
 
+    /// @returns the writer which renders the tests and writes them to disk.
+    [[nodiscard]] TestFileWriter &getFileWriter() const;
+
+    /// @returns the path of the file with @param extension which test @param testId is added to
+    /// by back ends that put all tests into one file. If the configuration asks for several
+    /// files, the tests are distributed round-robin.
+    [[nodiscard]] std::filesystem::path getSharedTestFilePath(size_t testId,
+                                                              std::string_view extension) const;
+
  public:
     virtual ~TestFramework() = default;
 
@@ -183,6 +199,17 @@ class TestFramework {
 
     /// @Returns true if the test framework is configured to write to a file.
     [[nodiscard]] bool isInFileMode() const;
+
+    /// Waits until all tests passed to @ref writeTestToFile are on disk.
+    void flushTests();
+
+    /// @returns the size of every file that tests have been appended to. Call @ref flushTests
+    /// first.
+    [[nodiscard]] std::map<std::filesystem::path, uintmax_t> getTestFileSizes() const;
+
+    /// Appends to the test files of an earlier run, with the sizes returned by its
+    /// @ref getTestFileSizes, instead of replacing them.
+    void continueTestFiles(const std::map<std::filesystem::path, uintmax_t> &testFileSizes);
 };
 
 }  // namespace P4Tools::P4Testgen
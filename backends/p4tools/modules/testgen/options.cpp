@@ -56,6 +56,99 @@ TestgenOptions::TestgenOptions()
         "Sets the maximum number of tests to be generated [default: 1]. Setting the value to 0 "
         "will generate tests until no more paths can be found.");
 
+    registerOption(
+        "--num-workers", "numWorkers",
+        [this](const char *arg) {
+            try {
+                numWorkers = std::stoi(arg);
+                if (numWorkers < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+            } catch (std::invalid_argument &) {
+                ::error("Invalid input value %1% for --num-workers. Expected positive integer.",
+                        arg);
+                return false;
+            }
+            return true;
+        },
+        "Explore paths with this many threads, each with its own solver [default: 1]. Tests are "
+        "numbered in path order, independent of thread timing. Only supported with the "
+        "DEPTH_FIRST path selection policy.");
+
+    registerOption(
+        "--async-test-writer", nullptr,
+        [this](const char *) {
+            asyncTestWriter = true;
+            return true;
+        },
+        "Render and write tests on a background thread. Requires a build with multithreading "
+        "support.");
+
+    registerOption(
+        "--compress-tests", nullptr,
+        [this](const char *) {
+            compressTests = true;
+            return true;
+        },
+        "Compress the generated test files with gzip.");
+
+    registerOption(
+        "--num-test-files", "numTestFiles",
+        [this](const char *arg) {
+            try {
+                numTestFiles = std::stoi(arg);
+                if (numTestFiles < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+            } catch (std::invalid_argument &) {
+                ::error("Invalid input value %1% for --num-test-files. Expected positive integer.",
+                        arg);
+                return false;
+            }
+            return true;
+        },
+        "Spread the tests of the PTF test back end, which writes all tests into one file, over "
+        "this many files [default: 1].");
+
+    registerOption(
+        "--shard", "index/count",
+        [this](const char *arg) {
+            std::string shard(arg);
+            try {
+                size_t indexEnd = 0;
+                shardIndex = std::stoi(shard, &indexEnd);
+                if (indexEnd >= shard.size() || shard[indexEnd] != '/') {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                size_t countEnd = 0;
+                numShards = std::stoi(shard.substr(indexEnd + 1), &countEnd);
+                if (indexEnd + 1 + countEnd != shard.size() || shardIndex < 0 || numShards < 1 ||
+                    shardIndex >= numShards) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+            } catch (std::logic_error &) {
+                ::error(
+                    "Invalid input value %1% for --shard. Expected index/count with "
+                    "0 <= index < count.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "Partition the branch tree into count shards and only explore the paths of the shard "
+        "with the given index. The partition is deterministic, so runs with the same options "
+        "and different indices generate disjoint sets of tests.");
+
+    registerOption(
+        "--checkpoint", "file",
+        [this](const char *arg) {
+            checkpointFile = arg;
+            return true;
+        },
+        "Periodically save the unexplored branches and the visited coverage to this file. If "
+        "the file exists, resume the exploration it describes. Only supported with the "
+        "DEPTH_FIRST path selection policy.");
+
     registerOption(
         "--stop-metric", "stopMetric",
         [this](const char *arg) {
@@ -279,6 +372,15 @@ TestgenOptions::TestgenOptions()
         "DEPTH_FIRST, RANDOM_BACKTRACK, and GREEDY_STATEMENT_SEARCH. "
         "Defaults to DEPTH_FIRST.");
 
+    registerOption(
+        "--lazy-feasibility-checks", nullptr,
+        [this](const char *) {
+            lazyFeasibility = true;
+            return true;
+        },
+        "Check whether a branch is satisfiable only when the path selection policy picks it. "
+        "Saves solver calls for branches which are never explored.");
+
     registerOption(
         "--track-coverage", "coverageItem",
         [this](const char *arg) {
@@ -422,6 +524,36 @@ TestgenOptions::TestgenOptions()
 }
 
 bool TestgenOptions::validateOptions() const {
+    if (numWorkers > 1 && (pathSelectionPolicy != P4Testgen::PathSelectionPolicy::DepthFirst ||
+                           !selectedBranches.empty())) {
+        ::error(ErrorType::ERR_INVALID,
+                "--num-workers is only supported with the DEPTH_FIRST path selection policy.");
+        return false;
+    }
+    if (lazyFeasibility && (numWorkers > 1 || !selectedBranches.empty())) {
+        ::error(ErrorType::ERR_INVALID,
+                "--lazy-feasibility-checks is not supported with --num-workers or "
+                "--input-branches.");
+        return false;
+    }
+    if (checkpointFile.has_value() &&
+        (pathSelectionPolicy != P4Testgen::PathSelectionPolicy::DepthFirst || numWorkers > 1 ||
+         !selectedBranches.empty())) {
+        ::error(ErrorType::ERR_INVALID,
+                "--checkpoint is only supported with the sequential DEPTH_FIRST path selection "
+                "policy.");
+        return false;
+    }
+    // The other test back ends write one file per test already.
+    if (numTestFiles > 1 && testBackend != "PTF") {
+        ::error(ErrorType::ERR_INVALID,
+                "--num-test-files is only supported by the PTF test back end.");
+        return false;
+    }
+    if (numShards > 1 && !selectedBranches.empty()) {
+        ::error(ErrorType::ERR_INVALID, "--shard and --input-branches are mutually exclusive.");
+        return false;
+    }
     if (minCoverage > 0 && !hasCoverageTracking) {
         ::error(
             ErrorType::ERR_INVALID,
@@ -26,6 +26,36 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// Selects the path selection policy for test generation
     P4Testgen::PathSelectionPolicy pathSelectionPolicy = P4Testgen::PathSelectionPolicy::DepthFirst;
 
+    /// Check the satisfiability of a branch only when the path selection policy takes it, instead
+    /// of checking all successors of a branch point eagerly.
+    bool lazyFeasibility = false;
+
+    /// Number of threads exploring paths in parallel. Each worker owns its own solver.
+    /// Defaults to 1, which runs the sequential path selection policies.
+    int numWorkers = 1;
+
+    /// The shard of the branch tree explored by this run, in the range [0, @ref numShards).
+    int shardIndex = 0;
+
+    /// The number of shards the branch tree is partitioned into. Every shard explores a disjoint
+    /// set of paths. Defaults to 1, which explores the whole tree.
+    int numShards = 1;
+
+    /// Render and write tests on a background thread, so that path exploration does not wait for
+    /// them.
+    bool asyncTestWriter = false;
+
+    /// Compress the generated test files with gzip.
+    bool compressTests = false;
+
+    /// The number of files that test back ends which write all tests into a single file, such as
+    /// PTF, spread the tests over.
+    int numTestFiles = 1;
+
+    /// File in which the progress of the exploration is periodically saved. If the file exists
+    /// when P4Testgen starts, the exploration resumes from it.
+    std::optional<std::filesystem::path> checkpointFile = std::nullopt;
+
     /// List of the supported stop metrics.
     static const std::set<cstring> SUPPORTED_STOP_METRICS;
 
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/testgen.h"
+
+namespace Test {
+
+namespace {
+
+/// @returns the number of occurrences of @param needle in the file at @param path.
+size_t countInFile(const std::filesystem::path &path, const std::string &needle) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    auto text = content.str();
+    size_t count = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + needle.size())) {
+        count++;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST(P4TestgenResumeTest, ResumedRunKeepsEarlierTests) {
+    std::stringstream streamTest;
+    streamTest << R"p4(
+header ethernet_t {
+    bit<48> dst_addr;
+    bit<48> src_addr;
+    bit<16> ether_type;
+}
+
+struct Headers {
+  ethernet_t eth_hdr;
+}
+
+struct Metadata {  }
+parser parse(packet_in pkt, out Headers hdr, inout Metadata m, inout standard_metadata_t sm) {
+  state start {
+      pkt.extract(hdr.eth_hdr);
+      transition accept;
+  }
+}
+control ingress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {
+      if (hdr.eth_hdr.dst_addr == 0xDEADDEADDEAD && hdr.eth_hdr.src_addr == 0xBEEFBEEFBEEF && hdr.eth_hdr.ether_type == 0xF00D) {
+          mark_to_drop(sm);
+      }
+  }
+}
+control egress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {}
+}
+control deparse(packet_out pkt, in Headers hdr) {
+  apply {
+    pkt.emit(hdr.eth_hdr);
+  }
+}
+control verifyChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+control computeChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+V1Switch(parse(), verifyChecksum(), ingress(), egress(), computeChecksum(), deparse()) main;
+)p4";
+
+    auto source = P4_SOURCE(P4Headers::V1MODEL, streamTest.str().c_str());
+    auto compilerOptions = P4CContextWithOptions<CompilerOptions>::get().options();
+    compilerOptions.target = "bmv2";
+    compilerOptions.arch = "v1model";
+    auto &testgenOptions = P4Tools::P4Testgen::TestgenOptions::get();
+    testgenOptions.testBackend = "PTF";
+    testgenOptions.testBaseName = "resume";
+    testgenOptions.seed = 1;
+    // Create a bespoke packet for the Ethernet extract call.
+    testgenOptions.minPktSize = 112;
+    testgenOptions.maxPktSize = 112;
+
+    auto testDir = std::filesystem::temp_directory_path() / "p4testgen_resume_test";
+    std::filesystem::remove_all(testDir);
+
+    // A run without checkpoints produces the reference number of tests.
+    testgenOptions.outputDir = testDir / "reference";
+    testgenOptions.maxTests = 0;
+    ASSERT_EQ(P4Tools::P4Testgen::Testgen::writeTests(source, compilerOptions, testgenOptions),
+              EXIT_SUCCESS);
+    auto allTests = countInFile(testDir / "reference" / "resume.py", "(AbstractTest):");
+    ASSERT_GT(allTests, 2U);
+
+    // Stop after two tests, as if the run was killed right after its checkpoint.
+    testgenOptions.outputDir = testDir / "resumed";
+    testgenOptions.checkpointFile = testDir / "checkpoint.json";
+    testgenOptions.maxTests = 2;
+    ASSERT_EQ(P4Tools::P4Testgen::Testgen::writeTests(source, compilerOptions, testgenOptions),
+              EXIT_SUCCESS);
+    auto testFile = testDir / "resumed" / "resume.py";
+    EXPECT_EQ(countInFile(testFile, "(AbstractTest):"), 2U);
+    // The killed run kept writing a test, which the checkpoint does not know of.
+    {
+        std::ofstream file(testFile, std::ios::app);
+        file << "\nclass TestAfterCheckpoint(AbstractTest):\n    pass\n";
+    }
+
+    // The resumed run keeps the tests of the first run and drops the test after the checkpoint.
+    testgenOptions.maxTests = 0;
+    ASSERT_EQ(P4Tools::P4Testgen::Testgen::writeTests(source, compilerOptions, testgenOptions),
+              EXIT_SUCCESS);
+    EXPECT_EQ(countInFile(testFile, "(AbstractTest):"), allTests);
+    EXPECT_EQ(countInFile(testFile, "class AbstractTest("), 1U);
+    EXPECT_EQ(countInFile(testFile, "TestAfterCheckpoint"), 0U);
+
+    testgenOptions.checkpointFile = std::nullopt;
+    testgenOptions.outputDir = std::nullopt;
+    std::filesystem::remove_all(testDir);
+}
+
+}  // namespace Test
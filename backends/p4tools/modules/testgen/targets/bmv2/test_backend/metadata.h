@@ -3,7 +3,6 @@
 
 #include <cstddef>
 #include <filesystem>
-#include <fstream>
 #include <optional>
 #include <string>
 
@@ -26,9 +25,6 @@ class Metadata : public Bmv2TestFramework {
                          float currentCoverage) override;
 
  private:
-    /// The output file.
-    std::ofstream metadataFile;
-
     /// Emits the test preamble. This is only done once for all generated tests.
     /// For the Metadata back end this is the "p4testgen.proto" file.
     void emitPreamble(const std::string &preamble);
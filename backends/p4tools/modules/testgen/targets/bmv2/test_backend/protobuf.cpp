@@ -1,7 +1,6 @@
 #include "backends/p4tools/modules/testgen/targets/bmv2/test_backend/protobuf.h"
 
 #include <filesystem>
-#include <fstream>
 #include <iomanip>
 #include <map>
 #include <optional>
@@ -355,9 +354,7 @@ void Protobuf::writeTestToFile(const TestSpec *testSpec, cstring selectedBranche
     auto incrementedbasePath = optBasePath.value();
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".txtpb");
-    auto protobufFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(protobufFileStream, getTestCaseTemplate(), dataJson);
-    protobufFileStream.flush();
+    getFileWriter().writeFile(incrementedbasePath, getTestCaseTemplate(), std::move(dataJson));
 }
 
 AbstractTestReferenceOrError Protobuf::produceTest(const TestSpec *testSpec,
@@ -4,6 +4,7 @@
 #include <iomanip>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include <inja/inja.hpp>
 
@@ -448,9 +449,7 @@ void ProtobufIr::writeTestToFile(const TestSpec *testSpec, cstring selectedBranc
     auto incrementedbasePath = optBasePath.value();
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".txtpb");
-    auto protobufFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(protobufFileStream, getTestCaseTemplate(), dataJson);
-    protobufFileStream.flush();
+    getFileWriter().writeFile(incrementedbasePath, getTestCaseTemplate(), std::move(dataJson));
 }
 
 AbstractTestReferenceOrError ProtobufIr::produceTest(const TestSpec *testSpec,
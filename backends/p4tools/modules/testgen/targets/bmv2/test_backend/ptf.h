@@ -3,7 +3,6 @@
 
 #include <cstddef>
 #include <filesystem>
-#include <fstream>
 #include <optional>
 #include <string>
 #include <utility>
@@ -31,15 +30,9 @@ class PTF : public Bmv2TestFramework {
                          float currentCoverage) override;
 
  private:
-    /// Has the preamble been generated already?
-    bool preambleEmitted = false;
-
-    /// The output file.
-    std::ofstream ptfFileStream;
-
-    /// Emits the test preamble. This is only done once for all generated tests.
+    /// Emits the test preamble into @param ptfFile. This is only done once per file.
     /// For the PTF back end this is the test setup Python script..
-    void emitPreamble();
+    void emitPreamble(const std::filesystem::path &ptfFile);
 
     /// Emits a test case.
     /// @param testId specifies the test name.
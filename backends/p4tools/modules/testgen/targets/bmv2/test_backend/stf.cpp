@@ -1,6 +1,5 @@
 #include "backends/p4tools/modules/testgen/targets/bmv2/test_backend/stf.h"
 
-#include <fstream>
 #include <iomanip>
 #include <optional>
 #include <string>
@@ -238,9 +237,7 @@ void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
     auto incrementedbasePath = optBasePath.value();
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".stf");
-    auto stfFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(stfFileStream, testCase, dataJson);
-    stfFileStream.flush();
+    getFileWriter().writeFile(incrementedbasePath, testCase, std::move(dataJson));
 }
 
 void STF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
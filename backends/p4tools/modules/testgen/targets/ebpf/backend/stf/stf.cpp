@@ -1,7 +1,6 @@
 #include "backends/p4tools/modules/testgen/targets/ebpf/backend/stf/stf.h"
 
 #include <filesystem>
-#include <fstream>
 #include <iomanip>
 #include <list>
 #include <map>
@@ -249,9 +248,7 @@ void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
     auto incrementedbasePath = optBasePath.value();
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".stf");
-    auto stfFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(stfFileStream, testCase, dataJson);
-    stfFileStream.flush();
+    getFileWriter().writeFile(incrementedbasePath, testCase, std::move(dataJson));
 }
 
 void STF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
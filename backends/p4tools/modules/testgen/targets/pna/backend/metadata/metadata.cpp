@@ -178,9 +178,7 @@ void Metadata::emitTestcase(const TestSpec *testSpec, cstring selectedBranches,
     auto incrementedbasePath = optBasePath.value();
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".yml");
-    metadataFile = std::ofstream(incrementedbasePath);
-    inja::render_to(metadataFile, testCase, dataJson);
-    metadataFile.flush();
+    getFileWriter().writeFile(incrementedbasePath, testCase, std::move(dataJson));
 }
 
 void Metadata::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
@@ -3,7 +3,6 @@
 
 #include <cstddef>
 #include <filesystem>
-#include <fstream>
 #include <optional>
 #include <string>
 #include <utility>
@@ -21,9 +20,6 @@ namespace P4Tools::P4Testgen::Pna {
 
 /// Extracts information from the @testSpec to emit a Metadata test case.
 class Metadata : public TestFramework {
-    /// The output file.
-    std::ofstream metadataFile;
-
  public:
     ~Metadata() override = default;
     Metadata(const Metadata &) = delete;
@@ -186,7 +186,7 @@ inja::json PTF::getVerify(const TestSpec *testSpec) {
     return verifyData;
 }
 
-void PTF::emitPreamble() {
+void PTF::emitPreamble(const std::filesystem::path &ptfFile) {
     static const std::string PREAMBLE(
         R"""(# P4Runtime PTF test for {{test_name}}
 # p4testgen seed: {{ default(seed, "none") }}
@@ -289,8 +289,7 @@ class AbstractTest(bt.P4RuntimeTest):
         dataJson["seed"] = optSeed.value();
     }
 
-    inja::render_to(ptfFileStream, PREAMBLE, dataJson);
-    ptfFileStream.flush();
+    getFileWriter().appendFile(ptfFile, PREAMBLE, std::move(dataJson));
 }
 
 // Iteration of meter_values, from BMv2, is deleted
@@ -398,16 +397,11 @@ void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
 
     LOG5("PTF backend: emitting testcase:" << std::setw(4) << dataJson);
 
-    if (!preambleEmitted) {
-        BUG_CHECK(getTestBackendConfiguration().fileBasePath.has_value(), "Base path is not set.");
-        auto ptfFile = getTestBackendConfiguration().fileBasePath.value();
-        ptfFile.replace_extension(".py");
-        ptfFileStream = std::ofstream(ptfFile);
-        emitPreamble();
-        preambleEmitted = true;
+    auto ptfFile = getSharedTestFilePath(testId, ".py");
+    if (!getFileWriter().isStarted(ptfFile)) {
+        emitPreamble(ptfFile);
     }
-    inja::render_to(ptfFileStream, testCase, dataJson);
-    ptfFileStream.flush();
+    getFileWriter().appendFile(ptfFile, testCase, std::move(dataJson));
 }
 
 void PTF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
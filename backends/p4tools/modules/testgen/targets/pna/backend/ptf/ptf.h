@@ -3,7 +3,6 @@
 
 #include <cstddef>
 #include <filesystem>
-#include <fstream>
 #include <optional>
 #include <string>
 #include <utility>
@@ -23,12 +22,6 @@ namespace P4Tools::P4Testgen::Pna {
 
 /// Extracts information from the @testSpec to emit a PTF test case.
 class PTF : public TestFramework {
-    /// Has the preamble been generated already?
-    bool preambleEmitted = false;
-
-    /// The output file.
-    std::ofstream ptfFileStream;
-
  public:
     ~PTF() override = default;
     PTF(const PTF &) = delete;
@@ -43,9 +36,9 @@ class PTF : public TestFramework {
                          float currentCoverage) override;
 
  private:
-    /// Emits the test preamble. This is only done once for all generated tests.
+    /// Emits the test preamble into @param ptfFile. This is only done once per file.
     /// For the PTF back end this is the test setup Python script..
-    void emitPreamble();
+    void emitPreamble(const std::filesystem::path &ptfFile);
 
     /// Emits a test case.
     /// @param testId specifies the test name.
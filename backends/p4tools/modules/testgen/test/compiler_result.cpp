@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+#include "ir/ir.h"
+#include "ir/visitor.h"
+#include "lib/arena.h"
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+
+namespace Test {
+
+namespace {
+
+class CountNodes : public Inspector {
+ public:
+    size_t count = 0;
+    bool preorder(const IR::Node *) override {
+        count++;
+        return true;
+    }
+};
+
+}  // namespace
+
+/// The compilation context of P4ToolsTestCase::create is gone when it returns; the program
+/// must still be usable, including when its nodes come from the IR arena.
+TEST(P4ToolsTestCase, ProgramOutlivesCreate) {
+    auto test = P4ToolsTestCase::create_16("bmv2", "v1model", P4_SOURCE(P4Headers::V1MODEL, R"(
+header H { bit<8> a; }
+struct Headers { H h; }
+struct Metadata { }
+
+parser parse(packet_in pkt, out Headers hdr, inout Metadata meta,
+             inout standard_metadata_t sm) {
+    state start {
+        pkt.extract(hdr.h);
+        transition accept;
+    }
+}
+
+control ingress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+    apply {
+        if (hdr.h.a == 1) { sm.egress_spec = 2; }
+    }
+}
+
+control egress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+    apply {}
+}
+
+control deparse(packet_out pkt, in Headers hdr) {
+    apply { pkt.emit(hdr.h); }
+}
+
+control verifyChecksum(inout Headers hdr, inout Metadata meta) { apply {} }
+
+control computeChecksum(inout Headers hdr, inout Metadata meta) { apply {} }
+
+V1Switch(parse(), verifyChecksum(), ingress(), egress(), computeChecksum(), deparse()) main;)"));
+    ASSERT_TRUE(test);
+
+    const auto &program = test->getProgram();
+    if (auto *arena = Util::Arena::current()) EXPECT_TRUE(arena->contains(&program));
+
+    CountNodes counter;
+    program.apply(counter);
+    EXPECT_GT(counter.count, 0U);
+
+    const IR::P4Control *ingress = nullptr;
+    for (const auto *decl : program.objects) {
+        if (const auto *control = decl->to<IR::P4Control>()) {
+            if (control->name == "ingress") ingress = control;
+        }
+    }
+    ASSERT_NE(ingress, nullptr);
+    EXPECT_FALSE(ingress->body->components.empty());
+}
+
+}  // namespace Test
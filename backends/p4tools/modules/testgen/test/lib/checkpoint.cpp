@@ -0,0 +1,43 @@
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::Checkpoint;
+
+TEST(CheckpointTest, SaveAndLoad) {
+    auto path = std::filesystem::temp_directory_path() / "p4testgen_checkpoint_test.json";
+    std::filesystem::remove(path);
+    EXPECT_FALSE(Checkpoint::load(path).has_value());
+
+    Checkpoint checkpoint;
+    checkpoint.testCount = 42;
+    checkpoint.shardIndex = 1;
+    checkpoint.numShards = 4;
+    checkpoint.numCoverableNodes = 10;
+    checkpoint.visitedNodes = {0, 3, 9};
+    checkpoint.unexploredBranches = {{1, 2}, {2, 1, 3}};
+    checkpoint.testFileSizes = {{"out/test.py", 1234}};
+    checkpoint.save(path);
+
+    auto loaded = Checkpoint::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->testCount, 42);
+    EXPECT_EQ(loaded->shardIndex, 1);
+    EXPECT_EQ(loaded->numShards, 4);
+    EXPECT_EQ(loaded->numCoverableNodes, 10U);
+    EXPECT_EQ(loaded->visitedNodes, checkpoint.visitedNodes);
+    EXPECT_EQ(loaded->unexploredBranches, checkpoint.unexploredBranches);
+    EXPECT_EQ(loaded->testFileSizes, checkpoint.testFileSizes);
+    std::filesystem::remove(path);
+}
+
+}  // namespace
+
+}  // namespace Test
@@ -0,0 +1,98 @@
+#include "backends/p4tools/common/lib/persistent_map.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Test {
+
+namespace {
+
+using P4Tools::PersistentMap;
+using P4Tools::PersistentSet;
+using P4Tools::PersistentVector;
+
+TEST(PersistentMapTest, KeepsKeysOrdered) {
+    PersistentMap<int, int> map;
+    EXPECT_TRUE(map.empty());
+    for (int key : {5, 3, 8, 1, 4, 7, 9, 2, 6, 0}) {
+        map.set(key, key * 10);
+    }
+    map.set(4, 44);
+    EXPECT_EQ(map.size(), 10U);
+    int expected = 0;
+    for (const auto &[key, value] : map) {
+        EXPECT_EQ(key, expected);
+        EXPECT_EQ(value, key == 4 ? 44 : key * 10);
+        expected++;
+    }
+    EXPECT_EQ(expected, 10);
+    ASSERT_NE(map.find(7), nullptr);
+    EXPECT_EQ(*map.find(7), 70);
+    EXPECT_EQ(map.find(10), nullptr);
+}
+
+TEST(PersistentMapTest, CopiesAreIndependent) {
+    PersistentMap<int, int> map;
+    std::map<int, int> reference;
+    std::vector<std::pair<PersistentMap<int, int>, std::map<int, int>>> versions;
+    for (int step = 0; step < 1000; step++) {
+        int key = (step * 7919) % 257;
+        map.set(key, step);
+        reference[key] = step;
+        if (step % 100 == 0) {
+            versions.emplace_back(map, reference);
+        }
+    }
+    // Every copy still holds the entries it had when it was taken.
+    for (const auto &[version, expected] : versions) {
+        ASSERT_EQ(version.size(), expected.size());
+        auto it = expected.begin();
+        for (const auto &[key, value] : version) {
+            EXPECT_EQ(key, it->first);
+            EXPECT_EQ(value, it->second);
+            ++it;
+        }
+    }
+}
+
+TEST(PersistentSetTest, CopiesAreIndependent) {
+    PersistentSet<int> set;
+    EXPECT_TRUE(set.insert(3));
+    EXPECT_FALSE(set.insert(3));
+    set.insert(1);
+    auto copy = set;
+    EXPECT_TRUE(copy.insert(2));
+    EXPECT_EQ(set.size(), 2U);
+    EXPECT_FALSE(set.contains(2));
+    EXPECT_EQ(std::set<int>(copy.begin(), copy.end()), (std::set<int>{1, 2, 3}));
+    EXPECT_EQ(std::set<int>(set.begin(), set.end()), (std::set<int>{1, 3}));
+}
+
+TEST(PersistentVectorTest, CopiesShareTheirPrefix) {
+    PersistentVector<int> vector;
+    std::vector<std::pair<PersistentVector<int>, std::vector<int>>> versions;
+    std::vector<int> reference;
+    for (int step = 0; step < 500; step++) {
+        vector.push_back(step * 3);
+        reference.push_back(step * 3);
+        if (step % 50 == 0) {
+            versions.emplace_back(vector, reference);
+        }
+    }
+    // Appending to a copy does not change the original.
+    auto fork = versions.front().first;
+    fork.push_back(-1);
+    EXPECT_EQ(fork.size(), 2U);
+    EXPECT_EQ(fork[1], -1);
+    for (const auto &[version, expected] : versions) {
+        EXPECT_EQ(version.toVector(), expected);
+        EXPECT_EQ(version[version.size() - 1], expected.back());
+    }
+}
+
+}  // namespace
+
+}  // namespace Test
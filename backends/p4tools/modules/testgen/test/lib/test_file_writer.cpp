@@ -0,0 +1,34 @@
+#include "backends/p4tools/modules/testgen/lib/test_file_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "lib/error.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::TestFileWriter;
+
+TEST(TestFileWriterTest, ReportsUnopenableFiles) {
+    auto missingDir = std::filesystem::temp_directory_path() / "p4testgen_missing_dir";
+    std::filesystem::remove_all(missingDir);
+    auto errors = ::errorCount();
+    TestFileWriter writer(false, false);
+
+    writer.writeFile(missingDir / "test_1.stf", "{{ test_id }}", {{"test_id", 1}});
+    EXPECT_EQ(::errorCount(), errors + 1);
+
+    // A shared file is reported once, not once per test.
+    writer.appendFile(missingDir / "test.py", "{{ test_id }}", {{"test_id", 1}});
+    writer.appendFile(missingDir / "test.py", "{{ test_id }}", {{"test_id", 2}});
+    writer.flush();
+    EXPECT_EQ(::errorCount(), errors + 2);
+    EXPECT_FALSE(std::filesystem::exists(missingDir));
+}
+
+}  // namespace
+
+}  // namespace Test
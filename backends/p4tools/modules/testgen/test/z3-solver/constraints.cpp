@@ -3,6 +3,8 @@
 #include <optional>
 #include <vector>
 
+#include "backends/p4tools/common/core/constraint_slicer.h"
+#include "backends/p4tools/common/core/solver_query_cache.h"
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/variables.h"
 #include "ir/ir-generated.h"
@@ -188,4 +190,182 @@ TEST_F(Z3SolverSatisfiabilityChecks, Bools) {
     }
 }
 
+TEST(Z3SolverQueryCache, ReusesResults) {
+    P4Tools::Z3Solver solver;
+    const auto &stats = P4Tools::SolverQueryCache::statistics();
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *fooIsTwo = new IR::Equ(fooVar, IR::getConstant(eightBitType, 2));
+    const auto *barIsFoo = new IR::Equ(barVar, fooVar);
+
+    EXPECT_EQ(solver.checkSat({fooIsOne, barIsFoo}), true);
+
+    // The order of the constraints does not matter.
+    auto exactHits = stats.exactHits.load();
+    EXPECT_EQ(solver.checkSat({barIsFoo, fooIsOne, fooIsOne}), true);
+    EXPECT_EQ(stats.exactHits.load(), exactHits + 1);
+    const auto &model = solver.getSymbolicMapping();
+    ASSERT_GT(model.count(barVar), 0U);
+    EXPECT_EQ(model.at(barVar)->checkedTo<IR::Constant>()->value, 1);
+
+    // A subset of a satisfiable query is satisfiable, and inherits its model.
+    auto satSupersetHits = stats.satSupersetHits.load();
+    EXPECT_EQ(solver.checkSat({fooIsOne}), true);
+    EXPECT_EQ(stats.satSupersetHits.load(), satSupersetHits + 1);
+    EXPECT_EQ(&solver.getSymbolicMapping(), &model);
+
+    // A superset of an unsatisfiable query is unsatisfiable.
+    EXPECT_EQ(solver.checkSat({fooIsOne, fooIsTwo}), false);
+    auto unsatSubsetHits = stats.unsatSubsetHits.load();
+    EXPECT_EQ(solver.checkSat({fooIsOne, fooIsTwo, barIsFoo}), false);
+    EXPECT_EQ(stats.unsatSubsetHits.load(), unsatSubsetHits + 1);
+}
+
+TEST(Z3SolverQueryCache, SlicesIndependentConstraints) {
+    P4Tools::Z3Solver solver;
+    const auto &stats = P4Tools::SolverQueryCache::statistics();
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar");
+    const auto *bazVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "baz");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *barIsTwo = new IR::Equ(barVar, IR::getConstant(eightBitType, 2));
+    const auto *bazIsBar = new IR::Equ(bazVar, barVar);
+    const auto *bazIsOne = new IR::Equ(bazVar, IR::getConstant(eightBitType, 1));
+
+    auto groups = P4Tools::ConstraintSlicer().slice({barIsTwo, fooIsOne, bazIsBar});
+    ASSERT_EQ(groups.size(), 2U);
+    EXPECT_EQ(groups[0], P4Tools::ConstraintSlicer::Group({barIsTwo, bazIsBar}));
+    EXPECT_EQ(groups[1], P4Tools::ConstraintSlicer::Group({fooIsOne}));
+
+    // The model of a sliced query combines the models of its groups.
+    EXPECT_EQ(solver.checkSat({fooIsOne, barIsTwo, bazIsBar}), true);
+    const auto &model = solver.getSymbolicMapping();
+    ASSERT_EQ(model.size(), 3U);
+    EXPECT_EQ(model.at(fooVar)->checkedTo<IR::Constant>()->value, 1);
+    EXPECT_EQ(model.at(bazVar)->checkedTo<IR::Constant>()->value, 2);
+
+    // Each group has been cached on its own.
+    auto exactHits = stats.exactHits.load();
+    EXPECT_EQ(solver.checkSat({barIsTwo, bazIsBar}), true);
+    EXPECT_EQ(stats.exactHits.load(), exactHits + 1);
+
+    // A single unsatisfiable group makes the query unsatisfiable.
+    EXPECT_EQ(solver.checkSat({fooIsOne, barIsTwo, bazIsBar, bazIsOne}), false);
+}
+
+TEST(Z3SolverQueryCache, SlicedModelsKeepGroupVariables) {
+    P4Tools::Z3Solver solver;
+    const auto &stats = P4Tools::SolverQueryCache::statistics();
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *barIsFoo = new IR::Equ(barVar, fooVar);
+    const auto *barIsTwo = new IR::Equ(barVar, IR::getConstant(eightBitType, 2));
+
+    // The model of this query assigns 1 to bar.
+    EXPECT_EQ(solver.checkSat({fooIsOne, barIsFoo}), true);
+    EXPECT_EQ(solver.getSymbolicMapping().at(barVar)->checkedTo<IR::Constant>()->value, 1);
+
+    // The group of foo inherits that model from its superset, but bar belongs to the other group.
+    auto satSupersetHits = stats.satSupersetHits.load();
+    EXPECT_EQ(solver.checkSat({fooIsOne, barIsTwo}), true);
+    EXPECT_EQ(stats.satSupersetHits.load(), satSupersetHits + 1);
+    const auto &model = solver.getSymbolicMapping();
+    ASSERT_EQ(model.size(), 2U);
+    EXPECT_EQ(model.at(fooVar)->checkedTo<IR::Constant>()->value, 1);
+    EXPECT_EQ(model.at(barVar)->checkedTo<IR::Constant>()->value, 2);
+}
+
+TEST(Z3SolverQueryCache, ChecksAlternatives) {
+    P4Tools::Z3Solver solver;
+    const auto &stats = P4Tools::SolverQueryCache::statistics();
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar");
+    const auto *barIsFoo = new IR::Equ(barVar, fooVar);
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *barIsOne = new IR::Equ(barVar, IR::getConstant(eightBitType, 1));
+    const auto *barIsTwo = new IR::Equ(barVar, IR::getConstant(eightBitType, 2));
+
+    // Sibling branches share the prefix of their path constraints.
+    auto results = solver.checkSatAlternatives(
+        {{barIsFoo, fooIsOne, barIsOne}, {barIsFoo, fooIsOne, barIsTwo}, {barIsFoo, fooIsOne}});
+    EXPECT_EQ(results, std::vector<std::optional<bool>>({true, false, true}));
+
+    // The results are cached.
+    auto exactHits = stats.exactHits.load();
+    EXPECT_EQ(solver.checkSat({barIsFoo, fooIsOne, barIsTwo}), false);
+    EXPECT_EQ(stats.exactHits.load(), exactHits + 1);
+
+    // The solver still answers regular queries correctly.
+    EXPECT_EQ(solver.checkSat({barIsFoo, barIsTwo}), true);
+    const auto &model = solver.getSymbolicMapping();
+    ASSERT_GT(model.count(fooVar), 0U);
+    EXPECT_EQ(model.at(fooVar)->checkedTo<IR::Constant>()->value, 2);
+}
+
+TEST(Z3SolverQueryCache, SlicesAlternatives) {
+    P4Tools::Z3Solver solver;
+    const auto &stats = P4Tools::SolverQueryCache::statistics();
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *barIsOne = new IR::Equ(barVar, IR::getConstant(eightBitType, 1));
+    const auto *barIsTwo = new IR::Equ(barVar, IR::getConstant(eightBitType, 2));
+
+    // The constraint on foo is independent of both branches on bar, so it is solved only once.
+    auto solverCalls = stats.solverCalls.load();
+    auto results = solver.checkSatAlternatives({{fooIsOne, barIsOne}, {fooIsOne, barIsTwo}});
+    EXPECT_EQ(results, std::vector<std::optional<bool>>({true, true}));
+    EXPECT_EQ(stats.solverCalls.load(), solverCalls + 3);
+
+    // Each group has been cached on its own.
+    auto exactHits = stats.exactHits.load();
+    EXPECT_EQ(solver.checkSat({barIsTwo}), true);
+    EXPECT_EQ(stats.exactHits.load(), exactHits + 1);
+}
+
+TEST(Z3SolverQueryCache, EvictsLeastRecentlyUsed) {
+    P4Tools::SolverQueryCache cache;
+    const auto &stats = P4Tools::SolverQueryCache::statistics();
+    const P4Tools::SolverQueryCache::Query recent({new IR::BoolLiteral(true)});
+    const P4Tools::SolverQueryCache::Query old({new IR::BoolLiteral(true)});
+    cache.insert(recent, true);
+    cache.insert(old, true);
+    auto evictions = stats.evictions.load();
+    // Fill the cache up to its bound on the number of entries, keeping one entry in use.
+    for (size_t idx = 2; idx < (1 << 16); ++idx) {
+        EXPECT_NE(cache.find(recent), nullptr);
+        cache.insert({new IR::BoolLiteral(true)}, false);
+    }
+    EXPECT_EQ(stats.evictions.load(), evictions);
+
+    // The next lookup drops the least recently used half.
+    EXPECT_NE(cache.find(recent), nullptr);
+    EXPECT_EQ(stats.evictions.load(), evictions + (1 << 15));
+    EXPECT_EQ(cache.find(old), nullptr);
+}
+
+TEST(Z3SolverTranslation, ReusesSharedSubexpressions) {
+    P4Tools::Z3Solver solver;
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *fooPlusOne = new IR::Add(eightBitType, fooVar, IR::getConstant(eightBitType, 1));
+    const auto *isTwo = new IR::Equ(fooPlusOne, IR::getConstant(eightBitType, 2));
+    const auto *isThree = new IR::Equ(fooPlusOne, IR::getConstant(eightBitType, 3));
+
+    EXPECT_EQ(solver.checkSat({isTwo}), true);
+    // The second query replaces the first one. Its translation reuses the shared subexpression,
+    // so foo is not declared again, but must still be part of the model.
+    EXPECT_EQ(solver.checkSat({isThree}), true);
+    const auto &model = solver.getSymbolicMapping();
+    ASSERT_GT(model.count(fooVar), 0U);
+    EXPECT_EQ(model.at(fooVar)->checkedTo<IR::Constant>()->value, 2);
+}
+
 }  // namespace Test
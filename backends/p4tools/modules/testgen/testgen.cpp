@@ -1,5 +1,6 @@
 #include "backends/p4tools/modules/testgen/testgen.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
@@ -11,6 +12,7 @@
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "frontends/common/parser_options.h"
 #include "ir/solver.h"
+#include "lib/arena.h"
 #include "lib/cstring.h"
 #include "lib/error.h"
 
@@ -18,11 +20,14 @@
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/greedy_node_cov.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/random_backtrack.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/selected_branches.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 #include "backends/p4tools/modules/testgen/core/target.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
 #include "backends/p4tools/modules/testgen/lib/test_backend.h"
 #include "backends/p4tools/modules/testgen/lib/test_framework.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -46,9 +51,58 @@ SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
         std::string selectedBranchesStr = testgenOptions.selectedBranches;
         return new SelectedBranches(solver, programInfo, selectedBranchesStr);
     }
+    if (testgenOptions.numWorkers > 1) {
+        return new ParallelDepthFirstSearch(solver, programInfo, testgenOptions.numWorkers);
+    }
     return new DepthFirstSearch(solver, programInfo);
 }
 
+/// The minimum time between two checkpoints.
+constexpr auto CHECKPOINT_INTERVAL = std::chrono::seconds(60);
+
+/// Run the symbolic executor and hand every final state to the test back end. If a checkpoint
+/// file is set, resume from it if it exists and save the progress to it periodically from the
+/// exploration loop and once the exploration ends.
+void runSymbolicExecutor(const TestgenOptions &testgenOptions, SymbolicExecutor &symbolicExecutor,
+                         TestBackEnd &testBackend) {
+    if (!testgenOptions.checkpointFile.has_value()) {
+        symbolicExecutor.run([&testBackend](const FinalState &finalState) {
+            return testBackend.run(finalState);
+        });
+        return;
+    }
+    // Checkpoints are only supported by the sequential depth-first search.
+    auto &depthFirstSearch = dynamic_cast<DepthFirstSearch &>(symbolicExecutor);
+    const auto &checkpointFile = testgenOptions.checkpointFile.value();
+    auto saveCheckpoint = [&testBackend, &checkpointFile](Checkpoint checkpoint) {
+        // Only count tests which are on disk.
+        testBackend.flushTests();
+        checkpoint.testCount = testBackend.getTestCount();
+        checkpoint.testFileSizes = testBackend.getTestFileSizes();
+        checkpoint.save(checkpointFile);
+    };
+    // Paths may run for a long time without producing a test, so the exploration loop saves the
+    // checkpoints rather than the test callback.
+    depthFirstSearch.setCheckpointHook(CHECKPOINT_INTERVAL, saveCheckpoint);
+    auto callBack = [&testBackend](const FinalState &finalState) {
+        return testBackend.run(finalState);
+    };
+
+    if (std::filesystem::exists(checkpointFile)) {
+        auto checkpoint = Checkpoint::load(checkpointFile);
+        if (!checkpoint.has_value()) {
+            return;
+        }
+        testBackend.resumeTests(checkpoint.value().testCount, checkpoint.value().testFileSizes);
+        depthFirstSearch.resume(callBack, checkpoint.value());
+    } else {
+        depthFirstSearch.run(callBack);
+    }
+    if (::errorCount() == 0) {
+        saveCheckpoint(depthFirstSearch.getCheckpoint());
+    }
+}
+
 /// Analyse the results of the symbolic execution and generate diagnostic messages.
 int postProcess(const TestgenOptions &testgenOptions, const TestBackEnd &testBackend) {
     // Do not print this warning if assertion mode is enabled.
@@ -88,9 +142,7 @@ std::optional<AbstractTestList> generateAndCollectAbstractTests(
 
     // Define how to handle the final state for each test. This is target defined.
     // We delegate execution to the symbolic executor.
-    symbolicExecutor->run([testBackend](auto &&finalState) {
-        return testBackend->run(std::forward<decltype(finalState)>(finalState));
-    });
+    runSymbolicExecutor(testgenOptions, *symbolicExecutor, *testBackend);
     auto result = postProcess(testgenOptions, *testBackend);
     if (result != EXIT_SUCCESS) {
         return std::nullopt;
@@ -122,9 +174,17 @@ int generateAndWriteAbstractTests(const TestgenOptions &testgenOptions,
         testPath = testDir / testPath;
     }
 
+    // Keep the tests of different shards apart.
+    if (testgenOptions.numShards > 1) {
+        testPath += "_shard" + std::to_string(testgenOptions.shardIndex);
+    }
+
     // The test name is the stem of the output base path.
     TestBackendConfiguration testBackendConfiguration{testPath.c_str(), testgenOptions.maxTests,
                                                       testPath, testgenOptions.seed};
+    testBackendConfiguration.asyncTestWriter = testgenOptions.asyncTestWriter;
+    testBackendConfiguration.compressTests = testgenOptions.compressTests;
+    testBackendConfiguration.numTestFiles = testgenOptions.numTestFiles;
 
     // Need to declare the solver here to ensure its lifetime.
     Z3Solver solver;
@@ -136,9 +196,8 @@ int generateAndWriteAbstractTests(const TestgenOptions &testgenOptions,
 
     // Define how to handle the final state for each test. This is target defined.
     // We delegate execution to the symbolic executor.
-    symbolicExecutor->run([testBackend](auto &&finalState) {
-        return testBackend->run(std::forward<decltype(finalState)>(finalState));
-    });
+    runSymbolicExecutor(testgenOptions, *symbolicExecutor, *testBackend);
+    testBackend->flushTests();
     return postProcess(testgenOptions, *testBackend);
 }
 
@@ -175,6 +234,9 @@ std::optional<AbstractTestList> generateTestsImpl(std::optional<std::string_view
         ::error("Failed to run the compiler.");
         return std::nullopt;
     }
+    // Only the compiled program goes to the IR arena of the caller, if any; the states
+    // explored below go to the garbage-collected heap.
+    Util::ArenaScope toolAllocations(nullptr);
 
     const auto *testgenCompilerResult =
         compilerResultOpt.value().get().checkedTo<TestgenCompilerResult>();
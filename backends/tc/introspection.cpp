@@ -16,6 +16,8 @@ and limitations under the License.
 
 #include "introspection.h"
 
+#include "lib/json_writer.h"
+
 /// This file defines functions for the pass to generate the introspection file
 
 namespace TC {
@@ -277,11 +279,23 @@ const Util::JsonObject *IntrospectionGenerator::genIntrospectionJson() {
 }
 
 bool IntrospectionGenerator::serializeIntrospectionJson(std::ostream &destination) {
-    auto *json = genIntrospectionJson();
+    struct IntrospectionInfo introspec;
+    collectTableInfo();
     if (::errorCount() > 0) {
         return false;
     }
-    json->serialize(destination);
+    introspec.initIntrospectionInfo(tcPipeline);
+    // Stream the tables one at a time instead of building the whole introspection tree.
+    Util::JsonWriter writer(destination);
+    writer.beginObject();
+    writer.field("schema_version", introspec.schemaVersion);
+    writer.field("pipeline_name", introspec.pipelineName);
+    writer.key("tables").beginArray();
+    for (auto table : tablesInfo) {
+        writer.value(genTableInfo(table));
+    }
+    writer.endArray();
+    writer.endObject();
     return true;
 }
 
@@ -20,6 +20,7 @@ and limitations under the License.
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/frontend.h"
 #include "ir/ir.h"
+#include "lib/arena.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/gc.h"
@@ -31,6 +32,7 @@ and limitations under the License.
 
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
+    Util::IRArena irArena;
     AutoCompileContext autoTCContext(new TC::TCContext);
     auto &options = TC::TCContext::get().options();
     options.langVersion = TC::TCOptions::FrontendVersion::P4_16;
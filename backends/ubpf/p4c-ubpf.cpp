@@ -29,6 +29,7 @@ limitations under the License.
 #include "fstream"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
 #include "lib/crash.h"
 #include "lib/exceptions.h"
 #include "lib/gc.h"
@@ -66,6 +67,7 @@ void compile(EbpfOptions &options) {
 
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
+    Util::IRArena irArena;
     setup_signals();
 
     AutoCompileContext autoEbpfContext(new EbpfContext);
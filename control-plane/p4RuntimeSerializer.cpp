@@ -18,14 +18,20 @@ limitations under the License.
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
+#include <google/protobuf/util/type_resolver_util.h>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -42,6 +48,7 @@ limitations under the License.
 // and tableNeedsPriority implementations.
 #include "control-plane/bytestrings.h"
 #include "control-plane/flattenHeader.h"
+#include "control-plane/protobufJson.h"
 #include "frontends/common/options.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/coreLibrary.h"
@@ -53,8 +60,11 @@ limitations under the License.
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
+#include "ir/pass_manager.h"
+#include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
+#include "lib/worker_pool.h"
 #include "p4RuntimeAnnotations.h"
 #include "p4RuntimeArchHandler.h"
 #include "p4RuntimeArchStandard.h"
@@ -116,18 +126,26 @@ static bool writeJsonTo(const Message &message, std::ostream *destination,
     using namespace google::protobuf::util;
     CHECK_NULL(destination);
 
-    std::string output;
-    if (!MessageToJsonString(message, &output, options).ok()) {
-        ::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to JSON");
-        return false;
-    }
-
-    *destination << output;
-    if (!destination->good()) {
-        ::error(ErrorType::ERR_IO, "Failed to write JSON protobuf message to the output");
-        return false;
+    if (ControlPlaneAPI::supportsProtobufJson(message.GetDescriptor(), options)) {
+        if (!ControlPlaneAPI::writeProtobufJson(message, *destination, options)) return false;
+    } else {
+        // This is what MessageToJsonString does, but the JSON is written straight to the
+        // destination: for large lists of table entries it is several times the size of the
+        // binary message.
+        static constexpr const char *typeUrlPrefix = "type.googleapis.com";
+        const auto *descriptor = message.GetDescriptor();
+        std::unique_ptr<TypeResolver> resolver(
+            NewTypeResolverForDescriptorPool(typeUrlPrefix, descriptor->file()->pool()));
+        std::string binary = message.SerializeAsString();
+        google::protobuf::io::ArrayInputStream input(binary.data(),
+                                                     static_cast<int>(binary.size()));
+        google::protobuf::io::OstreamOutputStream output(destination);
+        auto typeUrl = std::string(typeUrlPrefix) + "/" + descriptor->full_name();
+        if (!BinaryToJsonStream(resolver.get(), typeUrl, &input, &output, options).ok())
+            return false;
     }
 
+    if (!destination->good()) return false;
     destination->flush();
     return true;
 }
@@ -137,30 +155,40 @@ static bool writeJsonTo(const Message &message, std::ostream *destination,
 static bool writeTextTo(const Message &message, std::ostream *destination) {
     CHECK_NULL(destination);
 
-    // According to the protobuf documentation, it would be better to use Print
-    // with a FileOutputStream object for performance reasons. However all we
-    // have here is a std::ostream and performance is not a concern.
-    std::string output;
     google::protobuf::TextFormat::Printer textPrinter;
     // set to expand google.protobuf.Any payloads
     textPrinter.SetExpandAny(true);
     *destination << "# proto-file: " << message.GetDescriptor()->file()->name() << "\n";
     *destination << "# proto-message: " << message.GetTypeName() << "\n\n";
-    if (!textPrinter.PrintToString(message, &output)) {
-        ::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
-        return false;
-    }
-
-    *destination << output;
-    if (!destination->good()) {
-        ::error(ErrorType::ERR_IO, "Failed to write text protobuf message to the output");
-        return false;
+    {
+        // The message is printed straight to the destination rather than to a string first,
+        // which matters for large lists of table entries.
+        google::protobuf::io::OstreamOutputStream output(destination);
+        if (!textPrinter.Print(message, &output)) return false;
     }
 
+    if (!destination->good()) return false;
     destination->flush();
     return true;
 }
 
+/// Serialize the protobuf @message to @destination in @format. Failures are not
+/// reported, but left to the caller, so that messages can be serialized on
+/// worker threads.
+static bool write(const Message &message, P4RuntimeFormat format, std::ostream *destination,
+                  const JsonPrintOptions &options) {
+    switch (format) {
+        case P4RuntimeFormat::BINARY:
+            return writeTo(message, destination);
+        case P4RuntimeFormat::JSON:
+            return writeJsonTo(message, destination, options);
+        case P4RuntimeFormat::TEXT_PROTOBUF:
+        case P4RuntimeFormat::TEXT:
+            return writeTextTo(message, destination);
+    }
+    return false;
+}
+
 }  // namespace writers
 
 /// The information about a default action which is needed to serialize it.
@@ -994,6 +1022,18 @@ class P4RuntimeEntriesConverter {
     explicit P4RuntimeEntriesConverter(const P4RuntimeSymbolTable &symbols)
         : entries(new p4v1::WriteRequest), symbols(symbols) {}
 
+    /// The width and match type of a field of a table key.
+    struct KeyField {
+        int width;
+        cstring matchType;
+    };
+
+    /// What is needed to serialize a call of an action in a table entry.
+    struct ActionInfo {
+        p4rt_id_t id = 0;
+        std::vector<int> parameterWidths;
+    };
+
     /// @return the P4Runtime WriteRequest message generated by this analyzer.
     const p4v1::WriteRequest *getEntries() const {
         BUG_CHECK(entries != nullptr, "Didn't produce a P4Runtime WriteRequest object?");
@@ -1015,13 +1055,18 @@ class P4RuntimeEntriesConverter {
 
         int entryPriority = entriesList->entries.size();
         auto needsPriority = tableNeedsPriority(table, refMap);
+        // The key of every entry has the same fields, which are looked up only once.
+        std::vector<KeyField> keyFields;
+        for (auto tableKey : table->getKey()->keyElements)
+            keyFields.push_back({getTypeWidth(tableKey->expression->type, typeMap),
+                                 getKeyMatchType(tableKey, refMap)});
         for (auto e : entriesList->entries) {
             auto protoUpdate = entries->add_updates();
             protoUpdate->set_type(p4v1::Update::INSERT);
             auto protoEntity = protoUpdate->mutable_entity();
             auto protoEntry = protoEntity->mutable_table_entry();
             protoEntry->set_table_id(tableId);
-            addMatchKey(protoEntry, table, e->getKeys(), refMap, typeMap);
+            addMatchKey(protoEntry, keyFields, e->getKeys(), typeMap);
             addAction(protoEntry, e->getAction(), refMap, typeMap);
             protoEntry->set_is_const(isConst || e->isConst);
             if (needsPriority) {
@@ -1072,7 +1117,7 @@ class P4RuntimeEntriesConverter {
     }
 
     void addAction(p4v1::TableEntry *protoEntry, const IR::Expression *actionRef,
-                   ReferenceMap *refMap, TypeMap *typeMap) const {
+                   ReferenceMap *refMap, TypeMap *typeMap) {
         if (!actionRef->is<IR::MethodCallExpression>()) {
             ::error(ErrorType::ERR_INVALID, "%1%: invalid action in entries list", actionRef);
             return;
@@ -1081,18 +1126,25 @@ class P4RuntimeEntriesConverter {
         auto method = actionCall->method->to<IR::PathExpression>()->path;
         auto decl = refMap->getDeclaration(method, true);
         auto actionDecl = decl->to<IR::P4Action>();
-        auto actionName = actionDecl->controlPlaneName();
-        auto actionId = symbols.getId(P4RuntimeSymbolType::P4RT_ACTION(), actionName);
+        auto it = actions.find(actionDecl);
+        if (it == actions.end()) {
+            ActionInfo info;
+            info.id = symbols.getId(P4RuntimeSymbolType::P4RT_ACTION(),
+                                    actionDecl->controlPlaneName());
+            for (auto parameter : actionDecl->parameters->parameters)
+                info.parameterWidths.push_back(getTypeWidth(parameter->type, typeMap));
+            it = actions.emplace(actionDecl, std::move(info)).first;
+        }
+        const auto &actionInfo = it->second;
 
         auto protoAction = protoEntry->mutable_action()->mutable_action();
-        protoAction->set_action_id(actionId);
+        protoAction->set_action_id(actionInfo.id);
         int parameterIndex = 0;
         int parameterId = 1;
         for (auto arg : *actionCall->arguments) {
             auto protoParam = protoAction->add_params();
             protoParam->set_param_id(parameterId++);
-            auto parameter = actionDecl->parameters->parameters.at(parameterIndex++);
-            int width = getTypeWidth(parameter->type, typeMap);
+            int width = actionInfo.parameterWidths.at(parameterIndex++);
             auto ei = EnumInstance::resolve(arg->expression, typeMap);
             if (arg->expression->is<IR::Constant>()) {
                 auto value = stringRepr(arg->expression->to<IR::Constant>(), width);
@@ -1112,15 +1164,12 @@ class P4RuntimeEntriesConverter {
         }
     }
 
-    void addMatchKey(p4v1::TableEntry *protoEntry, const IR::P4Table *table,
-                     const IR::ListExpression *keyset, ReferenceMap *refMap,
-                     TypeMap *typeMap) const {
+    void addMatchKey(p4v1::TableEntry *protoEntry, const std::vector<KeyField> &keyFields,
+                     const IR::ListExpression *keyset, TypeMap *typeMap) const {
         int keyIndex = 0;
         int fieldId = 1;
         for (auto k : keyset->components) {
-            auto tableKey = table->getKey()->keyElements.at(keyIndex++);
-            auto keyWidth = getTypeWidth(tableKey->expression->type, typeMap);
-            auto matchType = getKeyMatchType(tableKey, refMap);
+            const auto &[keyWidth, matchType] = keyFields.at(keyIndex++);
 
             if (matchType == P4CoreLibrary::instance().exactMatch.name) {
                 addExact(protoEntry, fieldId++, k, keyWidth, typeMap);
@@ -1343,6 +1392,8 @@ class P4RuntimeEntriesConverter {
     p4v1::WriteRequest *entries;
     /// The symbols used in the API and their ids.
     const P4RuntimeSymbolTable &symbols;
+    /// The actions called by the entries so far.
+    std::unordered_map<const IR::P4Action *, ActionInfo> actions;
 };
 
 /* static */ P4RuntimeAPI P4RuntimeAnalyzer::analyze(const IR::P4Program *program,
@@ -1452,40 +1503,14 @@ P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program
 void P4RuntimeAPI::serializeP4InfoTo(std::ostream *destination, P4RuntimeFormat format) const {
     using namespace ControlPlaneAPI;
 
-    bool success = true;
-    // Write the serialization out in the requested format.
-    switch (format) {
-        case P4RuntimeFormat::BINARY:
-            success = writers::writeTo(*p4Info, destination);
-            break;
-        case P4RuntimeFormat::JSON:
-            success = writers::writeJsonTo(*p4Info, destination, jsonPrintOptions);
-            break;
-        case P4RuntimeFormat::TEXT_PROTOBUF:
-        case P4RuntimeFormat::TEXT:
-            success = writers::writeTextTo(*p4Info, destination);
-            break;
-    }
+    bool success = writers::write(*p4Info, format, destination, jsonPrintOptions);
     if (!success) ::error(ErrorType::ERR_IO, "Failed to serialize the P4Runtime API to the output");
 }
 
 void P4RuntimeAPI::serializeEntriesTo(std::ostream *destination, P4RuntimeFormat format) const {
     using namespace ControlPlaneAPI;
 
-    bool success = true;
-    // Write the serialization out in the requested format.
-    switch (format) {
-        case P4RuntimeFormat::BINARY:
-            success = writers::writeTo(*entries, destination);
-            break;
-        case P4RuntimeFormat::JSON:
-            success = writers::writeJsonTo(*entries, destination, jsonPrintOptions);
-            break;
-        case P4RuntimeFormat::TEXT_PROTOBUF:
-        case P4RuntimeFormat::TEXT:
-            success = writers::writeTextTo(*entries, destination);
-            break;
-    }
+    bool success = writers::write(*entries, format, destination, jsonPrintOptions);
     if (!success)
         ::error(ErrorType::ERR_IO,
                 "Failed to serialize the P4Runtime static table entries to the output");
@@ -1549,29 +1574,90 @@ void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const IR::P4Program *prog
     serializeP4RuntimeIfRequired(p4Runtime, options);
 }
 
+namespace {
+
+/// One serialization of a P4Runtime message, which is written to all the files
+/// requesting the message in the same format.
+struct P4RuntimeOutput {
+    const google::protobuf::Message *message;
+    P4RuntimeFormat format;
+    /// Reported if the serialization fails.
+    const char *failure;
+    /// The names of the files written to @destinations.
+    std::vector<cstring> files;
+    std::vector<std::ostream *> destinations;
+    bool success = true;
+};
+
+}  // namespace
+
+/// Opens the @files, which request @message in @formats, and adds them to
+/// @outputs. TEXT and TEXT_PROTOBUF are the same output.
+static void addOutputs(std::vector<P4RuntimeOutput> &outputs,
+                       const google::protobuf::Message *message, const char *failure,
+                       const char *kind, const std::vector<cstring> &files,
+                       const std::vector<P4RuntimeFormat> &formats) {
+    for (unsigned i = 0; i < files.size(); i++) {
+        cstring file = files.at(i);
+        P4RuntimeFormat format = formats.at(i);
+        if (format == P4RuntimeFormat::TEXT) format = P4RuntimeFormat::TEXT_PROTOBUF;
+        std::ostream *out = openFile(file, false);
+        if (!out) {
+            ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime %1% file: %2%", kind, file);
+            continue;
+        }
+        auto it = std::find_if(outputs.begin(), outputs.end(), [&](const P4RuntimeOutput &o) {
+            return o.message == message && o.format == format;
+        });
+        if (it == outputs.end()) {
+            outputs.push_back({message, format, failure, {}, {}});
+            it = std::prev(outputs.end());
+        }
+        it->files.push_back(file);
+        it->destinations.push_back(out);
+    }
+}
+
+/// Serializes the message of @output once, into its first file, and copies that
+/// file to the other destinations, so that the serialization is never held in
+/// memory. This only does protobuf and stream work, and does not report errors,
+/// so it can run on a worker thread.
+static void writeOutput(P4RuntimeOutput &output,
+                        const google::protobuf::util::JsonPrintOptions &options) {
+    using namespace ControlPlaneAPI;
+
+    output.success =
+        writers::write(*output.message, output.format, output.destinations.front(), options);
+    if (!output.success || output.destinations.size() == 1) return;
+    std::ifstream first(output.files.front(), std::ios::binary);
+    if (!first.is_open()) {
+        output.success = false;
+        return;
+    }
+    for (size_t i = 1; i < output.destinations.size(); i++) {
+        auto *destination = output.destinations.at(i);
+        first.clear();
+        first.seekg(0);
+        // Copying an empty file would set the failbit of the destination.
+        if (first.peek() != std::ifstream::traits_type::eof()) *destination << first.rdbuf();
+        destination->flush();
+        if (!destination->good()) output.success = false;
+    }
+}
+
 void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI &p4Runtime,
                                                        const CompilerOptions &options) {
     std::vector<cstring> files;
     std::vector<P4::P4RuntimeFormat> formats;
+    std::vector<P4RuntimeOutput> outputs;
 
     if (!options.p4RuntimeFile.isNullOrEmpty()) {
         files.push_back(options.p4RuntimeFile);
         formats.push_back(options.p4RuntimeFormat);
     }
     if (!parseFileNames(options.p4RuntimeFiles, files, formats)) return;
-
-    if (!files.empty()) {
-        for (unsigned i = 0; i < files.size(); i++) {
-            cstring file = files.at(i);
-            P4::P4RuntimeFormat format = formats.at(i);
-            std::ostream *out = openFile(file, false);
-            if (!out) {
-                ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime API file: %1%", file);
-                continue;
-            }
-            p4Runtime.serializeP4InfoTo(out, format);
-        }
-    }
+    addOutputs(outputs, p4Runtime.p4Info, "Failed to serialize the P4Runtime API to the output",
+               "API", files, formats);
 
     // Do the same for the entries files
     files.clear();
@@ -1580,21 +1666,20 @@ void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI &p4Run
         files.push_back(options.p4RuntimeEntriesFile);
         formats.push_back(options.p4RuntimeFormat);
     }
+    if (parseFileNames(options.p4RuntimeEntriesFiles, files, formats))
+        addOutputs(outputs, p4Runtime.entries,
+                   "Failed to serialize the P4Runtime static table entries to the output",
+                   "static entries", files, formats);
+
+    // Every message is serialized once per format, and the formats are independent
+    // of each other. They are serialized in parallel only in MULTITHREAD builds.
+    unsigned threads = std::min<size_t>(PassManager::getParallelism(), outputs.size());
+    Util::WorkerPool::get().run(outputs.size(), threads, [&](size_t i) {
+        writeOutput(outputs[i], p4Runtime.jsonPrintOptions);
+    });
 
-    if (!parseFileNames(options.p4RuntimeEntriesFiles, files, formats)) return;
-    if (!files.empty()) {
-        for (unsigned i = 0; i < files.size(); i++) {
-            cstring file = files.at(i);
-            P4::P4RuntimeFormat format = formats.at(i);
-            std::ostream *out = openFile(file, false);
-            if (!out) {
-                ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime static entries file: %1%",
-                        options.p4RuntimeEntriesFile);
-                continue;
-            }
-            p4Runtime.serializeEntriesTo(out, format);
-        }
-    }
+    for (const auto &output : outputs)
+        if (!output.success) ::error(ErrorType::ERR_IO, output.failure);
 }
 
 P4RuntimeSerializer::P4RuntimeSerializer() {
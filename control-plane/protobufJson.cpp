@@ -0,0 +1,376 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "protobufJson.h"
+
+#include <algorithm>
+#include <ostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/struct.pb.h>
+#pragma GCC diagnostic pop
+
+namespace P4 {
+
+namespace ControlPlaneAPI {
+
+namespace {
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::util::JsonPrintOptions;
+
+/// @returns true if messages of type @descriptor, including the messages they contain, can be
+/// written by JsonPrinter.  @visited holds the types which were already checked.
+bool isSupported(const Descriptor *descriptor, std::set<const Descriptor *> &visited) {
+    if (!visited.insert(descriptor).second) return true;
+    // Any is converted by the protobuf library; the other well-known types like Timestamp
+    // have JSON representations of their own.
+    if (descriptor->full_name() == "google.protobuf.Any") return true;
+    if (descriptor->file()->package() == "google.protobuf") return false;
+    if (descriptor->extension_range_count() > 0) return false;
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+        const auto *field = descriptor->field(i);
+        switch (field->cpp_type()) {
+            case FieldDescriptor::CPPTYPE_FLOAT:
+            case FieldDescriptor::CPPTYPE_DOUBLE:
+                return false;
+            case FieldDescriptor::CPPTYPE_MESSAGE:
+                if (!isSupported(field->message_type(), visited)) return false;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+/// @returns true if every character of @value is ASCII.
+bool isAscii(const std::string &value) {
+    for (unsigned char c : value)
+        if (c >= 0x80) return false;
+    return true;
+}
+
+/// Prints messages like MessageToJsonString: fields which are set appear in the order of their
+/// numbers, 64-bit integers are quoted, enums are printed by name, bytes in base64 and maps as
+/// objects.  With whitespace, every level is indented by one more space.
+class JsonPrinter {
+ public:
+    JsonPrinter(std::ostream &destination, const JsonPrintOptions &options)
+        : destination(destination), options(options) {}
+
+    /// Prints @message, followed by a newline if whitespace is added.
+    /// @returns false if a value could not be converted.
+    bool print(const Message &message) {
+        printMessage(message, 0);
+        if (options.add_whitespace) buffer += '\n';
+        flush();
+        return success;
+    }
+
+ private:
+    /// The output is collected here, and written to the destination in large blocks.
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+    std::ostream &destination;
+    const JsonPrintOptions &options;
+    std::string buffer;
+    std::string scratch;
+    bool success = true;
+    /// The fields of each message type printed so far, ordered by number.
+    std::unordered_map<const Descriptor *, std::vector<const FieldDescriptor *>> fieldsOf;
+
+    void flush() {
+        destination.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    void newline(int depth) {
+        if (!options.add_whitespace) return;
+        buffer += '\n';
+        buffer.append(depth, ' ');
+    }
+
+    const std::vector<const FieldDescriptor *> &getFields(const Descriptor *descriptor) {
+        auto it = fieldsOf.find(descriptor);
+        if (it != fieldsOf.end()) return it->second;
+        auto &fields = fieldsOf[descriptor];
+        for (int i = 0; i < descriptor->field_count(); ++i) fields.push_back(descriptor->field(i));
+        std::sort(fields.begin(), fields.end(),
+                  [](const FieldDescriptor *a, const FieldDescriptor *b) {
+                      return a->number() < b->number();
+                  });
+        return fields;
+    }
+
+    /// Appends @json, as printed at the top level by the protobuf library, nested @depth
+    /// levels deep.
+    void appendNested(const std::string &json, int depth) {
+        size_t size = json.size();
+        if (size > 0 && json[size - 1] == '\n') size--;
+        for (size_t i = 0; i < size; ++i) {
+            buffer += json[i];
+            if (json[i] == '\n') buffer.append(depth, ' ');
+        }
+    }
+
+    void printMessage(const Message &message, int depth) {
+        const auto *descriptor = message.GetDescriptor();
+        if (descriptor->full_name() == "google.protobuf.Any") {
+            std::string json;
+            if (!google::protobuf::util::MessageToJsonString(message, &json, options).ok())
+                success = false;
+            appendNested(json, depth);
+            return;
+        }
+        const auto *reflection = message.GetReflection();
+        buffer += '{';
+        bool first = true;
+        for (const auto *field : getFields(descriptor)) {
+            int size = 0;
+            if (field->is_repeated()) {
+                size = reflection->FieldSize(message, field);
+                if (size == 0) continue;
+            } else if (!reflection->HasField(message, field)) {
+                continue;
+            }
+            if (!first) buffer += ',';
+            first = false;
+            newline(depth + 1);
+            buffer += '"';
+            buffer += options.preserve_proto_field_names ? field->name() : field->json_name();
+            buffer += options.add_whitespace ? "\": " : "\":";
+            if (!field->is_repeated()) {
+                printValue(message, field, -1, depth + 1);
+            } else if (field->is_map()) {
+                printMap(message, field, size, depth + 1);
+            } else {
+                buffer += '[';
+                for (int i = 0; i < size; ++i) {
+                    if (i > 0) buffer += ',';
+                    newline(depth + 2);
+                    printValue(message, field, i, depth + 2);
+                }
+                newline(depth + 1);
+                buffer += ']';
+            }
+        }
+        if (!first) newline(depth);
+        buffer += '}';
+        if (buffer.size() >= BUFFER_SIZE) flush();
+    }
+
+    /// Prints the @size entries of the map @field of @message as an object.  The entries are
+    /// visited in the same order as by the protobuf library.
+    void printMap(const Message &message, const FieldDescriptor *field, int size, int depth) {
+        const auto *reflection = message.GetReflection();
+        const auto *keyField = field->message_type()->map_key();
+        const auto *valueField = field->message_type()->map_value();
+        buffer += '{';
+        for (int i = 0; i < size; ++i) {
+            if (i > 0) buffer += ',';
+            newline(depth + 1);
+            const auto &entry = reflection->GetRepeatedMessage(message, field, i);
+            // Keys are always quoted, 64-bit integers and strings are anyway.
+            bool quote = keyField->cpp_type() == FieldDescriptor::CPPTYPE_INT32 ||
+                         keyField->cpp_type() == FieldDescriptor::CPPTYPE_UINT32 ||
+                         keyField->cpp_type() == FieldDescriptor::CPPTYPE_BOOL;
+            if (quote) buffer += '"';
+            printValue(entry, keyField, -1, depth + 1);
+            if (quote) buffer += '"';
+            buffer += options.add_whitespace ? ": " : ":";
+            printValue(entry, valueField, -1, depth + 1);
+        }
+        newline(depth);
+        buffer += '}';
+    }
+
+    /// Prints an integer which the protobuf library quotes.
+    template <typename T>
+    void printQuoted(T value) {
+        buffer += '"';
+        buffer += std::to_string(value);
+        buffer += '"';
+    }
+
+    /// Prints the value of the singular @field of @message if @index is negative, or else the
+    /// element @index of the repeated @field.
+    void printValue(const Message &message, const FieldDescriptor *field, int index, int depth) {
+        const auto *reflection = message.GetReflection();
+        bool repeated = index >= 0;
+        switch (field->cpp_type()) {
+            case FieldDescriptor::CPPTYPE_INT32:
+                buffer += std::to_string(repeated
+                                             ? reflection->GetRepeatedInt32(message, field, index)
+                                             : reflection->GetInt32(message, field));
+                break;
+            case FieldDescriptor::CPPTYPE_UINT32:
+                buffer += std::to_string(repeated
+                                             ? reflection->GetRepeatedUInt32(message, field, index)
+                                             : reflection->GetUInt32(message, field));
+                break;
+            case FieldDescriptor::CPPTYPE_INT64:
+                printQuoted(repeated ? reflection->GetRepeatedInt64(message, field, index)
+                                     : reflection->GetInt64(message, field));
+                break;
+            case FieldDescriptor::CPPTYPE_UINT64:
+                printQuoted(repeated ? reflection->GetRepeatedUInt64(message, field, index)
+                                     : reflection->GetUInt64(message, field));
+                break;
+            case FieldDescriptor::CPPTYPE_BOOL:
+                buffer += (repeated ? reflection->GetRepeatedBool(message, field, index)
+                                    : reflection->GetBool(message, field))
+                              ? "true"
+                              : "false";
+                break;
+            case FieldDescriptor::CPPTYPE_ENUM: {
+                int value = repeated ? reflection->GetRepeatedEnumValue(message, field, index)
+                                     : reflection->GetEnumValue(message, field);
+                const auto *enumValue = field->enum_type()->FindValueByNumber(value);
+                if (enumValue == nullptr || options.always_print_enums_as_ints) {
+                    buffer += std::to_string(value);
+                } else {
+                    buffer += '"';
+                    buffer += enumValue->name();
+                    buffer += '"';
+                }
+                break;
+            }
+            case FieldDescriptor::CPPTYPE_STRING: {
+                const auto &value =
+                    repeated ? reflection->GetRepeatedStringReference(message, field, index,
+                                                                      &scratch)
+                             : reflection->GetStringReference(message, field, &scratch);
+                if (field->type() == FieldDescriptor::TYPE_BYTES)
+                    printBase64(value);
+                else
+                    printString(value);
+                break;
+            }
+            case FieldDescriptor::CPPTYPE_MESSAGE:
+                printMessage(repeated ? reflection->GetRepeatedMessage(message, field, index)
+                                      : reflection->GetMessage(message, field),
+                             depth);
+                break;
+            default:
+                // Rejected by supportsProtobufJson.
+                success = false;
+                break;
+        }
+    }
+
+    /// Prints the string @value, escaped like the protobuf library does.
+    void printString(const std::string &value) {
+        if (!isAscii(value)) {
+            // Which code points are escaped, and how invalid UTF-8 is handled, is left to the
+            // protobuf library.
+            google::protobuf::Value json;
+            json.set_string_value(value);
+            std::string printed;
+            if (!google::protobuf::util::MessageToJsonString(json, &printed).ok()) success = false;
+            buffer += printed;
+            return;
+        }
+        static constexpr const char *hex = "0123456789abcdef";
+        buffer += '"';
+        for (char c : value) {
+            switch (c) {
+                case '"':
+                    buffer += "\\\"";
+                    break;
+                case '\\':
+                    buffer += "\\\\";
+                    break;
+                case '\b':
+                    buffer += "\\b";
+                    break;
+                case '\f':
+                    buffer += "\\f";
+                    break;
+                case '\n':
+                    buffer += "\\n";
+                    break;
+                case '\r':
+                    buffer += "\\r";
+                    break;
+                case '\t':
+                    buffer += "\\t";
+                    break;
+                default:
+                    if (c < 0x20 || c == '<' || c == '>' || c == 0x7f) {
+                        buffer += "\\u00";
+                        buffer += hex[(c >> 4) & 0xf];
+                        buffer += hex[c & 0xf];
+                    } else {
+                        buffer += c;
+                    }
+                    break;
+            }
+        }
+        buffer += '"';
+    }
+
+    /// Prints @value in padded base64.
+    void printBase64(const std::string &value) {
+        static constexpr const char *digits =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        buffer += '"';
+        size_t i = 0;
+        for (; i + 2 < value.size(); i += 3) {
+            unsigned bits = static_cast<unsigned char>(value[i]) << 16 |
+                            static_cast<unsigned char>(value[i + 1]) << 8 |
+                            static_cast<unsigned char>(value[i + 2]);
+            buffer += digits[bits >> 18];
+            buffer += digits[(bits >> 12) & 0x3f];
+            buffer += digits[(bits >> 6) & 0x3f];
+            buffer += digits[bits & 0x3f];
+        }
+        if (i < value.size()) {
+            unsigned bits = static_cast<unsigned char>(value[i]) << 16;
+            if (i + 1 < value.size()) bits |= static_cast<unsigned char>(value[i + 1]) << 8;
+            buffer += digits[bits >> 18];
+            buffer += digits[(bits >> 12) & 0x3f];
+            buffer += i + 1 < value.size() ? digits[(bits >> 6) & 0x3f] : '=';
+            buffer += '=';
+        }
+        buffer += '"';
+    }
+};
+
+}  // namespace
+
+bool supportsProtobufJson(const Descriptor *descriptor, const JsonPrintOptions &options) {
+    if (options.always_print_primitive_fields) return false;
+    std::set<const Descriptor *> visited;
+    return isSupported(descriptor, visited);
+}
+
+bool writeProtobufJson(const Message &message, std::ostream &destination,
+                       const JsonPrintOptions &options) {
+    return JsonPrinter(destination, options).print(message);
+}
+
+}  // namespace ControlPlaneAPI
+
+}  // namespace P4
@@ -0,0 +1,53 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef CONTROL_PLANE_PROTOBUFJSON_H_
+#define CONTROL_PLANE_PROTOBUFJSON_H_
+
+#include <iosfwd>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/message.h>
+#include <google/protobuf/util/json_util.h>
+#pragma GCC diagnostic pop
+
+namespace P4 {
+
+namespace ControlPlaneAPI {
+
+/// @returns true if writeProtobufJson can write messages of type @descriptor with @options.
+/// Messages which contain floating point fields, extensions or well-known types other than Any
+/// are not supported, nor is printing fields with default values.
+bool supportsProtobufJson(const google::protobuf::Descriptor *descriptor,
+                          const google::protobuf::util::JsonPrintOptions &options);
+
+/// Writes @message to @destination in the same JSON format as
+/// google::protobuf::util::MessageToJsonString with @options.  The message is walked directly
+/// with protobuf reflection, instead of being serialized to the binary format and converted
+/// through a type resolver, which makes this several times faster on large messages.  Only the
+/// rare values which need it, Any messages and non-ASCII strings, are converted by the protobuf
+/// library.  The type of @message must be supported, see supportsProtobufJson.
+/// @returns false if a value could not be converted; the output is then incomplete.
+bool writeProtobufJson(const google::protobuf::Message &message, std::ostream &destination,
+                       const google::protobuf::util::JsonPrintOptions &options);
+
+}  // namespace ControlPlaneAPI
+
+}  // namespace P4
+
+#endif  // CONTROL_PLANE_PROTOBUFJSON_H_
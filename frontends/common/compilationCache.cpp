@@ -0,0 +1,209 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "compilationCache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
+#include "lib/error.h"
+#include "lib/exename.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+#include "lib/stringify.h"
+
+namespace P4 {
+
+namespace {
+
+/// Hashes everything besides the preprocessed input that determines the results:
+/// the compiler binary itself (so that a rebuilt compiler misses the cache), its
+/// version, and the options as they were parsed, with their arguments.  The cache
+/// directory does not change the results, and the input is hashed by its contents.
+uint64_t hashConfiguration(ParserOptions &options) {
+    std::stringstream config;
+    const char *exe = exename();
+    struct stat st;
+    config << exe << '\n' << options.compilerVersion << '\n';
+    if (stat(exe, &st) == 0) config << st.st_size << ' ' << st.st_mtime << '\n';
+    for (const auto &[option, arg] : options.getProcessedOptions()) {
+        if (option == "--compilationCache") continue;
+        // Arguments may contain any character, so they are length-prefixed.
+        config << option << ' ' << (arg ? arg.size() : 0) << ':';
+        if (arg) config << arg;
+        config << '\n';
+    }
+    return Util::hash(config.str());
+}
+
+cstring entryPath(const ParserOptions &options, cstring suffix) {
+    return options.compilationCacheDir + "/" + options.compilationCacheKey + "." + suffix;
+}
+
+/// An entry starts with these bytes, the length of the snapshot that follows and
+/// its hash, so that truncated or damaged entries are detected before loading.
+constexpr char entryMagic[8] = {'P', '4', 'C', 'C', 'A', 'C', 'H', 'E'};
+struct EntryHeader {
+    char magic[sizeof(entryMagic)];
+    uint64_t size;
+    uint64_t checksum;
+};
+
+/// @returns the input sources @p program was parsed from, if any.
+const Util::InputSources *inputSources(const IR::P4Program *program) {
+    for (const auto *obj : program->objects)
+        if (obj->srcInfo.isValid()) return obj->srcInfo.getSources();
+    return nullptr;
+}
+
+/// Reads the entry at @p path into @p data, without its header.  @returns false on a
+/// miss; a damaged entry is not fatal, it is reported and treated as a miss.
+bool readEntry(cstring path, std::string &data) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        LOG1("Compilation cache miss: " << path);
+        return false;
+    }
+    std::string entry((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EntryHeader header;
+    if (entry.size() < sizeof(header)) {
+        ::warning(ErrorType::WARN_IGNORE, "ignoring truncated compilation cache entry %1%", path);
+        return false;
+    }
+    memcpy(&header, entry.data(), sizeof(header));
+    const char *payload = entry.data() + sizeof(header);
+    if (memcmp(header.magic, entryMagic, sizeof(entryMagic)) != 0 ||
+        header.size != entry.size() - sizeof(header) ||
+        header.checksum != Util::hash(payload, header.size)) {
+        ::warning(ErrorType::WARN_IGNORE, "ignoring damaged compilation cache entry %1%", path);
+        return false;
+    }
+    data = entry.substr(sizeof(header));
+    return true;
+}
+
+/// Writes @p data as the entry at @p path, unless the compilation reported any
+/// diagnostics.
+void writeEntry(const ParserOptions &options, cstring path, const std::string &data) {
+    if (::diagnosticCount() > 0) return;
+    mkdir(options.compilationCacheDir.c_str(), 0777);
+
+    // Write to a private file and rename it into place, so that concurrent
+    // compilations never see a partially written entry.
+    auto tmp = path + "." + Util::toString(getpid());
+    {
+        std::ofstream out(tmp.c_str(), std::ios::binary);
+        if (!out) {
+            LOG1("Cannot write compilation cache entry " << tmp);
+            return;
+        }
+        EntryHeader header;
+        memcpy(header.magic, entryMagic, sizeof(entryMagic));
+        header.size = data.size();
+        header.checksum = Util::hash(data.data(), data.size());
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(data.data(), data.size());
+        out.flush();
+        if (!out) {
+            out.close();
+            unlink(tmp.c_str());
+            return;
+        }
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) unlink(tmp.c_str());
+}
+
+bool enabled(const ParserOptions &options) {
+    return options.compilationCacheDir && options.compilationCacheKey;
+}
+
+}  // namespace
+
+std::string CompilationCache::readAll(FILE *in) {
+    std::string contents;
+    char buffer[1 << 16];
+    while (size_t size = fread(buffer, 1, sizeof(buffer), in)) contents.append(buffer, size);
+    return contents;
+}
+
+void CompilationCache::computeKey(ParserOptions &options, const std::string &input) {
+    if (!options.compilationCacheDir) return;
+    char key[40];
+    snprintf(key, sizeof(key), "%016llx%016llx",
+             static_cast<unsigned long long>(Util::hash(input)),
+             static_cast<unsigned long long>(hashConfiguration(options)));
+    options.compilationCacheKey = key;
+}
+
+const IR::P4Program *CompilationCache::lookup(const ParserOptions &options,
+                                              const IR::P4Program *parsed, cstring stage) {
+    if (!enabled(options) || !parsed) return nullptr;
+    auto path = entryPath(options, stage + ".p4ir");
+    std::string data;
+    if (!readEntry(path, data)) return nullptr;
+    BinaryLoader loader(data.data(), data.size(), inputSources(parsed));
+    std::string failure = "incompatible format";
+    const IR::P4Program *program = nullptr;
+    if (loader.isValid()) {
+        failure.clear();
+        program = loader.tryLoadNode<IR::P4Program>(failure);
+        if (program == nullptr && failure.empty()) failure = "no program";
+    }
+    if (program == nullptr) {
+        ::warning(ErrorType::WARN_IGNORE, "ignoring unusable compilation cache entry %1%: %2%",
+                  path, cstring(failure));
+        return nullptr;
+    }
+    LOG1("Compilation cache hit: " << path);
+    return program;
+}
+
+void CompilationCache::store(const ParserOptions &options, const IR::P4Program *program,
+                             cstring stage) {
+    if (!enabled(options) || !program) return;
+    std::stringstream snapshot;
+    {
+        BinaryWriter writer(snapshot);
+        writer.setInputSources(inputSources(program));
+        writer << program;
+    }
+    writeEntry(options, entryPath(options, stage + ".p4ir"), snapshot.str());
+}
+
+bool CompilationCache::lookupOutput(const ParserOptions &options, cstring name,
+                                    std::string &contents) {
+    if (!enabled(options)) return false;
+    auto path = entryPath(options, name);
+    if (!readEntry(path, contents)) return false;
+    LOG1("Compilation cache hit: " << path);
+    return true;
+}
+
+void CompilationCache::storeOutput(const ParserOptions &options, cstring name,
+                                   const std::string &contents) {
+    if (enabled(options)) writeEntry(options, entryPath(options, name), contents);
+}
+
+}  // namespace P4
@@ -0,0 +1,71 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef FRONTENDS_COMMON_COMPILATIONCACHE_H_
+#define FRONTENDS_COMMON_COMPILATIONCACHE_H_
+
+#include <cstdio>
+#include <string>
+
+#include "frontends/common/parser_options.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/// Content-addressed on-disk cache of compilation results, enabled by
+/// `--compilationCache dir`.  Entries are named after a hash of the preprocessed
+/// input, the compiler executable and version, and the options given on the command
+/// line, so any change to one of them misses the cache.  All the results of a
+/// compilation are stored under the same key, one entry per stage: binary IR
+/// snapshots of the program after the front end and after the mid end, and the
+/// contents of the files written by the back end.  Each entry is preceded by its
+/// length and checksum.  The input is still parsed on a hit: source positions are
+/// stored relative to it, so that diagnostics of later passes point into the input
+/// as usual.
+class CompilationCache {
+ public:
+    /// Computes the key of the current compilation from its preprocessed @p input.
+    static void computeKey(ParserOptions &options, const std::string &input);
+
+    /// @returns the program cached after @p stage of the current compilation, whose
+    /// input was parsed into @p parsed, or nullptr on a miss.  An entry that cannot be
+    /// used is reported as a warning and treated as a miss.
+    static const IR::P4Program *lookup(const ParserOptions &options,
+                                       const IR::P4Program *parsed,
+                                       cstring stage = "frontend");
+
+    /// Stores @p program as the result of @p stage of the current compilation.
+    /// Nothing is stored if the compilation reported any diagnostics, so that a
+    /// cache hit never hides a warning.
+    static void store(const ParserOptions &options, const IR::P4Program *program,
+                      cstring stage = "frontend");
+
+    /// Reads the cached back-end output @p name of the current compilation into
+    /// @p contents.  @returns false on a miss.
+    static bool lookupOutput(const ParserOptions &options, cstring name, std::string &contents);
+
+    /// Stores @p contents as the back-end output @p name of the current compilation,
+    /// under the same conditions as store().
+    static void storeOutput(const ParserOptions &options, cstring name,
+                            const std::string &contents);
+
+    /// @returns the remaining contents of @p in, which is left open.
+    static std::string readAll(FILE *in);
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_COMPILATIONCACHE_H_ */
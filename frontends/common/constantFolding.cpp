@@ -16,8 +16,11 @@ limitations under the License.
 
 #include "constantFolding.h"
 
+#include <algorithm>
+
 #include "frontends/common/options.h"
 #include "frontends/p4/enumInstance.h"
+#include "ir/hash_cons.h"
 #include "lib/big_int_util.h"
 #include "lib/log.h"
 
@@ -156,7 +159,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Declaration_Constant *d) {
                     ::error(ErrorType::ERR_TYPE_ERROR, "%1%: initializer has wrong type %2%", d,
                             cst->type);
                 else if (cst->type->is<IR::Type_InfInt>())
-                    init = new IR::Constant(init->srcInfo, d->type, cst->value, cst->base);
+                    init = IR::HashCons::constant(init->srcInfo, d->type, cst->value, cst->base);
             } else if (!d->type->is<IR::Type_InfInt>()) {
                 // Don't fold this yet, we can't evaluate the cast.
                 return d;
@@ -195,6 +198,14 @@ const IR::Node *DoConstantFolding::preorder(IR::AssignmentStatement *statement)
     return statement;
 }
 
+const IR::Node *DoConstantFolding::preorder(IR::EntriesList *list) {
+    // Tables may have very many entries, and entries made only of literals have nothing to fold.
+    if (std::all_of(list->entries.begin(), list->entries.end(),
+                    [](const IR::Entry *entry) { return entry->isLiteral(); }))
+        prune();
+    return list;
+}
+
 const IR::Node *DoConstantFolding::preorder(IR::ArrayIndex *e) {
     visit(e->left);
     bool save = assignmentTarget;
@@ -261,7 +272,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Cmpl *e) {
     }
 
     big_int value = ~cst->value;
-    return new IR::Constant(cst->srcInfo, t, value, cst->base, true);
+    return IR::HashCons::constant(cst->srcInfo, t, value, cst->base, true);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Neg *e) {
@@ -274,7 +285,8 @@ const IR::Node *DoConstantFolding::postorder(IR::Neg *e) {
         return e;
     }
     const IR::Type *t = op->type;
-    if (t->is<IR::Type_InfInt>()) return new IR::Constant(cst->srcInfo, t, -cst->value, cst->base);
+    if (t->is<IR::Type_InfInt>())
+        return IR::HashCons::constant(cst->srcInfo, t, -cst->value, cst->base);
 
     auto tb = t->to<IR::Type_Bits>();
     if (tb == nullptr) {
@@ -283,7 +295,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Neg *e) {
     }
 
     big_int value = -cst->value;
-    return new IR::Constant(cst->srcInfo, t, value, cst->base, true);
+    return IR::HashCons::constant(cst->srcInfo, t, value, cst->base, true);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::UPlus *e) {
@@ -300,7 +312,7 @@ const IR::Node *DoConstantFolding::postorder(IR::UPlus *e) {
 
 const IR::Constant *DoConstantFolding::cast(const IR::Constant *node, unsigned base,
                                             const IR::Type_Bits *type) const {
-    return new IR::Constant(node->srcInfo, type, node->value, base);
+    return IR::HashCons::constant(node->srcInfo, type, node->value, base);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Add *e) {
@@ -401,14 +413,14 @@ const IR::Node *DoConstantFolding::compare(const IR::Operation_Binary *e) {
             return e;
         }
         bool bresult = (left->value == right->value) == eqTest;
-        return new IR::BoolLiteral(e->srcInfo, IR::Type_Boolean::get(), bresult);
+        return IR::HashCons::boolLiteral(e->srcInfo, bresult);
     } else if (typesKnown) {
         auto le = EnumInstance::resolve(eleft, typeMap);
         auto re = EnumInstance::resolve(eright, typeMap);
         if (le != nullptr && re != nullptr) {
             BUG_CHECK(le->type == re->type, "%1%: different enum types in comparison", e);
             bool bresult = (le->name == re->name) == eqTest;
-            return new IR::BoolLiteral(e->srcInfo, IR::Type_Boolean::get(), bresult);
+            return IR::HashCons::boolLiteral(e->srcInfo, bresult);
         }
 
         auto llist = eleft->to<IR::ListExpression>();
@@ -432,7 +444,7 @@ const IR::Node *DoConstantFolding::compare(const IR::Operation_Binary *e) {
                 if (boolLit == nullptr) return e;
                 if (boolLit->value != eqTest) return boolLit;
             }
-            return new IR::BoolLiteral(e->srcInfo, IR::Type_Boolean::get(), eqTest);
+            return IR::HashCons::boolLiteral(e->srcInfo, eqTest);
         }
     }
 
@@ -522,9 +534,9 @@ const IR::Node *DoConstantFolding::binary(const IR::Operation_Binary *e,
     }
 
     if (e->is<IR::Operation_Relation>())
-        return new IR::BoolLiteral(e->srcInfo, IR::Type_Boolean::get(), value != 0);
+        return IR::HashCons::boolLiteral(e->srcInfo, value != 0);
     else
-        return new IR::Constant(e->srcInfo, resultType, value, left->base, true);
+        return IR::HashCons::constant(e->srcInfo, resultType, value, left->base, true);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::LAnd *e) {
@@ -539,7 +551,7 @@ const IR::Node *DoConstantFolding::postorder(IR::LAnd *e) {
     if (lcst->value) {
         return e->right;
     }
-    return new IR::BoolLiteral(left->srcInfo, IR::Type_Boolean::get(), false);
+    return IR::HashCons::boolLiteral(left->srcInfo, false);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::LOr *e) {
@@ -554,7 +566,7 @@ const IR::Node *DoConstantFolding::postorder(IR::LOr *e) {
     if (!lcst->value) {
         return e->right;
     }
-    return new IR::BoolLiteral(left->srcInfo, IR::Type_Boolean::get(), true);
+    return IR::HashCons::boolLiteral(left->srcInfo, true);
 }
 
 static bool overflowWidth(const IR::Node *node, int width) {
@@ -617,7 +629,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Slice *e) {
     mask = (mask << (m - l + 1)) - 1;
     value = value & mask;
     auto resultType = IR::Type_Bits::get(m - l + 1);
-    return new IR::Constant(e->srcInfo, resultType, value, cbase->base, true);
+    return IR::HashCons::constant(e->srcInfo, resultType, value, cbase->base, true);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Member *e) {
@@ -629,7 +641,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Member *e) {
     if (type->is<IR::Type_Stack>() && e->member == IR::Type_Stack::arraySize) {
         auto st = type->to<IR::Type_Stack>();
         auto size = st->getSize();
-        return new IR::Constant(st->size->srcInfo, origtype, size);
+        return IR::HashCons::constant(st->size->srcInfo, origtype, size);
     }
 
     auto expr = getConstant(e->expr);
@@ -694,7 +706,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Concat *e) {
     if (overflowWidth(e, resultType->width_bits())) return e;
     big_int value =
         Util::shift_left(left->value, static_cast<unsigned>(rt->width_bits())) + right->value;
-    return new IR::Constant(e->srcInfo, resultType, value, left->base);
+    return IR::HashCons::constant(e->srcInfo, resultType, value, left->base);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::LNot *e) {
@@ -706,7 +718,7 @@ const IR::Node *DoConstantFolding::postorder(IR::LNot *e) {
         ::error(ErrorType::ERR_EXPECTED, "%1%: Expected a boolean value", op);
         return e;
     }
-    return new IR::BoolLiteral(cst->srcInfo, IR::Type_Boolean::get(), !cst->value);
+    return IR::HashCons::boolLiteral(cst->srcInfo, !cst->value);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Mux *e) {
@@ -778,7 +790,7 @@ const IR::Node *DoConstantFolding::shift(const IR::Operation_Binary *e) {
         value = Util::shift_left(value, shift);
     else
         value = Util::shift_right(value, shift);
-    return new IR::Constant(e->srcInfo, left->type, value, cl->base);
+    return IR::HashCons::constant(e->srcInfo, left->type, value, cl->base);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Cast *e) {
@@ -800,7 +812,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Cast *e) {
                 error(ErrorType::ERR_INVALID, "%1%: Cannot cast %1% directly to %2% (use bit<1>)",
                       arg, type);
             int v = arg->value ? 1 : 0;
-            return new IR::Constant(e->srcInfo, type, v, 10);
+            return IR::HashCons::constant(e->srcInfo, type, v, 10);
         } else if (expr->is<IR::Member>()) {
             auto ei = EnumInstance::resolve(expr, typeMap);
             if (ei == nullptr) return e;
@@ -818,7 +830,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Cast *e) {
                         ctype);
                 return e;
             }
-            return new IR::Constant(e->srcInfo, etype, constant->value, constant->base);
+            return IR::HashCons::constant(e->srcInfo, etype, constant->value, constant->base);
         }
     } else if (etype->is<IR::Type_Boolean>()) {
         if (expr->is<IR::BoolLiteral>()) return expr;
@@ -846,7 +858,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Cast *e) {
                 ::error(ErrorType::ERR_INVALID, "%1%: Only 0 and 1 can be cast to booleans", e);
                 return e;
             }
-            return new IR::BoolLiteral(e->srcInfo, IR::Type_Boolean::get(), v == 1);
+            return IR::HashCons::boolLiteral(e->srcInfo, v == 1);
         }
     } else if (etype->is<IR::Type_StructLike>()) {
         return CloneConstants::clone(expr, this);
@@ -175,6 +175,27 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
 
 bool CompilerOptions::enable_intrinsic_metadata_fix() { return true; }
 
+void CompilerOptions::registerBinarySnapshotOptions() {
+    registerOption(
+        "--toBinary", "file",
+        [this](const char *arg) {
+            dumpBinaryFile = arg;
+            return true;
+        },
+        "Dump the compiler IR as a binary snapshot in the specified file: after the\n"
+        "midend in the compilers, after the front end in P4Tools.  Binary snapshots\n"
+        "are much faster to write and read back than JSON.");
+    registerOption(
+        "--fromBinary", "file",
+        [this](const char *arg) {
+            loadIRFromBinary = true;
+            file = arg;
+            return true;
+        },
+        "Read a binary snapshot written by --toBinary of the same tool instead of\n"
+        "P4 source code.");
+}
+
 void CompilerOptions::validateOptions() const {
     if (!p4RuntimeFile.isNullOrEmpty()) {
         ::warning(ErrorType::WARN_DEPRECATED,
@@ -53,6 +53,10 @@ class CompilerOptions : public ParserOptions {
     std::vector<cstring> passesToExcludeBackend;
     // Dump a JSON representation of the IR in the file.
     cstring dumpJsonFile = nullptr;
+    // Dump a binary snapshot of the IR in the file.
+    cstring dumpBinaryFile = nullptr;
+    // Read the program from the binary snapshot in `file` instead of P4 source.
+    bool loadIRFromBinary = false;
     // Dump and undump the IR tree.
     bool debugJson = false;
     // if this flag is true, compile program in non-debug mode.
@@ -84,5 +88,9 @@ class CompilerOptions : public ParserOptions {
     bool optimizeSize = false;   // optimize favoring size
 
     virtual bool enable_intrinsic_metadata_fix();
+
+    // Registers --toBinary and --fromBinary.  Only the drivers which write and
+    // read binary snapshots call this, so that the others reject the options.
+    void registerBinarySnapshotOptions();
 };
 #endif /* FRONTENDS_COMMON_OPTIONS_H_ */
@@ -17,6 +17,10 @@ limitations under the License.
 #ifndef FRONTENDS_COMMON_PARSEINPUT_H_
 #define FRONTENDS_COMMON_PARSEINPUT_H_
 
+#include <sstream>
+#include <string>
+
+#include "frontends/common/compilationCache.h"
 #include "frontends/common/options.h"
 #include "frontends/p4/fromv1.0/converters.h"
 #include "frontends/p4/frontend.h"
@@ -77,13 +81,30 @@ const IR::P4Program *parseP4File(ParserOptions &options) {
         if (::errorCount() > 0 || in == nullptr) return nullptr;
     }
 
-    auto result = options.isv1()
-                      ? parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook())
-                      : P4ParserDriver::parse(in, options.file);
-    if (options.doNotPreprocess) {
-        fclose(in);
+    const IR::P4Program *result = nullptr;
+    if (options.compilationCacheDir) {
+        // The cache is keyed on the preprocessed text, so read it all and parse
+        // it from memory.
+        std::string input = CompilationCache::readAll(in);
+        if (options.doNotPreprocess) {
+            fclose(in);
+        } else {
+            options.closePreprocessedInput(in);
+        }
+        CompilationCache::computeKey(options, input);
+        std::istringstream stream(input);
+        result = options.isv1() ? parseV1Program<std::istringstream, C>(
+                                      stream, options.file, 1, options.getDebugHook())
+                                : P4ParserDriver::parse(stream, options.file);
     } else {
-        options.closePreprocessedInput(in);
+        result = options.isv1()
+                     ? parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook())
+                     : P4ParserDriver::parse(in, options.file);
+        if (options.doNotPreprocess) {
+            fclose(in);
+        } else {
+            options.closePreprocessedInput(in);
+        }
     }
 
     if (::errorCount() > 0) {
@@ -26,8 +26,12 @@ limitations under the License.
 #include <regex>
 #include <unordered_set>
 
+#include "frontends/common/programMap.h"
 #include "frontends/p4/toP4/toP4.h"
+#include "ir/hash_cons.h"
 #include "ir/json_generator.h"
+#include "ir/pass_manager.h"
+#include "ir/pass_profile.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
 #include "lib/log.h"
@@ -305,6 +309,50 @@ ParserOptions::ParserOptions() : Util::Options(defaultMessage) {
         "When the optimization is enabled, compiler tries to identify the cases,\n"
         "when it can inline the subparser's states only once for multiple\n"
         "invocations of the same subparser instance.");
+    registerOption(
+        "--passProfile", "file",
+        [](const char *arg) {
+            PassProfiler::enable(arg);
+            return true;
+        },
+        "[Compiler debugging] Record time, visited/changed nodes and allocated bytes\n"
+        "for every pass and write them to 'file' as JSON and to 'file.trace.json'\n"
+        "in the Chrome trace-event format.\n");
+    registerOption(
+        "--hashConsLiterals", nullptr,
+        [](const char *) {
+            IR::HashCons::enable();
+            return true;
+        },
+        "Share structurally equal literals created by the compiler instead of\n"
+        "allocating a new node for each of them.\n");
+    registerOption(
+        "--incrementalMaps", nullptr,
+        [](const char *) {
+            P4::ProgramMap::setIncrementalUpdates(true);
+            return true;
+        },
+        "When the program changes, only recompute the types and references of\n"
+        "the top-level declarations that changed or that refer to changed ones.\n");
+    registerOption(
+        "--compilationCache", "dir",
+        [this](const char *arg) {
+            compilationCacheDir = arg;
+            return true;
+        },
+        "Cache the result of the front end in the specified directory, keyed on the\n"
+        "preprocessed input, the compiler and the command line, and reuse it when\n"
+        "the same program is compiled again with the same options.\n");
+#ifdef MULTITHREAD
+    registerOption(
+        "--parallelPasses", "threads",
+        [](const char *arg) {
+            PassManager::setParallelism(strtoul(arg, nullptr, 10));
+            return true;
+        },
+        "Run passes that are safe to apply to each top-level\n"
+        "declaration independently on the given number of worker threads.\n");
+#endif  // MULTITHREAD
     registerOption(
         "--doNotEmitIncludes", "condition",
         [this](const char *arg) {
@@ -98,6 +98,10 @@ class ParserOptions : public Util::Options {
     /// If true do not generate #include statements.
     /// Used for debugging.
     bool noIncludes = false;
+    /// Directory of the compilation cache; no caching if null.
+    cstring compilationCacheDir = nullptr;
+    /// Key of the current compilation in the cache, set when the input is parsed.
+    cstring compilationCacheKey = nullptr;
 };
 
 /// A compilation context which exposes compiler options and a compiler
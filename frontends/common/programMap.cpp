@@ -0,0 +1,109 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "programMap.h"
+
+#include <vector>
+
+namespace P4 {
+
+bool ProgramMap::incrementalUpdates = false;
+
+namespace {
+
+/// Collects all nodes reachable from the visited node.
+class CollectNodes : public Inspector {
+    absl::flat_hash_set<const IR::Node *, Util::Hash> &nodes;
+
+ public:
+    explicit CollectNodes(absl::flat_hash_set<const IR::Node *, Util::Hash> &nodes)
+        : nodes(nodes) {}
+    bool preorder(const IR::Node *node) override { return nodes.insert(node).second; }
+};
+
+/// Collects the names of all paths in the visited node.
+class CollectPathNames : public Inspector {
+    absl::flat_hash_set<cstring, Util::Hash> &names;
+
+ public:
+    explicit CollectPathNames(absl::flat_hash_set<cstring, Util::Hash> &names) : names(names) {}
+    bool preorder(const IR::Path *path) override {
+        names.insert(path->name.name);
+        return false;
+    }
+};
+
+}  // namespace
+
+ProgramChanges::ProgramChanges(const IR::P4Program *before, const IR::P4Program *after) {
+    if (before == nullptr || after == nullptr || before == after) return;
+    const auto &oldObjects = before->objects;
+    const auto &newObjects = after->objects;
+    if (oldObjects.size() != newObjects.size()) return;
+
+    std::vector<bool> stale(newObjects.size());
+    absl::flat_hash_set<cstring, Util::Hash> staleNames;
+    for (size_t i = 0; i < newObjects.size(); i++) {
+        const auto *oldObject = oldObjects.at(i);
+        const auto *newObject = newObjects.at(i);
+        if (oldObject == newObject) continue;
+        const auto *oldDecl = oldObject->to<IR::IDeclaration>();
+        const auto *newDecl = newObject->to<IR::IDeclaration>();
+        if (oldDecl == nullptr || newDecl == nullptr ||
+            oldObject->node_type_name() != newObject->node_type_name() ||
+            oldDecl->getName() != newDecl->getName())
+            return;
+        stale[i] = true;
+        staleNames.insert(newDecl->getName().name);
+        // The replacement may contain nodes that were typed or resolved while
+        // intermediate versions of the program were being transformed.
+        oldObject->apply(CollectNodes(staleNodes));
+        newObject->apply(CollectNodes(staleNodes));
+    }
+
+    // Propagate staleness to the declarations that refer to stale ones.
+    std::vector<absl::flat_hash_set<cstring, Util::Hash>> pathNames(newObjects.size());
+    if (!staleNames.empty()) {
+        for (size_t i = 0; i < newObjects.size(); i++)
+            if (!stale[i]) newObjects.at(i)->apply(CollectPathNames(pathNames[i]));
+    }
+    bool changed = !staleNames.empty();
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < newObjects.size(); i++) {
+            if (stale[i]) continue;
+            bool refersToStale = false;
+            for (auto name : pathNames[i]) {
+                if (staleNames.count(name)) {
+                    refersToStale = true;
+                    break;
+                }
+            }
+            if (!refersToStale) continue;
+            const auto *decl = newObjects.at(i)->to<IR::IDeclaration>();
+            if (decl == nullptr) return;
+            stale[i] = true;
+            staleNames.insert(decl->getName().name);
+            newObjects.at(i)->apply(CollectNodes(staleNodes));
+            changed = true;
+        }
+    }
+    incremental = true;
+    LOG2("Program changes: " << staleNames.size() << " of " << newObjects.size()
+                             << " top-level declarations are stale");
+}
+
+}  // namespace P4
@@ -17,11 +17,31 @@ limitations under the License.
 #ifndef FRONTENDS_COMMON_PROGRAMMAP_H_
 #define FRONTENDS_COMMON_PROGRAMMAP_H_
 
+#include "absl/container/flat_hash_set.h"
 #include "ir/ir.h"
+#include "lib/hash.h"
 #include "lib/log.h"
 
 namespace P4 {
 
+/// Describes how a program changed since a map was computed for it, at the
+/// granularity of top-level declarations.  A top-level declaration is stale if
+/// it was replaced, or if it refers by name to a stale declaration (transitively).
+/// A map can be updated by forgetting what it knows about the nodes reachable
+/// from stale declarations, provided the top-level declarations still have the
+/// same names in the same order; otherwise it has to be recomputed.
+class ProgramChanges {
+    bool incremental = false;
+    absl::flat_hash_set<const IR::Node *, Util::Hash> staleNodes;
+
+ public:
+    ProgramChanges(const IR::P4Program *before, const IR::P4Program *after);
+    /// @returns false if maps have to be recomputed from scratch.
+    bool isIncremental() const { return incremental; }
+    /// @returns true if what is known about @p node may be out of date.
+    bool isStale(const IR::Node *node) const { return staleNodes.count(node) != 0; }
+};
+
 // Base class for various maps.
 // A map is computed on a certain P4Program.
 // If the program has not changed, the map is up-to-date.
@@ -33,7 +53,17 @@ class ProgramMap : public IHasDbPrint {
     explicit ProgramMap(cstring kind) : mapKind(kind) {}
     virtual ~ProgramMap() {}
 
+    /// If true, maps are updated incrementally when the program changes.
+    static bool incrementalUpdates;
+
  public:
+    static void setIncrementalUpdates(bool enable) { incrementalUpdates = enable; }
+    /// Compute the changes from the program this map was computed for to @p node.
+    /// They are never incremental unless incremental updates are enabled.
+    ProgramChanges changesTo(const IR::Node *node) const {
+        const auto *after = node ? node->to<IR::P4Program>() : nullptr;
+        return ProgramChanges(incrementalUpdates ? program : nullptr, after);
+    }
     // Check if map is up-to-date for the specified node; return true if it is
     bool checkMap(const IR::Node *node) const {
         if (node == program) {
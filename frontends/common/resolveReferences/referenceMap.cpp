@@ -39,6 +39,31 @@ void ReferenceMap::clear() {
     ProgramMap::clear();
 }
 
+void ReferenceMap::invalidate(const IR::Node *node) {
+    auto changes = changesTo(node);
+    if (!changes.isIncremental()) {
+        clear();
+        return;
+    }
+    LOG2("Invalidating reference map");
+    used.clear();
+    for (auto it = pathToDeclaration.begin(); it != pathToDeclaration.end();) {
+        if (changes.isStale(it->first) || changes.isStale(it->second->getNode())) {
+            pathToDeclaration.erase(it++);
+        } else {
+            used.insert(it->second);
+            ++it;
+        }
+    }
+    for (auto it = thisToDeclaration.begin(); it != thisToDeclaration.end();) {
+        if (changes.isStale(it->first) || changes.isStale(it->second->getNode()))
+            thisToDeclaration.erase(it++);
+        else
+            ++it;
+    }
+    ProgramMap::clear();
+}
+
 void ReferenceMap::setDeclaration(const IR::Path *path, const IR::IDeclaration *decl) {
     CHECK_NULL(path);
     CHECK_NULL(decl);
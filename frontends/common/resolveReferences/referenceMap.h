@@ -87,6 +87,11 @@ class ReferenceMap final : public ProgramMap, public NameGenerator, public Decla
     const IR::IDeclaration *getDeclaration(const IR::Path *path,
                                            bool notNull = false) const override;
 
+    /// Like getDeclaration, but returns nullptr without logging if @p path is not resolved.
+    const IR::IDeclaration *findDeclaration(const IR::Path *path) const {
+        return get(pathToDeclaration, path);
+    }
+
     /// Sets declaration for @p path to @p decl.
     void setDeclaration(const IR::Path *path, const IR::IDeclaration *decl);
 
@@ -110,6 +115,14 @@ class ReferenceMap final : public ProgramMap, public NameGenerator, public Decla
     /// Clear the reference map
     void clear();
 
+    /// Prepare the map to be recomputed for @p node: forget the declarations of
+    /// the paths that may have changed (see ProgramChanges), or clear the whole
+    /// map if it cannot be updated incrementally.  An incremental update keeps the
+    /// names used in the program, since the paths that are not resolved again would
+    /// not add them back; clearing forgets them along with everything else, and
+    /// resolving the whole program adds them again.
+    void invalidate(const IR::Node *node);
+
     /// @returns @true if this map is for a P4_14 program
     bool isV1() const { return isv1; }
 
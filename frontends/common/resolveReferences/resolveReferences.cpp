@@ -298,6 +298,8 @@ const IR::IDeclaration *ResolutionContext::resolvePath(const IR::Path *path, boo
 }
 
 const IR::IDeclaration *ResolveReferences::resolvePath(const IR::Path *path, bool isType) const {
+    // Paths kept by an incremental update of the map are still resolved correctly.
+    if (const auto *decl = refMap->findDeclaration(path)) return decl;
     auto decl = ResolutionContext::resolvePath(path, isType);
     if (decl == nullptr) {
         refMap->usedName(path->name.name);
@@ -360,7 +362,10 @@ void ResolveReferences::checkShadowing(const IR::INamespace *ns) const {
 Visitor::profile_t ResolveReferences::init_apply(const IR::Node *node) {
     anyOrder = refMap->isV1();
     // Check shadowing even if the program map is up-to-date.
-    if (!refMap->checkMap(node) || checkShadow) refMap->clear();
+    if (checkShadow)
+        refMap->clear();
+    else if (!refMap->checkMap(node))
+        refMap->invalidate(node);
     return Inspector::init_apply(node);
 }
 
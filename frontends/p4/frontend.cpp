@@ -20,11 +20,13 @@ limitations under the License.
 #include <iostream>
 
 #include "../common/options.h"
+#include "frontends/common/compilationCache.h"
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/fromv1.0/v1model.h"
 #include "frontends/p4/typeChecking/bindVariables.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
+#include "lib/log.h"
 #include "lib/nullstream.h"
 #include "lib/path.h"
 // Passes
@@ -150,6 +152,15 @@ class SetStrictStruct : public NoVisit {
 const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4Program *program,
                                    std::ostream *outStream) {
     if (program == nullptr && options.listFrontendPasses == 0) return nullptr;
+    // Pretty-printing and dumps need the passes to run, but other debug hooks only get
+    // to see the cached result.
+    if (program != nullptr && !options.prettyPrintFile && options.top4.empty() &&
+        !Log::verbose()) {
+        if (const auto *cached = CompilationCache::lookup(options, program)) {
+            for (const auto &hook : hooks) hook("FrontEnd", 0, "CompilationCache", cached);
+            return cached;
+        }
+    }
 
     bool isv1 = options.isv1();
     ReferenceMap refMap;
@@ -282,6 +293,7 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
     passes.setStopOnError(true);
     passes.addDebugHooks(hooks, true);
     const IR::P4Program *result = program->apply(passes);
+    if (result != nullptr && ::errorCount() == 0) CompilationCache::store(options, result);
     return result;
 }
 
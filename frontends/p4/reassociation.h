@@ -18,6 +18,7 @@ limitations under the License.
 #define P4_REASSOCIATION_H_
 
 #include "ir/ir.h"
+#include "ir/pass_manager.h"
 #include "ir/visitor.h"
 
 namespace P4 {
@@ -25,12 +26,13 @@ namespace P4 {
 /** Implements a pass that reorders associative operations when beneficial.
  * For example, (a + c0) + c1 is rewritten as a + (c0 + c1) when cs are constants.
  */
-class Reassociation final : public Transform {
+class Reassociation final : public Transform, public PerDeclarationSafe {
  public:
     Reassociation() {
         visitDagOnce = true;
         setName("Reassociation");
     }
+    Reassociation *clone() const override { return new Reassociation(*this); }
     using Transform::postorder;
 
     const IR::Node *reassociate(IR::Operation_Binary *root);
@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "strengthReduction.h"
 
+#include "ir/hash_cons.h"
+
 namespace P4 {
 
 /// @section Helper methods
@@ -121,7 +123,7 @@ const IR::Node *DoStrengthReduction::postorder(IR::BXor *expr) {
     if (expr->left->equiv(*expr->right) && expr->left->type &&
         !expr->left->type->is<IR::Type_Unknown>())
         // we assume that this type is right
-        return new IR::Constant(expr->srcInfo, expr->left->type, 0);
+        return IR::HashCons::constant(expr->srcInfo, expr->left->type, 0);
     return expr;
 }
 
@@ -184,14 +186,14 @@ const IR::Node *DoStrengthReduction::postorder(IR::Sub *expr) {
     // Replace `a - constant` with `a + (-constant)`
     if (expr->right->is<IR::Constant>()) {
         auto cst = expr->right->to<IR::Constant>();
-        auto neg = new IR::Constant(cst->srcInfo, cst->type, -cst->value, cst->base, true);
+        auto neg = IR::HashCons::constant(cst->srcInfo, cst->type, -cst->value, cst->base, true);
         auto result = new IR::Add(expr->srcInfo, expr->type, expr->left, neg);
         return result;
     }
     if (hasSideEffects(expr)) return expr;
     if (expr->left->equiv(*expr->right) && expr->left->type &&
         !expr->left->type->is<IR::Type_Unknown>())
-        return new IR::Constant(expr->srcInfo, expr->left->type, 0);
+        return IR::HashCons::constant(expr->srcInfo, expr->left->type, 0);
     return expr;
 }
 
@@ -22,6 +22,7 @@ limitations under the License.
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
+#include "ir/pass_manager.h"
 
 namespace P4 {
 
@@ -42,7 +43,7 @@ namespace P4 {
  *   - division and modulus by `0`
  *
  */
-class DoStrengthReduction final : public Transform {
+class DoStrengthReduction final : public Transform, public PerDeclarationSafe {
     /// @returns `true` if @p expr is the constant `1`.
     bool isOne(const IR::Expression *expr) const;
     /// @returns `true` if @p expr is the constant `0`.
@@ -69,6 +70,7 @@ class DoStrengthReduction final : public Transform {
         visitDagOnce = true;
         setName("StrengthReduction");
     }
+    DoStrengthReduction *clone() const override { return new DoStrengthReduction(*this); }
 
     using Transform::postorder;
 
@@ -2123,7 +2123,6 @@ const IR::Node *TypeInference::postorder(IR::Key *key) {
  *  typecheck a table initializer entry list
  */
 const IR::Node *TypeInference::preorder(IR::EntriesList *el) {
-    if (done()) return el;
     auto table = findContext<IR::P4Table>();
     BUG_CHECK(table != nullptr, "%1% entries not within a table", el);
     const IR::Key *key = table->getKey();
@@ -2134,6 +2133,15 @@ const IR::Node *TypeInference::preorder(IR::EntriesList *el) {
         return el;
     }
     auto keyTuple = typeMap->getType(key);  // direct typeMap call to skip checks
+    if (done()) {
+        // The list has the type of the key it was checked against.  If the key type is still
+        // the same, there is no need to check every entry again.
+        auto checkedType = typeMap->getType(getOriginal());
+        if (keyTuple != nullptr && checkedType != nullptr &&
+            typeMap->equivalent(checkedType, keyTuple, true))
+            prune();
+        return el;
+    }
     if (keyTuple == nullptr) {
         // The keys have to be before the entries list.  If they are not,
         // at this point they have not yet been type-checked.
@@ -2147,6 +2155,34 @@ const IR::Node *TypeInference::preorder(IR::EntriesList *el) {
     return el;
 }
 
+const IR::Node *TypeInference::postorder(IR::EntriesList *el) {
+    if (done() || ::errorCount() > 0) return el;
+    auto keyTuple = typeMap->getType(findContext<IR::P4Table>()->getKey());
+    if (keyTuple == nullptr) return el;
+    setType(el, keyTuple);
+    setType(getOriginal(), keyTuple);
+    return el;
+}
+
+/// @returns true if every element of @p entryKeyType, the type of the keys of an entry, already
+/// has the type of the corresponding table key field in @p keyTuple.  Masks and ranges have the
+/// set type of their bounds, and _ matches any field.  Unifying such keys binds no type variable
+/// and converts no constant, which matters for tables with very many entries.
+static bool keysHaveKeyTypes(const TypeMap *typeMap, const IR::Type *entryKeyType,
+                             const IR::Type *keyTuple) {
+    auto entryTuple = entryKeyType->to<IR::Type_BaseList>();
+    auto tuple = keyTuple->to<IR::Type_BaseList>();
+    if (entryTuple == nullptr || tuple == nullptr || entryTuple->getSize() != tuple->getSize())
+        return false;
+    for (size_t i = 0; i < tuple->getSize(); ++i) {
+        auto type = entryTuple->components.at(i);
+        if (type->is<IR::Type_Dontcare>()) continue;
+        if (auto set = type->to<IR::Type_Set>()) type = set->elementType;
+        if (!typeMap->equivalent(type, tuple->components.at(i), true)) return false;
+    }
+    return true;
+}
+
 /**
  *  typecheck a table initializer entry
  *
@@ -2202,18 +2238,21 @@ const IR::Node *TypeInference::postorder(IR::Entry *entry) {
         return entry;
     }
 
-    TypeVariableSubstitution *tvs =
-        unifyCast(entry, keyTuple, entryKeyType,
-                  "Table entry has type '%1%' which is not the expected type '%2%'",
-                  {keyTuple, entryKeyType});
-    if (tvs == nullptr) return entry;
-    ConstantTypeSubstitution cts(tvs, refMap, typeMap, this);
-    auto ks = cts.convert(keyset);
-    if (::errorCount() > 0) return entry;
+    if (!keysHaveKeyTypes(typeMap, entryKeyType, keyTuple)) {
+        TypeVariableSubstitution *tvs =
+            unifyCast(entry, keyTuple, entryKeyType,
+                      "Table entry has type '%1%' which is not the expected type '%2%'",
+                      {keyTuple, entryKeyType});
+        if (tvs == nullptr) return entry;
+        ConstantTypeSubstitution cts(tvs, refMap, typeMap, this);
+        auto ks = cts.convert(keyset);
+        if (::errorCount() > 0) return entry;
 
-    if (ks != keyset)
-        entry = new IR::Entry(entry->srcInfo, entry->annotations, entry->isConst, entry->priority,
+        if (ks != keyset)
+            entry =
+                new IR::Entry(entry->srcInfo, entry->annotations, entry->isConst, entry->priority,
                               ks->to<IR::ListExpression>(), entry->action, entry->singleton);
+    }
 
     auto actionRef = entry->getAction();
     auto ale = validateActionInitializer(actionRef);
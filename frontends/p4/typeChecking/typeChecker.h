@@ -43,12 +43,15 @@ class ClearTypeMap : public Inspector {
         CHECK_NULL(typeMap);
     }
     bool preorder(const IR::P4Program *program) override {
-        // Clear map only if program has not changed from last time
+        // Invalidate map only if program has changed from last time
         // otherwise we can reuse it.  The 'force' flag is needed
         // because the program is saved only *after* typechecking,
         // so if the program changes during type-checking, the
         // typeMap may not be complete.
-        if (force || !typeMap->checkMap(program)) typeMap->clear();
+        if (force)
+            typeMap->clear();
+        else if (!typeMap->checkMap(program))
+            typeMap->invalidate(program);
         return false;  // prune()
     }
 };
@@ -273,6 +276,7 @@ class TypeInference : public Transform {
     const IR::Node *postorder(IR::P4Action *type) override;
     const IR::Node *postorder(IR::P4ValueSet *type) override;
     const IR::Node *postorder(IR::Key *key) override;
+    const IR::Node *postorder(IR::EntriesList *el) override;
     const IR::Node *postorder(IR::Entry *e) override;
 
     const IR::Node *postorder(IR::Dots *expression) override;
@@ -68,6 +68,7 @@ class TypeSubstitution : public IHasDbPrint {
     }
 
     void clear() { binding.clear(); }
+    void erase(T t) { binding.erase(t); }
 };
 
 class TypeVariableSubstitution final : public TypeSubstitution<const IR::ITypeVar *> {
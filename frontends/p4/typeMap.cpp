@@ -90,6 +90,40 @@ void TypeMap::clear() {
     ProgramMap::clear();
 }
 
+void TypeMap::invalidate(const IR::Node *node) {
+    auto changes = changesTo(node);
+    if (!changes.isIncremental()) {
+        clear();
+        return;
+    }
+    LOG3("Invalidating typeMap");
+    for (auto it = typeMap.begin(); it != typeMap.end();) {
+        if (changes.isStale(it->first)) {
+            // Type variables of stale nodes will be bound again.
+            if (const auto *var = it->first->to<IR::ITypeVar>()) allTypeVariables.erase(var);
+            if (const auto *var = it->second->to<IR::ITypeVar>()) allTypeVariables.erase(var);
+            // `typeMap` is abseil map, therefore erase does not return iterator, use
+            // post-increment
+            typeMap.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = leftValues.begin(); it != leftValues.end();) {
+        if (changes.isStale(*it))
+            leftValues.erase(it++);
+        else
+            ++it;
+    }
+    for (auto it = constants.begin(); it != constants.end();) {
+        if (changes.isStale(*it))
+            constants.erase(it++);
+        else
+            ++it;
+    }
+    ProgramMap::clear();
+}
+
 void TypeMap::checkPrecondition(const IR::Node *element, const IR::Type *type) const {
     CHECK_NULL(element);
     CHECK_NULL(type);
@@ -75,6 +75,10 @@ class TypeMap final : public ProgramMap {
     const IR::Type *getTypeType(const IR::Node *element, bool notNull) const;
     void dbprint(std::ostream &out) const;
     void clear();
+    /// Prepare the map to be recomputed for @p node: forget the types of the
+    /// nodes that may have changed (see ProgramChanges), or clear the whole map
+    /// if it cannot be updated incrementally.
+    void invalidate(const IR::Node *node);
     bool isLeftValue(const IR::Expression *expression) const {
         return leftValues.count(expression) > 0;
     }
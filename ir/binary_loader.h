@@ -0,0 +1,424 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_BINARY_LOADER_H_
+#define IR_BINARY_LOADER_H_
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ir/binary_writer.h"
+#include "ir/ir.h"
+#include "ir/json_loader.h"
+#include "lib/big_int_util.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/error.h"
+#include "lib/exceptions.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+#include "lib/source_file.h"
+
+/// Reads IR trees written by BinaryWriter straight from a memory buffer (usually a
+/// memory-mapped file).  Generated IR classes have a constructor taking a BinaryLoader,
+/// which reads the fields in the order toBinary() wrote them.
+class BinaryLoader {
+    template <typename T>
+    class has_fromBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::fromBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    template <typename T>
+    class has_fromJSON {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::fromJSON));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    const char *pos;
+    const char *end;
+    bool valid = false;
+    const Util::InputSources *sources;
+    std::vector<IR::Node *> nodes;
+    std::vector<cstring> strings;
+
+    /// Thrown when the data is truncated or inconsistent; loadNode() reports it.
+    struct Corrupt {
+        std::string reason;
+    };
+    /// @returns @p node as a @p T; @p node may only be null if @p nullable.
+    template <typename T>
+    static const T *expect(const IR::Node *node, bool nullable) {
+        if (node == nullptr) {
+            if (!nullable) corrupt("missing node");
+            return nullptr;
+        }
+        if (auto *t = node->to<T>()) return t;
+        corrupt(std::string("unexpected node type ") + node->node_type_name().c_str());
+    }
+
+    /// Read a node reference; new nodes are constructed by @p make, which is called
+    /// with the class name that was written for the node.
+    template <typename Make>
+    IR::Node *readNode(Make make) {
+        uint64_t tag = readUnsigned();
+        if (tag == BinaryWriter::Null) return nullptr;
+        if (tag != BinaryWriter::New) {
+            if (tag - BinaryWriter::FirstRef >= nodes.size())
+                corrupt("bad node reference " + std::to_string(tag));
+            return nodes[tag - BinaryWriter::FirstRef];
+        }
+        cstring type;
+        load(type);
+        // Reserve the slot before the fields of the node (and any nodes nested in it)
+        // are read, so that indices agree with the order in which they were written.
+        size_t index = nodes.size();
+        nodes.push_back(nullptr);
+        IR::Node *node = make(type);
+        nodes[index] = node;
+        return node;
+    }
+    /// Read a node whose concrete class is given by the class name in the stream.
+    IR::Node *readNode();
+    /// Read a node whose concrete class is known statically to be @p T.
+    template <typename T>
+    IR::Node *readNodeOf() {
+        return readNode([this](cstring) -> IR::Node * { return T::fromBinary(*this); });
+    }
+
+ public:
+    /// @p data must stay valid while the loader is in use; nothing points into it after.
+    /// Source ranges written with BinaryWriter::setInputSources refer to @p sources; they
+    /// are dropped if @p sources is null.
+    BinaryLoader(const char *data, size_t size, const Util::InputSources *sources = nullptr);
+    /// False if the data does not start with the header of a compatible BinaryWriter.
+    bool isValid() const { return valid; }
+    const Util::InputSources *inputSources() const { return sources; }
+
+    /// Stops loading because the data is truncated or corrupt.
+    [[noreturn]] static void corrupt(std::string reason) { throw Corrupt{std::move(reason)}; }
+
+    uint64_t readUnsigned();
+    int64_t readSigned() {
+        uint64_t v = readUnsigned();
+        return int64_t(v >> 1) ^ -int64_t(v & 1);
+    }
+    const char *readBytes(size_t size) {
+        if (size > size_t(end - pos)) corrupt("truncated");
+        const char *rv = pos;
+        pos += size;
+        return rv;
+    }
+
+    /// @returns the root node of the stream, or nullptr after reporting an error if
+    /// the stream is truncated or corrupt.
+    template <typename T = IR::Node>
+    const T *loadNode() {
+        std::string failure;
+        const T *node = tryLoadNode<T>(failure);
+        if (!failure.empty())
+            ::error(ErrorType::ERR_INVALID, "binary IR snapshot is corrupt: %1%", cstring(failure));
+        return node;
+    }
+    /// Reads a node that must be present, for constructors which store it by value.  If the
+    /// stream is truncated or corrupt, the enclosing loadNode() reports the error.
+    template <typename T>
+    const T &loadRequiredNode() {
+        return *expect<T>(readNode(), false);
+    }
+    /// Like loadNode(), but sets @p failure to the reason instead of reporting an error.
+    template <typename T = IR::Node>
+    const T *tryLoadNode(std::string &failure) {
+        try {
+            return expect<T>(readNode(), true);
+        } catch (const Corrupt &corruption) {
+            failure = corruption.reason;
+            return nullptr;
+        }
+    }
+
+    template <typename T>
+    void load(safe_vector<T> &v) {
+        for (uint64_t size = readUnsigned(); size > 0; --size) {
+            T temp;
+            load(temp);
+            v.push_back(std::move(temp));
+        }
+    }
+
+    template <typename T>
+    void load(std::vector<T> &v) {
+        for (uint64_t size = readUnsigned(); size > 0; --size) {
+            T temp;
+            load(temp);
+            v.push_back(std::move(temp));
+        }
+    }
+
+    template <typename T, typename U>
+    void load(std::pair<T, U> &v) {
+        load(v.first);
+        load(v.second);
+    }
+
+    template <typename T>
+    void load(std::optional<T> &v) {
+        bool isValid = false;
+        load(isValid);
+        if (!isValid) {
+            v = std::nullopt;
+            return;
+        }
+        T value;
+        load(value), v = std::move(value);
+    }
+
+    template <typename T>
+    void load(std::set<T> &v) {
+        for (uint64_t size = readUnsigned(); size > 0; --size) {
+            T temp;
+            load(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename T>
+    void load(ordered_set<T> &v) {
+        for (uint64_t size = readUnsigned(); size > 0; --size) {
+            T temp;
+            load(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename K, typename V>
+    void load(std::map<K, V> &v) {
+        for (uint64_t size = readUnsigned(); size > 0; --size) {
+            std::pair<K, V> temp;
+            load(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename K, typename V>
+    void load(std::multimap<K, V> &v) {
+        for (uint64_t size = readUnsigned(); size > 0; --size) {
+            std::pair<K, V> temp;
+            load(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename K, typename V>
+    void load(ordered_map<K, V> &v) {
+        for (uint64_t size = readUnsigned(); size > 0; --size) {
+            std::pair<K, V> temp;
+            load(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    void load(bool &v) { v = *readBytes(1) != 0; }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type load(
+        T &v) {
+        v = static_cast<T>(readSigned());
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type load(
+        T &v) {
+        v = static_cast<T>(readUnsigned());
+    }
+    void load(double &v) { std::memcpy(&v, readBytes(sizeof(v)), sizeof(v)); }
+    void load(big_int &v);
+    void load(cstring &v);
+    void load(IR::ID &v) {
+        load(v.name);
+        load(v.originalName);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type load(T &v) {
+        v = static_cast<T>(readSigned());
+    }
+    void load(LTBitMatrix &v);
+    void load(bitvec &v);
+    void load(match_t &v) {
+        load(v.word0);
+        load(v.word1);
+    }
+    void load(UnparsedConstant *&v);
+
+    template <typename T>
+    void load(IR::Vector<T> &v) {
+        v = *expect<IR::Vector<T>>(readNodeOf<IR::Vector<T>>(), false);
+    }
+    template <typename T>
+    void load(const IR::Vector<T> *&v) {
+        v = expect<IR::Vector<T>>(readNodeOf<IR::Vector<T>>(), true);
+    }
+    template <typename T>
+    void load(IR::IndexedVector<T> &v) {
+        v = *expect<IR::IndexedVector<T>>(readNodeOf<IR::IndexedVector<T>>(), false);
+    }
+    template <typename T>
+    void load(const IR::IndexedVector<T> *&v) {
+        v = expect<IR::IndexedVector<T>>(readNodeOf<IR::IndexedVector<T>>(), true);
+    }
+    template <class T, template <class K, class V, class COMP, class ALLOC> class MAP, class COMP,
+              class ALLOC>
+    void load(IR::NameMap<T, MAP, COMP, ALLOC> &m) {
+        using Map = IR::NameMap<T, MAP, COMP, ALLOC>;
+        m = *expect<Map>(readNodeOf<Map>(), false);
+    }
+    template <class T, template <class K, class V, class COMP, class ALLOC> class MAP, class COMP,
+              class ALLOC>
+    void load(const IR::NameMap<T, MAP, COMP, ALLOC> *&m) {
+        using Map = IR::NameMap<T, MAP, COMP, ALLOC>;
+        m = expect<Map>(readNodeOf<Map>(), true);
+    }
+
+    template <typename T>
+    typename std::enable_if<
+        has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value &&
+        std::is_pointer<decltype(T::fromBinary(std::declval<BinaryLoader &>()))>::value>::type
+    load(T *&v) {
+        bool present = false;
+        load(present);
+        v = present ? T::fromBinary(*this) : nullptr;
+    }
+
+    template <typename T>
+    typename std::enable_if<
+        has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value &&
+        std::is_pointer<decltype(T::fromBinary(std::declval<BinaryLoader &>()))>::value>::type
+    load(T &v) {
+        v = *(T::fromBinary(*this));
+    }
+
+    /// Counterpart of BinaryWriter's fallback for types that only support JSON.
+    template <typename T>
+    typename std::enable_if<!has_fromBinary<T>::value && has_fromJSON<T>::value &&
+                            !std::is_base_of<IR::INode, T>::value>::type
+    load(T &v) {
+        cstring text;
+        load(text);
+        std::istringstream in(text.c_str());
+        JSONLoader(in) >> v;
+    }
+
+    template <typename T>
+    typename std::enable_if<!has_fromBinary<T>::value && has_fromJSON<T>::value &&
+                            !std::is_base_of<IR::INode, T>::value>::type
+    load(T *&v) {
+        bool present = false;
+        load(present);
+        v = nullptr;
+        if (present) {
+            cstring text;
+            load(text);
+            std::istringstream in(text.c_str());
+            JSONLoader(in) >> v;
+        }
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type load(T &v) {
+        v = *expect<T>(readNode(), false);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type load(const T *&v) {
+        v = expect<T>(readNode(), true);
+    }
+
+    template <typename T, size_t N>
+    void load(T (&v)[N]) {
+        for (size_t i = 0; i < N; ++i) load(v[i]);
+    }
+
+    template <typename T>
+    BinaryLoader &operator>>(T &v) {
+        load(v);
+        return *this;
+    }
+};
+
+template <class T>
+IR::Vector<T>::Vector(BinaryLoader &bin) : VectorBase(bin) {
+    bin.load(vec);
+}
+template <class T>
+IR::Vector<T> *IR::Vector<T>::fromBinary(BinaryLoader &bin) {
+    return new Vector<T>(bin);
+}
+template <class T>
+IR::IndexedVector<T>::IndexedVector(BinaryLoader &bin) : Vector<T>(bin) {
+    bin.load(declarations);
+}
+template <class T>
+IR::IndexedVector<T> *IR::IndexedVector<T>::fromBinary(BinaryLoader &bin) {
+    return new IndexedVector<T>(bin);
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC>::NameMap(BinaryLoader &bin) : Node(bin) {
+    for (uint64_t size = bin.readUnsigned(); size > 0; --size) {
+        cstring name;
+        const T *node = nullptr;
+        bin >> name >> node;
+        symbols.emplace(name, node);
+    }
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC> *IR::NameMap<T, MAP, COMP, ALLOC>::fromBinary(
+    BinaryLoader &bin) {
+    return new IR::NameMap<T, MAP, COMP, ALLOC>(bin);
+}
+
+#endif /* IR_BINARY_LOADER_H_ */
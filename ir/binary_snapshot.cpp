@@ -0,0 +1,230 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/binary_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "frontends/common/constantParsing.h"
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
+#include "lib/error.h"
+#include "lib/map.h"
+
+BinaryWriter::BinaryWriter(std::ostream &out, bool writeSourceInfo)
+    : out(out), writeSourceInfo(writeSourceInfo) {
+    writeBytes(magic, sizeof(magic));
+    writeUnsigned(version);
+}
+
+void BinaryWriter::writeUnsigned(uint64_t v) {
+    char buf[10];
+    size_t size = 0;
+    do {
+        char byte = v & 0x7f;
+        v >>= 7;
+        if (v) byte |= 0x80;
+        buf[size++] = byte;
+    } while (v);
+    out.write(buf, size);
+}
+
+void BinaryWriter::writeBytes(const char *data, size_t size) { out.write(data, size); }
+
+void BinaryWriter::generate(const big_int &v) {
+    std::vector<unsigned char> bytes;
+    boost::multiprecision::export_bits(v < 0 ? big_int(-v) : v, std::back_inserter(bytes), 8);
+    generate(v < 0);
+    writeUnsigned(bytes.size());
+    writeBytes(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+void BinaryWriter::generate(cstring v) {
+    if (v.isNull()) {
+        writeUnsigned(Null);
+        return;
+    }
+    auto [it, inserted] = strings.emplace(v, strings.size());
+    if (!inserted) {
+        writeUnsigned(FirstRef + it->second);
+        return;
+    }
+    writeUnsigned(New);
+    writeUnsigned(v.size());
+    writeBytes(v.c_str(), v.size());
+}
+
+void BinaryWriter::generate(const LTBitMatrix &v) {
+    std::stringstream text;
+    text << v;
+    auto str = text.str();
+    writeUnsigned(str.size());
+    writeBytes(str.data(), str.size());
+}
+
+void BinaryWriter::generate(const bitvec &v) {
+    std::stringstream text;
+    text << v;
+    auto str = text.str();
+    writeUnsigned(str.size());
+    writeBytes(str.data(), str.size());
+}
+
+void BinaryWriter::generate(const UnparsedConstant *v) {
+    generate(v != nullptr);
+    if (v) *this << v->text << v->skip << v->base << v->hasWidth;
+}
+
+void BinaryWriter::generate(const IR::Node &v) {
+    auto [it, inserted] = nodes.emplace(&v, nodes.size());
+    if (!inserted) {
+        writeUnsigned(FirstRef + it->second);
+        return;
+    }
+    writeUnsigned(New);
+    generate(v.node_type_name());
+    v.toBinary(*this);
+}
+
+BinaryLoader::BinaryLoader(const char *data, size_t size, const Util::InputSources *sources)
+    : pos(data), end(data + size), sources(sources) {
+    if (size < sizeof(BinaryWriter::magic) ||
+        memcmp(data, BinaryWriter::magic, sizeof(BinaryWriter::magic)) != 0)
+        return;
+    pos += sizeof(BinaryWriter::magic);
+    try {
+        valid = readUnsigned() == BinaryWriter::version;
+    } catch (const Corrupt &) {
+        // Too short to hold a version: not a snapshot.
+    }
+}
+
+uint64_t BinaryLoader::readUnsigned() {
+    uint64_t v = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        if (pos == end) corrupt("truncated");
+        if (shift >= 64) corrupt("bad number");
+        unsigned char byte = *pos++;
+        v |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return v;
+    }
+}
+
+IR::Node *BinaryLoader::readNode() {
+    return readNode([this](cstring type) -> IR::Node * {
+        auto fn = get(IR::binary_unpacker_table, type);
+        if (!fn) corrupt(std::string("unknown node type ") + type.c_str());
+        return fn(*this);
+    });
+}
+
+void BinaryLoader::load(big_int &v) {
+    bool negative = false;
+    load(negative);
+    auto size = readUnsigned();
+    auto *bytes = reinterpret_cast<const unsigned char *>(readBytes(size));
+    boost::multiprecision::import_bits(v, bytes, bytes + size, 8);
+    if (negative) v = -v;
+}
+
+void BinaryLoader::load(cstring &v) {
+    uint64_t tag = readUnsigned();
+    if (tag == BinaryWriter::Null) {
+        v = cstring();
+    } else if (tag == BinaryWriter::New) {
+        auto size = readUnsigned();
+        v = cstring(readBytes(size), size);
+        strings.push_back(v);
+    } else {
+        if (tag - BinaryWriter::FirstRef >= strings.size())
+            corrupt("bad string reference " + std::to_string(tag));
+        v = strings[tag - BinaryWriter::FirstRef];
+    }
+}
+
+void BinaryLoader::load(LTBitMatrix &v) {
+    auto size = readUnsigned();
+    std::string text(readBytes(size), size);
+    text.c_str() >> v;
+}
+
+void BinaryLoader::load(bitvec &v) {
+    auto size = readUnsigned();
+    std::string text(readBytes(size), size);
+    text.c_str() >> v;
+}
+
+void BinaryLoader::load(UnparsedConstant *&v) {
+    bool present = false;
+    load(present);
+    v = nullptr;
+    if (!present) return;
+    cstring text;
+    unsigned skip = 0;
+    unsigned base = 0;
+    bool hasWidth = false;
+    *this >> text >> skip >> base >> hasWidth;
+    v = new UnparsedConstant({text, skip, base, hasWidth});
+}
+
+namespace IR {
+
+void writeBinarySnapshot(std::ostream &out, const Node *node, bool withSourceInfo) {
+    BinaryWriter(out, withSourceInfo) << node;
+    out.flush();
+}
+
+const Node *readBinarySnapshot(cstring filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ::error(ErrorType::ERR_IO, "Can't open %s", filename);
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::error(ErrorType::ERR_IO, "Can't read %s", filename);
+        close(fd);
+        return nullptr;
+    }
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        ::error(ErrorType::ERR_IO, "Can't map %s", filename);
+        return nullptr;
+    }
+    // All strings and nodes are copied out of the mapping while loading, so it can be
+    // unmapped as soon as the tree has been rebuilt.
+    const Node *node = nullptr;
+    BinaryLoader loader(static_cast<const char *>(data), st.st_size);
+    if (loader.isValid())
+        node = loader.loadNode();
+    else
+        ::error(ErrorType::ERR_INVALID, "%s is not a compatible binary IR snapshot", filename);
+    munmap(data, st.st_size);
+    return node;
+}
+
+}  // namespace IR
@@ -0,0 +1,38 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_BINARY_SNAPSHOT_H_
+#define IR_BINARY_SNAPSHOT_H_
+
+#include <iosfwd>
+
+#include "ir/node.h"
+#include "lib/cstring.h"
+
+namespace IR {
+
+/// Writes @p node and everything reachable from it to @p out in the format read by
+/// BinaryLoader.  Source positions are included unless @p withSourceInfo is false.
+void writeBinarySnapshot(std::ostream &out, const Node *node, bool withSourceInfo = true);
+
+/// Memory-maps @p filename and reads the IR tree stored in it by writeBinarySnapshot.
+/// @returns nullptr after reporting an error if the file cannot be read or is not a
+/// binary IR snapshot of a compatible version.
+const Node *readBinarySnapshot(cstring filename);
+
+}  // namespace IR
+
+#endif /* IR_BINARY_SNAPSHOT_H_ */
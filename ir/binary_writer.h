@@ -0,0 +1,244 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_BINARY_WRITER_H_
+#define IR_BINARY_WRITER_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ir/id.h"
+#include "ir/json_generator.h"
+#include "ir/node.h"
+#include "lib/big_int_util.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+#include "lib/source_file.h"
+
+struct UnparsedConstant;
+
+/// Writes IR trees in a compact binary format; the counterpart of JSONGenerator.
+/// Generated IR classes implement toBinary() as a sequence of `bin << field`, which
+/// their BinaryLoader constructor reads back in the same order, so the stream carries
+/// no field names.  Integers are written as LEB128 varints, and strings and nodes
+/// that were already written are replaced by the index of their first occurrence.
+class BinaryWriter {
+    std::ostream &out;
+    bool writeSourceInfo;
+    const Util::InputSources *sources = nullptr;
+    std::unordered_map<const IR::Node *, size_t> nodes;
+    std::unordered_map<cstring, size_t> strings;
+
+    template <typename T>
+    class has_toBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::toBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    template <typename T>
+    class has_toJSON {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::toJSON));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+ public:
+    /// Every binary IR stream starts with these bytes, followed by the format version.
+    static constexpr char magic[8] = {'P', '4', 'I', 'R', 'B', 'I', 'N', '\0'};
+    static constexpr uint64_t version = 2;
+
+    /// Node (and string) references are encoded as tags: 0 is a null pointer, 1
+    /// introduces a new node, and n >= 2 refers to the (n-2)-th node written.
+    enum Tag : uint64_t { Null = 0, New = 1, FirstRef = 2 };
+    /// How the source position of a node is stored: not at all, as file, line, column
+    /// and source fragment (like in JSON), or as a range of the writer's input sources.
+    enum SourceInfoTag : uint64_t { NoSourceInfo = 0, SourceFragment = 1, SourceRange = 2 };
+
+    explicit BinaryWriter(std::ostream &out, bool writeSourceInfo = true);
+
+    void writeUnsigned(uint64_t v);
+    void writeSigned(int64_t v) { writeUnsigned((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+    void writeBytes(const char *data, size_t size);
+    /// False if source positions are left out of the stream.
+    bool withSourceInfo() const { return writeSourceInfo; }
+    /// Store positions within @p sources as ranges, which a BinaryLoader given the same
+    /// input sources turns back into complete source information.
+    void setInputSources(const Util::InputSources *sources) { this->sources = sources; }
+    const Util::InputSources *inputSources() const { return sources; }
+
+    template <typename T>
+    void generate(const safe_vector<T> &v) {
+        writeUnsigned(v.size());
+        for (const auto &e : v) generate(e);
+    }
+
+    template <typename T>
+    void generate(const std::vector<T> &v) {
+        writeUnsigned(v.size());
+        for (const auto &e : v) generate(e);
+    }
+
+    template <typename T, typename U>
+    void generate(const std::pair<T, U> &v) {
+        generate(v.first);
+        generate(v.second);
+    }
+
+    template <typename T>
+    void generate(const std::optional<T> &v) {
+        generate(v.has_value());
+        if (v) generate(*v);
+    }
+
+    template <typename T>
+    void generate(const std::set<T> &v) {
+        writeUnsigned(v.size());
+        for (const auto &e : v) generate(e);
+    }
+
+    template <typename T>
+    void generate(const ordered_set<T> &v) {
+        writeUnsigned(v.size());
+        for (const auto &e : v) generate(e);
+    }
+
+    template <typename K, typename V>
+    void generate(const std::map<K, V> &v) {
+        writeUnsigned(v.size());
+        for (const auto &e : v) generate(e);
+    }
+
+    template <typename K, typename V>
+    void generate(const std::multimap<K, V> &v) {
+        writeUnsigned(v.size());
+        for (const auto &e : v) generate(e);
+    }
+
+    template <typename K, typename V>
+    void generate(const ordered_map<K, V> &v) {
+        writeUnsigned(v.size());
+        for (const auto &e : v) generate(e);
+    }
+
+    void generate(bool v) { out.put(v ? 1 : 0); }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type generate(
+        T v) {
+        writeSigned(v);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    generate(T v) {
+        writeUnsigned(v);
+    }
+    void generate(double v) { writeBytes(reinterpret_cast<const char *>(&v), sizeof(v)); }
+    void generate(const big_int &v);
+    void generate(cstring v);
+    void generate(const IR::ID &v) {
+        generate(v.name);
+        generate(v.originalName);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type generate(T v) {
+        writeSigned(static_cast<int64_t>(v));
+    }
+    void generate(const LTBitMatrix &v);
+    void generate(const bitvec &v);
+    void generate(const match_t &v) {
+        generate(v.word0);
+        generate(v.word1);
+    }
+    void generate(const UnparsedConstant *v);
+
+    template <typename T>
+    typename std::enable_if<has_toBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    generate(const T &v) {
+        v.toBinary(*this);
+    }
+
+    /// Types without a binary serialization of their own are embedded as JSON.
+    template <typename T>
+    typename std::enable_if<!has_toBinary<T>::value && has_toJSON<T>::value &&
+                            !std::is_base_of<IR::INode, T>::value>::type
+    generate(const T &v) {
+        std::stringstream json;
+        JSONGenerator(json) << v;
+        generate(cstring(json.str()));
+    }
+
+    void generate(const IR::Node &v);
+
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type generate(const T *v) {
+        if (v)
+            generate(*v->getNode());
+        else
+            writeUnsigned(Null);
+    }
+
+    template <typename T>
+    typename std::enable_if<!std::is_base_of<IR::INode, T>::value &&
+                            (has_toBinary<T>::value || has_toJSON<T>::value)>::type
+    generate(const T *v) {
+        generate(v != nullptr);
+        if (v) generate(*v);
+    }
+
+    template <typename T, size_t N>
+    void generate(const T (&v)[N]) {
+        for (size_t i = 0; i < N; i++) generate(v[i]);
+    }
+
+    template <typename T>
+    BinaryWriter &operator<<(const T &v) {
+        generate(v);
+        return *this;
+    }
+};
+
+#endif /* IR_BINARY_WRITER_H_ */
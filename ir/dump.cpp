@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <set>
 
+#include "ir/hash_cons.h"
 #include "ir/ir.h"
 #include "ir/node.h"
 #include "ir/visitor.h"
@@ -74,6 +75,7 @@ class IRDumper : public Inspector {
 
 void dump(std::ostream &out, const IR::Node *n, unsigned maxdepth) {
     n->apply(IRDumper(out, maxdepth, nullptr, false));
+    if (IR::HashCons::isEnabled()) out << IR::HashCons::stats() << std::endl;
 }
 void dump(std::ostream &out, const IR::Node *n) { dump(out, n, ~0U); }
 void dump(const IR::Node *n, unsigned maxdepth) { dump(std::cout, n, maxdepth); }
@@ -0,0 +1,119 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/hash_cons.h"
+
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <tuple>
+
+#include "ir/ir.h"
+#include "lib/arena.h"
+
+namespace IR {
+
+namespace {
+
+/// Identifies where a node comes from: the input it was parsed from and the position in
+/// it, and the file, line and column of a source position loaded from JSON.  Two inputs
+/// may well have a literal at the same position.
+using Source = std::tuple<const Util::InputSources *, Util::SourcePosition, Util::SourcePosition,
+                          cstring, int, int, cstring>;
+
+Source source(const Util::SourceInfo &srcInfo) {
+    return std::make_tuple(srcInfo.getSources(), srcInfo.getStart(), srcInfo.getEnd(),
+                           srcInfo.filename, srcInfo.line, srcInfo.column, srcInfo.srcBrief);
+}
+
+struct Tables {
+    bool enabled = false;
+    /// Guards the statistics and the maps, which passes may use from worker threads.
+    std::mutex lock;
+    HashCons::Stats stats;
+    std::map<std::tuple<const Type *, big_int, unsigned, bool, Source>, const Constant *>
+        constants;
+    std::map<std::tuple<bool, Source>, const BoolLiteral *> bools;
+    std::map<std::tuple<cstring, Source>, const StringLiteral *> strings;
+};
+
+Tables &tables() {
+    static Tables t;
+    return t;
+}
+
+/// Looks up @key in @map and creates the node with @make on a miss.  When hash-consing
+/// is disabled, this only calls @make and touches no shared state.
+template <class Map, class Key, class Make>
+auto lookup(Map &map, Key &&key, Make make) -> decltype(make()) {
+    auto &t = tables();
+    if (!t.enabled) return make();
+    std::lock_guard<std::mutex> guard(t.lock);
+    t.stats.requests++;
+    auto &result = map[std::forward<Key>(key)];
+    if (result != nullptr) {
+        t.stats.shared++;
+        return result;
+    }
+    // Cached nodes outlive any arena.
+    Util::ArenaScope global(nullptr);
+    result = make();
+    return result;
+}
+
+}  // namespace
+
+void HashCons::enable(bool enabled) { tables().enabled = enabled; }
+
+bool HashCons::isEnabled() { return tables().enabled; }
+
+void HashCons::clear() {
+    auto &t = tables();
+    std::lock_guard<std::mutex> guard(t.lock);
+    t.stats = Stats();
+    t.constants.clear();
+    t.bools.clear();
+    t.strings.clear();
+}
+
+HashCons::Stats HashCons::stats() {
+    auto &t = tables();
+    std::lock_guard<std::mutex> guard(t.lock);
+    return t.stats;
+}
+
+const Constant *HashCons::constant(const Util::SourceInfo &srcInfo, const Type *type, big_int v,
+                                   unsigned base, bool noWarning) {
+    return lookup(tables().constants, std::make_tuple(type, v, base, noWarning, source(srcInfo)),
+                  [&]() { return new Constant(srcInfo, type, v, base, noWarning); });
+}
+
+const BoolLiteral *HashCons::boolLiteral(const Util::SourceInfo &srcInfo, bool value) {
+    return lookup(tables().bools, std::make_tuple(value, source(srcInfo)),
+                  [&]() { return new BoolLiteral(srcInfo, Type_Boolean::get(), value); });
+}
+
+const StringLiteral *HashCons::stringLiteral(const Util::SourceInfo &srcInfo, cstring value) {
+    return lookup(tables().strings, std::make_tuple(value, source(srcInfo)),
+                  [&]() { return new StringLiteral(srcInfo, Type_String::get(), value); });
+}
+
+std::ostream &operator<<(std::ostream &out, const HashCons::Stats &stats) {
+    return out << "hash-consing: " << stats.shared << " of " << stats.requests
+               << " leaf expression allocations avoided";
+}
+
+}  // namespace IR
@@ -0,0 +1,70 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_HASH_CONS_H_
+#define IR_HASH_CONS_H_
+
+#include <cstdint>
+#include <iosfwd>
+
+#include "lib/big_int_util.h"
+#include "lib/cstring.h"
+#include "lib/source_file.h"
+
+namespace IR {
+
+class BoolLiteral;
+class Constant;
+class StringLiteral;
+class Type;
+
+/// Optional hash-consing factory for immutable leaf expressions.  When enabled, requests
+/// for a literal that is structurally equal to one created earlier (same type object,
+/// value and source: input sources and position, or the file, line and column of a source
+/// position loaded from JSON) return the existing node instead of allocating a new one.
+/// When disabled, every request allocates a fresh node, exactly like calling `new`.
+///
+/// Path and member expressions are deliberately not shared: ReferenceMap and TypeMap
+/// are keyed by node pointer, and the same name may resolve differently in different
+/// scopes.
+class HashCons {
+ public:
+    /// Only requests made while hash-consing is enabled are counted.
+    struct Stats {
+        /// Number of nodes requested from the factory.
+        uint64_t requests = 0;
+        /// Number of requests answered with an existing node.
+        uint64_t shared = 0;
+    };
+
+    static void enable(bool enabled = true);
+    static bool isEnabled();
+    /// Drop all cached nodes and reset the statistics.
+    static void clear();
+    /// @returns a snapshot of the statistics.
+    static Stats stats();
+
+    static const Constant *constant(const Util::SourceInfo &srcInfo, const Type *type, big_int v,
+                                    unsigned base = 10, bool noWarning = false);
+    static const BoolLiteral *boolLiteral(const Util::SourceInfo &srcInfo, bool value);
+    static const StringLiteral *stringLiteral(const Util::SourceInfo &srcInfo, cstring value);
+};
+
+std::ostream &operator<<(std::ostream &out, const HashCons::Stats &stats);
+
+}  // namespace IR
+
+#endif /* IR_HASH_CONS_H_ */
@@ -27,6 +27,7 @@ limitations under the License.
 #include "lib/safe_vector.h"
 
 class JSONLoader;
+class BinaryLoader;
 
 namespace IR {
 
@@ -81,6 +82,7 @@ class IndexedVector : public Vector<T> {
     }
     explicit IndexedVector(const Vector<T> &a) { insert(Vector<T>::end(), a.begin(), a.end()); }
     explicit IndexedVector(JSONLoader &json);
+    explicit IndexedVector(BinaryLoader &bin);
 
     void clear() {
         IR::Vector<T>::clear();
@@ -200,6 +202,8 @@ class IndexedVector : public Vector<T> {
 
     void toJSON(JSONGenerator &json) const override;
     static IndexedVector<T> *fromJSON(JSONLoader &json);
+    void toBinary(BinaryWriter &bin) const override;
+    static IndexedVector<T> *fromBinary(BinaryLoader &bin);
     void validate() const override {
         if (invalid) return;  // don't crash the compiler because an error happened
         for (auto el : *this) {
@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef IR_IR_INLINE_H_
 #define IR_IR_INLINE_H_
 
+#include "ir/binary_writer.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
 #include "ir/json_generator.h"
@@ -147,6 +148,11 @@ void IR::Vector<T>::toJSON(JSONGenerator &json) const {
     }
     json << "]";
 }
+template <class T>
+void IR::Vector<T>::toBinary(BinaryWriter &bin) const {
+    Node::toBinary(bin);
+    bin << vec;
+}
 
 std::ostream &operator<<(std::ostream &out, const IR::Vector<IR::Expression> &v);
 
@@ -196,6 +202,11 @@ void IR::IndexedVector<T>::toJSON(JSONGenerator &json) const {
     }
     json << "}";
 }
+template <class T>
+void IR::IndexedVector<T>::toBinary(BinaryWriter &bin) const {
+    Vector<T>::toBinary(bin);
+    bin << declarations;
+}
 IRNODE_DEFINE_APPLY_OVERLOAD(IndexedVector, template <class T>, <T>)
 
 #include "lib/ordered_map.h"
@@ -287,6 +298,14 @@ void IR::NameMap<T, MAP, COMP, ALLOC>::toJSON(JSONGenerator &json) const {
     }
     json << "}";
 }
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+void IR::NameMap<T, MAP, COMP, ALLOC>::toBinary(BinaryWriter &bin) const {
+    Node::toBinary(bin);
+    bin.writeUnsigned(symbols.size());
+    for (auto &k : symbols) bin << k.first << k.second;
+}
 
 template <class KEY, class VALUE,
           template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
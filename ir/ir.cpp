@@ -192,6 +192,29 @@ const IR::Path *ActionListElement::getPath() const {
     BUG("%1%: unexpected expression", expression);
 }
 
+/// @returns true if @p expression is an integer or boolean literal.
+static bool isLiteralValue(const Expression *expression) {
+    return expression->is<Constant>() || expression->is<BoolLiteral>();
+}
+
+bool Entry::isLiteral() const {
+    if (priority != nullptr && !priority->is<Constant>()) return false;
+    for (auto key : keys->components) {
+        if (key->is<DefaultExpression>() || isLiteralValue(key)) continue;
+        if (auto mask = key->to<Mask>()) {
+            if (isLiteralValue(mask->left) && isLiteralValue(mask->right)) continue;
+        } else if (auto range = key->to<Range>()) {
+            if (isLiteralValue(range->left) && isLiteralValue(range->right)) continue;
+        }
+        return false;
+    }
+    auto call = action->to<MethodCallExpression>();
+    if (call == nullptr || !call->method->is<PathExpression>()) return false;
+    for (auto arg : *call->arguments)
+        if (!isLiteralValue(arg->expression)) return false;
+    return true;
+}
+
 const Type_Method *P4Table::getApplyMethodType() const {
     // Synthesize a new type for the return
     auto actions = properties->getProperty(IR::TableProperties::actionsPropertyName);
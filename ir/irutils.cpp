@@ -4,11 +4,15 @@
 #include <map>
 #include <tuple>
 #include <vector>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 
 #include "ir/indexed_vector.h"
 #include "ir/ir.h"
 #include "ir/vector.h"
 #include "ir/visitor.h"
+#include "lib/arena.h"
 #include "lib/exceptions.h"
 #include "lib/rtti.h"
 
@@ -42,9 +46,14 @@ const Constant *getConstant(const Type *type, big_int v, const Util::SourceInfo
     // Constants are interned. Keys in the intern map are pairs of types and values.
     using key_t = std::tuple<int, RTTI::TypeId, bool, big_int>;
     static std::map<key_t, const Constant *> CONSTANTS;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::lock_guard<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
 
     auto *&result = CONSTANTS[{tb->width_bits(), type->typeId(), tb->isSigned, v}];
     if (result == nullptr) {
+        Util::ArenaScope global(nullptr);
         result = new Constant(srcInfo, tb, v);
     }
 
@@ -64,9 +73,14 @@ const IR::Constant *getMaxValueConstant(const Type *t, const Util::SourceInfo &s
 const BoolLiteral *getBoolLiteral(bool value, const Util::SourceInfo &srcInfo) {
     // Boolean literals are interned.
     static std::map<bool, const BoolLiteral *> LITERALS;
+#ifdef MULTITHREAD
+    static std::mutex lock;
+    std::lock_guard<std::mutex> acquire(lock);
+#endif  // MULTITHREAD
 
     auto *&result = LITERALS[value];
     if (result == nullptr) {
+        Util::ArenaScope global(nullptr);
         result = new BoolLiteral(srcInfo, Type::Boolean::get(), value);
     }
     return result;
@@ -78,11 +78,9 @@ class JSONLoader {
             if (node_refs.find(id) == node_refs.end()) {
                 if (auto fn = get(IR::unpacker_table, json->as<JsonObject>().get_type())) {
                     node_refs[id] = fn(*this);
-                    // Creating JsonObject from source_info read from jsonFile
-                    // and setting SourceInfo for each node
-                    // when "--fromJSON" flag is used
-                    JsonObject *obj = new JsonObject(json->as<JsonObject>().get_sourceJson());
-                    if (obj->hasSrcInfo() == true) {
+                    // Setting SourceInfo for each node from the source_info read from
+                    // jsonFile when "--fromJSON" flag is used
+                    if (const auto *obj = json->as<JsonObject>().get_sourceInfo()) {
                         node_refs[id]->srcInfo =
                             Util::SourceInfo(obj->get_filename(), obj->get_line(),
                                              obj->get_column(), obj->get_sourceFragment());
@@ -218,24 +216,33 @@ class JSONLoader {
     }
     void unpack_json(big_int &v) { v = json->as<JsonNumber>().val; }
     void unpack_json(cstring &v) {
-        std::string tmp = json->as<JsonString>();
-        std::string::size_type p = 0;
-        while ((p = tmp.find('\\', p)) != std::string::npos) {
-            tmp.erase(p, 1);
-            switch (tmp[p]) {
-                case 'n':
-                    tmp[p] = '\n';
-                    break;
-                case 'r':
-                    tmp[p] = '\r';
-                    break;
-                case 't':
-                    tmp[p] = '\t';
-                    break;
+        if (json->is<JsonNull>()) return;
+        const std::string &escaped = json->as<JsonString>();
+        if (escaped.find('\\') == std::string::npos) {
+            v = escaped;
+            return;
+        }
+        std::string tmp;
+        tmp.reserve(escaped.size());
+        for (size_t p = 0; p < escaped.size(); p++) {
+            char c = escaped[p];
+            if (c == '\\') {
+                if (++p == escaped.size()) break;
+                switch (c = escaped[p]) {
+                    case 'n':
+                        c = '\n';
+                        break;
+                    case 'r':
+                        c = '\r';
+                        break;
+                    case 't':
+                        c = '\t';
+                        break;
+                }
             }
-            p++;
+            tmp += c;
         }
-        if (!json->is<JsonNull>()) v = tmp;
+        v = tmp;
     }
     void unpack_json(IR::ID &v) {
         if (!json->is<JsonNull>()) v.name = json->as<JsonString>();
@@ -16,11 +16,20 @@ limitations under the License.
 
 #include "ir/json_parser.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <cctype>
+#include <charconv>
+#include <cstdint>
 #include <iostream>
 #include <list>
 #include <utility>
 
+#include "lib/error.h"
+
 int JsonObject::get_id() const {
     auto it = find("Node_ID");
     if (it == end()) return -1;
@@ -79,6 +88,12 @@ JsonObject JsonObject::get_sourceJson() const {
     return it->second->as<JsonObject>();
 }
 
+const JsonObject *JsonObject::get_sourceInfo() const {
+    auto it = find("Source_Info");
+    if (it == end()) return nullptr;
+    return it->second->to<JsonObject>();
+}
+
 // Hack to make << operator work multi-threaded
 static thread_local int level = 0;
 
@@ -222,3 +237,241 @@ std::istream &operator>>(std::istream &in, JsonData *&json) {
     }
     return in;
 }
+
+namespace {
+
+/// Parses a JSON text iteratively. The closing brackets of the open objects and arrays are kept
+/// on a stack, so deeply nested IR dumps do not exhaust the call stack.
+class JsonReader {
+    const char *pos;
+    const char *end;
+    JsonHandler &handler;
+    /// The closing characters of the open objects and arrays, innermost last.
+    std::vector<char> open;
+
+    /// The outcome of a parsing step.
+    enum class Step { Error, ExpectValue, ValueDone };
+
+    void skipSpace() {
+        while (pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) ++pos;
+    }
+
+    /// Reads the string starting at the opening quote at @pos into @value.
+    bool readString(std::string_view &value) {
+        const char *start = ++pos;
+        while (pos != end && *pos != '"') {
+            if (*pos == '\\' && ++pos == end) return false;
+            ++pos;
+        }
+        if (pos == end) return false;
+        value = std::string_view(start, pos - start);
+        ++pos;
+        return true;
+    }
+
+    bool readLiteral(std::string_view word) {
+        if (static_cast<size_t>(end - pos) < word.size() ||
+            std::string_view(pos, word.size()) != word)
+            return false;
+        pos += word.size();
+        return true;
+    }
+
+    /// Reads the key of an object member and the following colon.
+    bool readKey() {
+        skipSpace();
+        std::string_view name;
+        if (pos == end || *pos != '"' || !readString(name)) return false;
+        handler.key(name);
+        skipSpace();
+        if (pos == end || *pos != ':') return false;
+        ++pos;
+        return true;
+    }
+
+    /// Reads a scalar, or the start of an object or array and its first key.
+    Step readValue() {
+        skipSpace();
+        if (pos == end) return Step::Error;
+        switch (*pos) {
+            case '{':
+                ++pos;
+                handler.startObject();
+                skipSpace();
+                if (pos != end && *pos == '}') {
+                    ++pos;
+                    handler.endObject();
+                    return Step::ValueDone;
+                }
+                open.push_back('}');
+                return readKey() ? Step::ExpectValue : Step::Error;
+            case '[':
+                ++pos;
+                handler.startArray();
+                skipSpace();
+                if (pos != end && *pos == ']') {
+                    ++pos;
+                    handler.endArray();
+                    return Step::ValueDone;
+                }
+                open.push_back(']');
+                return Step::ExpectValue;
+            case '"': {
+                std::string_view value;
+                if (!readString(value)) return Step::Error;
+                handler.string(value);
+                return Step::ValueDone;
+            }
+            case 't':
+                if (!readLiteral("true")) return Step::Error;
+                handler.boolean(true);
+                return Step::ValueDone;
+            case 'f':
+                if (!readLiteral("false")) return Step::Error;
+                handler.boolean(false);
+                return Step::ValueDone;
+            case 'n':
+                if (!readLiteral("null")) return Step::Error;
+                handler.null();
+                return Step::ValueDone;
+            default: {
+                const char *start = pos;
+                if (*pos == '-') ++pos;
+                const char *digits = pos;
+                while (pos != end && isdigit(static_cast<unsigned char>(*pos))) ++pos;
+                if (pos == digits) return Step::Error;
+                handler.number(std::string_view(start, pos - start));
+                return Step::ValueDone;
+            }
+        }
+    }
+
+    /// Reads the separators and closing brackets which follow a value, up to the next value.
+    Step readNext() {
+        while (!open.empty()) {
+            skipSpace();
+            if (pos == end) return Step::Error;
+            if (*pos == ',') {
+                ++pos;
+                if (open.back() == '}' && !readKey()) return Step::Error;
+                return Step::ExpectValue;
+            }
+            if (*pos != open.back()) return Step::Error;
+            ++pos;
+            if (open.back() == '}')
+                handler.endObject();
+            else
+                handler.endArray();
+            open.pop_back();
+        }
+        return Step::ValueDone;
+    }
+
+ public:
+    JsonReader(std::string_view text, JsonHandler &handler)
+        : pos(text.data()), end(text.data() + text.size()), handler(handler) {}
+
+    bool parse() {
+        while (true) {
+            auto step = readValue();
+            if (step == Step::Error) return false;
+            if (step == Step::ExpectValue) continue;
+            step = readNext();
+            if (step == Step::Error) return false;
+            if (step == Step::ValueDone) break;
+        }
+        skipSpace();
+        return pos == end;
+    }
+};
+
+/// Builds the JsonData tree of the parsed events. Containers are created empty and filled in
+/// place, so no object or vector is copied.
+class JsonDataBuilder : public JsonHandler {
+    /// The open objects and arrays, innermost last. Exactly one of both is set.
+    struct Open {
+        JsonObject *object;
+        JsonVector *vector;
+    };
+    std::vector<Open> open;
+    std::string pendingKey;
+
+    void add(JsonData *value) {
+        if (open.empty()) {
+            result = value;
+        } else if (auto *object = open.back().object) {
+            // Like the stream parser, a repeated key replaces the previous value.
+            (*object)[pendingKey] = value;
+        } else {
+            open.back().vector->push_back(value);
+        }
+    }
+
+ public:
+    JsonData *result = nullptr;
+
+    void startObject() override {
+        auto *object = new JsonObject();
+        add(object);
+        open.push_back({object, nullptr});
+    }
+    void key(std::string_view name) override { pendingKey.assign(name.data(), name.size()); }
+    void endObject() override { open.pop_back(); }
+    void startArray() override {
+        auto *vector = new JsonVector();
+        add(vector);
+        open.push_back({nullptr, vector});
+    }
+    void endArray() override { open.pop_back(); }
+    void string(std::string_view value) override {
+        add(new JsonString(value));
+    }
+    void number(std::string_view value) override {
+        // Most numbers are node ids and source positions, which fit into 64 bits.
+        int64_t small = 0;
+        auto [last, error] = std::from_chars(value.data(), value.data() + value.size(), small);
+        if (error == std::errc() && last == value.data() + value.size())
+            add(new JsonNumber(big_int(small)));
+        else
+            add(new JsonNumber(big_int(std::string(value.data(), value.size()))));
+    }
+    void boolean(bool value) override { add(new JsonBoolean(value)); }
+    void null() override { add(new JsonNull()); }
+};
+
+}  // namespace
+
+bool parseJson(std::string_view text, JsonHandler &handler) {
+    return JsonReader(text, handler).parse();
+}
+
+JsonData *parseJsonData(std::string_view text) {
+    JsonDataBuilder builder;
+    if (!parseJson(text, builder)) return nullptr;
+    return builder.result;
+}
+
+JsonData *loadJsonFile(cstring filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ::error(ErrorType::ERR_IO, "%s: No such file or directory.", filename);
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::error(ErrorType::ERR_IO, "%s: Not valid json input file", filename);
+        close(fd);
+        return nullptr;
+    }
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        ::error(ErrorType::ERR_IO, "Can't map %s", filename);
+        return nullptr;
+    }
+    // The tree copies what it keeps, so the file is unmapped as soon as it is parsed.
+    auto *json = parseJsonData(std::string_view(static_cast<const char *>(data), st.st_size));
+    munmap(data, st.st_size);
+    if (json == nullptr) ::error(ErrorType::ERR_IO, "%s: Not valid json input file", filename);
+    return json;
+}
@@ -3,6 +3,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "lib/big_int_util.h"
@@ -45,6 +46,7 @@ class JsonString : public JsonData, public std::string {
     JsonString() {}
     JsonString(const std::string &s) : std::string(s) {}  // NOLINT(runtime/explicit)
     JsonString(const char *s) : std::string(s) {}         // NOLINT(runtime/explicit)
+    explicit JsonString(std::string_view s) : std::string(s) {}
     JsonString(const JsonString &) = default;
     JsonString(JsonString &&) = default;
     JsonString &operator=(const JsonString &) & = default;
@@ -81,6 +83,8 @@ class JsonObject : public JsonData, public ordered_map<std::string, JsonData *>
     int get_line() const;
     int get_column() const;
     JsonObject get_sourceJson() const;
+    /// @returns the "Source_Info" member without copying it, or nullptr if there is none.
+    const JsonObject *get_sourceInfo() const;
     bool hasSrcInfo() { return _hasSrcInfo; }
     void setSrcInfo(bool value) { _hasSrcInfo = value; }
 
@@ -96,4 +100,36 @@ std::string getIndent(int l);
 std::ostream &operator<<(std::ostream &out, JsonData *json);
 std::istream &operator>>(std::istream &in, JsonData *&json);
 
+/// Receives the events of parseJson, in document order. The views point into the parsed text
+/// and are only valid during the call. Strings are passed as they appear between the quotes,
+/// with their escape sequences, like the strings of a JsonString.
+class JsonHandler {
+ public:
+    virtual ~JsonHandler() = default;
+    virtual void startObject() = 0;
+    virtual void key(std::string_view name) = 0;
+    virtual void endObject() = 0;
+    virtual void startArray() = 0;
+    virtual void endArray() = 0;
+    virtual void string(std::string_view value) = 0;
+    /// @value is an integer, optionally preceded by a minus sign.
+    virtual void number(std::string_view value) = 0;
+    virtual void boolean(bool value) = 0;
+    virtual void null() = 0;
+};
+
+/// Parses the single JSON value in @text without recursion and without copying it, and reports
+/// it to @handler. Numbers must be integers, as in the IR dumps of JSONGenerator.
+/// @returns false if @text is not valid; @handler may have received some events by then.
+bool parseJson(std::string_view text, JsonHandler &handler);
+
+/// Parses @text into a JsonData tree. @returns nullptr if @text is not valid.
+JsonData *parseJsonData(std::string_view text);
+
+/// Maps @filename into memory and parses it into a JsonData tree. Reports an error and
+/// @returns nullptr if the file can not be read or is not valid. This saves reading the file
+/// through a stream, but not the tree: it holds copies of all keys and strings, since
+/// JSONLoader looks up the members of IR nodes in it by name.
+JsonData *loadJsonFile(cstring filename);
+
 #endif /* IR_JSON_PARSER_H_ */
@@ -23,10 +23,13 @@ limitations under the License.
 // use in combination with "raise" below
 // #include <csignal>
 
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
 #include "ir/declaration.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
 #include "lib/indent.h"
 #include "lib/json.h"
 #include "lib/log.h"
@@ -45,13 +48,33 @@ void IR::Node::traceCreation() const {
     LOG5("Created node " << id);
 }
 
+#ifdef MULTITHREAD
+std::atomic<int> IR::Node::currentId(0);
+#else
 int IR::Node::currentId = 0;
+#endif  // MULTITHREAD
 
 void IR::Node::toJSON(JSONGenerator &json) const {
     json << json.indent << "\"Node_ID\" : " << id << "," << std::endl
          << json.indent << "\"Node_Type\" : " << node_type_name();
 }
 
+void *IR::Node::operator new(size_t size) {
+#if HAVE_IR_ARENA
+    if (auto *arena = Util::Arena::current()) return arena->allocate(size);
+#endif
+    return ::operator new(size);
+}
+
+void IR::Node::operator delete(void *ptr) {
+#if HAVE_IR_ARENA
+    // Arena memory is released in bulk, also once the arena is no longer current.
+    if (auto *arena = Util::Arena::current(); arena && arena->contains(ptr)) return;
+    if (Util::IRArena::owns(ptr)) return;
+#endif
+    ::operator delete(ptr);
+}
+
 IR::Node::Node(JSONLoader &json) : id(-1) {
     json.load("Node_ID", id);
     if (id < 0)
@@ -61,6 +84,66 @@ IR::Node::Node(JSONLoader &json) : id(-1) {
     clone_id = id;
 }
 
+void IR::Node::toBinary(BinaryWriter &bin) const {
+    bin << id;
+    if (bin.withSourceInfo() && srcInfo.isValid() && bin.inputSources() != nullptr &&
+        srcInfo.getSources() == bin.inputSources()) {
+        const auto &start = srcInfo.getStart();
+        const auto &end = srcInfo.getEnd();
+        bin.writeUnsigned(BinaryWriter::SourceRange);
+        bin << start.getLineNumber() << start.getColumnNumber() << end.getLineNumber()
+            << end.getColumnNumber();
+        return;
+    }
+    // Other source positions are stored the same way as in JSON, so that a node read
+    // back reports the same file, line and fragment.
+    Util::SourceInfo si = srcInfo;
+    unsigned lineNumber, columnNumber;
+    cstring fName = bin.withSourceInfo()
+                        ? prepareSourceInfoForJSON(si, &lineNumber, &columnNumber)
+                        : cstring();
+    if (fName != nullptr) {
+        bin.writeUnsigned(BinaryWriter::SourceFragment);
+        bin << fName << int(lineNumber) << int(columnNumber) << si.toBriefSourceFragment();
+    } else if (bin.withSourceInfo() && srcInfo.line != -1) {
+        bin.writeUnsigned(BinaryWriter::SourceFragment);
+        bin << srcInfo.filename << srcInfo.line << srcInfo.column << srcInfo.srcBrief;
+    } else {
+        bin.writeUnsigned(BinaryWriter::NoSourceInfo);
+    }
+}
+
+IR::Node::Node(BinaryLoader &bin) : id(-1) {
+    bin.load(id);
+    if (id < 0)
+        id = currentId++;
+    else if (id >= currentId)
+        currentId = id + 1;
+    clone_id = id;
+    switch (bin.readUnsigned()) {
+        case BinaryWriter::NoSourceInfo:
+            break;
+        case BinaryWriter::SourceFragment: {
+            cstring filename, srcBrief;
+            int line = 0, column = 0;
+            bin >> filename >> line >> column >> srcBrief;
+            srcInfo = Util::SourceInfo(filename, line, column, srcBrief);
+            break;
+        }
+        case BinaryWriter::SourceRange: {
+            unsigned startLine = 0, startColumn = 0, endLine = 0, endColumn = 0;
+            bin >> startLine >> startColumn >> endLine >> endColumn;
+            if (bin.inputSources() != nullptr)
+                srcInfo = Util::SourceInfo(bin.inputSources(),
+                                           Util::SourcePosition(startLine, startColumn),
+                                           Util::SourcePosition(endLine, endColumn));
+            break;
+        }
+        default:
+            BinaryLoader::corrupt("bad source information");
+    }
+}
+
 // Abbreviated debug print
 cstring IR::dbp(const IR::INode *node) {
     std::stringstream str;
@@ -17,7 +17,11 @@ limitations under the License.
 #ifndef IR_NODE_H_
 #define IR_NODE_H_
 
+#include <cstddef>
 #include <iosfwd>
+#ifdef MULTITHREAD
+#include <atomic>
+#endif  // MULTITHREAD
 
 #include "ir-tree-macros.h"
 #include "ir/gen-tree-macro.h"
@@ -33,6 +37,8 @@ class Modifier;
 class Transform;
 class JSONGenerator;
 class JSONLoader;
+class BinaryWriter;
+class BinaryLoader;
 
 namespace Util {
 class JsonObject;
@@ -65,6 +71,7 @@ class INode : public Util::IHasSourceInfo, public IHasDbPrint, public ICastable
     virtual const Node *getNode() const = 0;
     virtual Node *getNode() = 0;
     virtual void toJSON(JSONGenerator &) const = 0;
+    virtual void toBinary(BinaryWriter &) const = 0;
     virtual cstring node_type_name() const = 0;
     virtual void validate() const {}
     virtual const Annotation *getAnnotation(cstring) const { return nullptr; }
@@ -106,7 +113,11 @@ class Node : public virtual INode {
     Node &operator=(Node &&) = default;
 
  protected:
+#ifdef MULTITHREAD
+    static std::atomic<int> currentId;
+#else
     static int currentId;
+#endif  // MULTITHREAD
     void traceVisit(const char *visitor) const;
     virtual void visit_children(Visitor &) {}
     virtual void visit_children(Visitor &) const {}
@@ -130,6 +141,9 @@ class Node : public virtual INode {
         traceCreation();
     }
     virtual ~Node() {}
+    /// Nodes come from the current Util::Arena when built with ENABLE_IR_ARENA.
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
     const Node *apply(Visitor &v, const Visitor_Context *ctxt = nullptr) const;
     const Node *apply(Visitor &&v, const Visitor_Context *ctxt = nullptr) const {
         return apply(v, ctxt);
@@ -144,8 +158,10 @@ class Node : public virtual INode {
     static cstring static_type_name() { return "Node"; }
     virtual int num_children() { return 0; }
     explicit Node(JSONLoader &json);
+    explicit Node(BinaryLoader &bin);
     cstring toString() const override { return node_type_name(); }
     void toJSON(JSONGenerator &json) const override;
+    void toBinary(BinaryWriter &bin) const override;
     void sourceInfoToJSON(JSONGenerator &json) const;
     Util::JsonObject *sourceInfoJsonObj() const;
     /* operator== does a 'shallow' comparison, comparing two Node subclass objects for equality,
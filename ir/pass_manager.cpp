@@ -16,21 +16,45 @@ limitations under the License.
 
 #include "pass_manager.h"
 
+#include <sys/resource.h>
+
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <ostream>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <utility>
 
 #include "ir/dump.h"
+#include "ir/hash_cons.h"
+#include "ir/ir.h"
 #include "ir/node.h"
+#include "ir/pass_profile.h"
 #include "ir/visitor.h"
+#include "lib/arena.h"
 #include "lib/error.h"
 #include "lib/gc.h"
 #include "lib/indent.h"
 #include "lib/log.h"
 #include "lib/n4.h"
+#include "lib/stringify.h"
+#include "lib/worker_pool.h"
+
+unsigned PassManager::parallelism = 0;
+thread_local unsigned PassManager::nesting = 0;
+thread_local uint64_t PassManager::outermostRuns = 0;
+
+Visitor::profile_t PassManager::init_apply(const IR::Node *root) {
+    running = true;
+    if (nesting == 0) ++outermostRuns;
+    if (fixedObjectsRun != outermostRuns) {
+        fixedObjects.clear();
+        fixedObjectsRun = outermostRuns;
+    }
+    return Visitor::init_apply(root);
+}
 
 void PassManager::removePasses(const std::vector<cstring> &exclude) {
     for (auto it : exclude) {
@@ -65,6 +89,10 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
         explicit indent_nesting(indent_t &i) : indent(i) { ++indent; }
         ~indent_nesting() { --indent; }
     } nest_log_indent(log_indent);
+    struct running_nesting {
+        running_nesting() { ++nesting; }
+        ~running_nesting() { --nesting; }
+    } nest_running;
 
     early_exit_flag = false;
     unsigned initial_error_count = ::errorCount();
@@ -79,11 +107,31 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
         try {
             try {
                 LOG1(log_indent << name() << " invoking " << v->name());
-                auto after = program->apply(**it);
+                auto *arena = Util::Arena::current();
+                size_t arenaBefore = arena ? arena->bytesInUse() : 0;
+                const IR::Node *after = nullptr;
+                {
+                    PassProfiler::Scope profile(name(), v->name());
+                    if (dynamic_cast<PerDeclarationSafe *>(v))
+                        after = applyPerDeclaration(v, program);
+                    else
+                        after = program->apply(**it);
+                }
                 if (LOGGING(3)) {
                     size_t maxmem, mem = gc_mem_inuse(&maxmem);  // triggers gc
                     LOG3(log_indent << "heap after " << v->name() << ": in use " << n4(mem)
                                     << "B, max " << n4(maxmem) << "B");
+                    if (IR::HashCons::isEnabled()) LOG3(log_indent << IR::HashCons::stats());
+                }
+                if (arena && LOGGING(2)) {
+                    // Arena memory is only released in bulk, so the bytes in use only grow;
+                    // the high-water mark of the process tells what the passes really needed.
+                    struct rusage usage {};
+                    getrusage(RUSAGE_SELF, &usage);
+                    LOG2(log_indent << "arena after " << v->name() << ": allocated "
+                                    << n4(arena->bytesInUse() - arenaBefore) << "B, in use "
+                                    << n4(arena->bytesInUse()) << "B, peak RSS "
+                                    << n4(static_cast<size_t>(usage.ru_maxrss) * 1024) << "B");
                 }
                 if (stop_on_error && ::errorCount() > initial_error_count) break;
                 if ((program = after) == nullptr) break;
@@ -139,6 +187,62 @@ bool PassManager::never_backtracks() {
     return true;
 }
 
+PassManager::PerDeclarationStatistics &PassManager::perDeclarationStatistics() {
+    static PerDeclarationStatistics STATISTICS;
+    return STATISTICS;
+}
+
+/// Applies the PerDeclarationSafe pass @v to every top-level object of @program using
+/// up to 'parallelism' threads of the worker pool, each object being visited by its own
+/// clone of @v.  Objects @v returned unchanged the last time are not visited again.
+/// Falls back to a plain sequential apply when @program is not a P4Program.
+const IR::Node *PassManager::applyPerDeclaration(Visitor *v, const IR::Node *program) {
+    const auto *p4program = program->to<IR::P4Program>();
+    if (p4program == nullptr) return program->apply(*v);
+
+    const auto &objects = p4program->objects;
+    auto &fixed = fixedObjects[v];
+    std::vector<size_t> todo;
+    for (size_t i = 0; i < objects.size(); ++i)
+        if (!fixed.count(objects[i])) todo.push_back(i);
+    auto &stats = perDeclarationStatistics();
+    stats.applied += todo.size();
+    stats.skipped += objects.size() - todo.size();
+
+    std::vector<const IR::Node *> results(objects.begin(), objects.end());
+    // Visitor counters are per thread; the work of each object is taken out of the
+    // counters of the thread that did it and added to ours at the end.
+    std::vector<Visitor::Counters> work(todo.size());
+    unsigned threads = std::min<size_t>(parallelism, todo.size());
+    LOG2("running " << v->name() << " on " << todo.size() << " of " << objects.size()
+                    << " objects with " << std::max(threads, 1U) << " threads");
+    Util::WorkerPool::get().run(todo.size(), threads, [&](size_t i) {
+        auto start = Visitor::counters;
+        auto *clone = v->clone();
+        results[todo[i]] = objects[todo[i]]->apply(*clone);
+        work[i] = Visitor::counters - start;
+        Visitor::counters = start;
+    });
+    for (const auto &w : work) Visitor::counters += w;
+
+    bool changed = false;
+    IR::Vector<IR::Node> newObjects;
+    std::set<const IR::Node *> unchanged;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (results[i] != objects[i])
+            changed = true;
+        else
+            unchanged.insert(objects[i]);
+        newObjects.pushBackOrAppend(results[i]);
+    }
+    fixed = std::move(unchanged);
+    if (!changed) return program;
+    auto *result = p4program->clone();
+    result->objects.clear();
+    result->objects.append(newObjects);
+    return result;
+}
+
 void PassManager::runDebugHooks(const char *visitorName, const IR::Node *program) {
     for (auto h : debugHooks) h(name(), seqNo, visitorName, program);
 }
@@ -150,7 +254,12 @@ const IR::Node *PassRepeated::apply_visitor(const IR::Node *program, const char
     while (!done) {
         LOG5("PassRepeated state is:\n" << dumpToString(program));
         running = true;
-        auto newprogram = PassManager::apply_visitor(program, name);
+        const IR::Node *newprogram = nullptr;
+        {
+            cstring iteration = cstring(this->name()) + "#" + Util::toString(iterations + 1);
+            PassProfiler::Scope profile(this->name(), iteration);
+            newprogram = PassManager::apply_visitor(program, name);
+        }
         if (program == newprogram || newprogram == nullptr) done = true;
         if (stop_on_error && ::errorCount() > initial_error_count) return program;
         iterations++;
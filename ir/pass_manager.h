@@ -17,9 +17,12 @@ limitations under the License.
 #ifndef IR_PASS_MANAGER_H_
 #define IR_PASS_MANAGER_H_
 
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <iosfwd>
+#include <map>
+#include <set>
 #include <type_traits>
 #include <vector>
 
@@ -33,6 +36,18 @@ typedef std::function<void(const char *manager, unsigned seqNo, const char *pass
                            const IR::Node *node)>
     DebugHook;
 
+/// Marker interface for passes whose effect on an IR::P4Program is the same as applying
+/// a fresh clone of the pass to each top-level object of the program independently.
+/// Such passes must implement clone() and must not share mutable state (e.g., a
+/// ReferenceMap or TypeMap) between clones.  A PassManager applies these passes to each
+/// top-level object separately, on a pool of worker threads when parallel pass
+/// execution is enabled (see PassManager::setParallelism), and skips the objects the
+/// pass already returned unchanged the last time the PassManager ran it.
+class PerDeclarationSafe {
+ public:
+    virtual ~PerDeclarationSafe() = default;
+};
+
 class PassManager : virtual public Visitor, virtual public Backtrack {
     bool early_exit_flag = false;
     mutable int never_backtracks_cache = -1;
@@ -45,10 +60,14 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
     bool running = false;
     unsigned seqNo = 0;
     void runDebugHooks(const char *visitorName, const IR::Node *node);
-    profile_t init_apply(const IR::Node *root) override {
-        running = true;
-        return Visitor::init_apply(root);
-    }
+    /// For each PerDeclarationSafe pass, the top-level objects it returned unchanged the
+    /// last time it ran.  Applying the pass to them again would not change them either.
+    /// Only kept for the duration of the outermost PassManager run: the iterations of an
+    /// enclosing PassRepeated share it, but the next run starts afresh.
+    std::map<const Visitor *, std::set<const IR::Node *>> fixedObjects;
+    uint64_t fixedObjectsRun = 0;  // the outermost run fixedObjects belongs to
+    const IR::Node *applyPerDeclaration(Visitor *v, const IR::Node *program);
+    profile_t init_apply(const IR::Node *root) override;
 
  public:
     PassManager() = default;
@@ -118,6 +137,24 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
     }
     void early_exit() { early_exit_flag = true; }
     PassManager *clone() const override { return new PassManager(*this); }
+
+    /// Set the number of worker threads used to run PerDeclarationSafe passes.
+    /// 0 or 1 disables parallel execution.  Only effective in MULTITHREAD builds.
+    static void setParallelism(unsigned threads) { parallelism = threads; }
+    static unsigned getParallelism() { return parallelism; }
+
+    /// Counts top-level objects PerDeclarationSafe passes were applied to or skipped.
+    struct PerDeclarationStatistics {
+        uint64_t applied = 0;
+        uint64_t skipped = 0;
+    };
+    static PerDeclarationStatistics &perDeclarationStatistics();
+
+ private:
+    static unsigned parallelism;
+    // The number of PassManagers running on this thread, and of outermost runs started on it.
+    static thread_local unsigned nesting;
+    static thread_local uint64_t outermostRuns;
 };
 
 template <class T>
@@ -138,8 +175,11 @@ class OnBacktrack : virtual public Visitor, virtual public Backtrack {
 };
 
 // Repeat a pass until convergence (or up to a fixed number of repeats)
+// PerDeclarationSafe passes, including those in nested PassManagers, only revisit the
+// top-level declarations they changed in the previous iteration.
 class PassRepeated : virtual public PassManager {
     unsigned repeats;  // 0 = until convergence
+
  public:
     PassRepeated() : repeats(0) {}
     explicit PassRepeated(const std::initializer_list<VisitorRef> &init, unsigned repeats = 0)
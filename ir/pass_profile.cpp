@@ -0,0 +1,160 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/pass_profile.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include "ir/visitor.h"
+#include "lib/arena.h"
+#include "lib/gc.h"
+#include "lib/json.h"
+
+cstring PassProfiler::outputFile;
+std::vector<PassProfiler::Record> PassProfiler::recorded;
+unsigned PassProfiler::depth = 0;
+
+namespace {
+
+uint64_t nowUsec() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                 origin)
+        .count();
+}
+
+uint64_t bytesAllocated() {
+    uint64_t rv = gc_total_bytes();
+    if (auto *arena = Util::Arena::current()) rv += arena->bytesInUse();
+    return rv;
+}
+
+}  // namespace
+
+PassProfiler::Scope::Scope(cstring manager, cstring pass)
+    : manager(manager), pass(pass), active(isEnabled()) {
+    if (!active) return;
+    ++depth;
+    counters = Visitor::counters;
+    bytes = bytesAllocated();
+    startUsec = nowUsec();
+}
+
+PassProfiler::Scope::~Scope() {
+    if (!active) return;
+    uint64_t end = nowUsec();
+    auto work = Visitor::counters - counters;
+    --depth;
+    recorded.push_back({manager, pass, depth, startUsec, end - startUsec, work.visited,
+                        work.cloned, work.changed, bytesAllocated() - bytes});
+}
+
+void PassProfiler::enable(cstring file) {
+    if (!isEnabled()) std::atexit(write);
+    outputFile = file;
+    Visitor::Counters::enabled = true;
+}
+
+void PassProfiler::write() {
+    if (!isEnabled()) return;
+
+    auto *passes = new Util::JsonArray();
+    auto *events = new Util::JsonArray();
+    struct Total {
+        uint64_t count = 0, usec = 0, visited = 0, cloned = 0, changed = 0, bytes = 0;
+    };
+    std::map<cstring, Total> totals;
+    for (const auto &r : recorded) {
+        auto *stats = new Util::JsonObject();
+        stats->emplace("nodes_visited", r.nodesVisited);
+        stats->emplace("nodes_cloned", r.nodesCloned);
+        stats->emplace("nodes_changed", r.nodesChanged);
+        stats->emplace("bytes_allocated", r.bytesAllocated);
+
+        auto *pass = new Util::JsonObject();
+        pass->emplace("manager", r.manager);
+        pass->emplace("pass", r.pass);
+        pass->emplace("depth", r.depth);
+        pass->emplace("start_us", r.startUsec);
+        pass->emplace("duration_us", r.durationUsec);
+        for (auto &[k, v] : *stats) pass->emplace(k, v);
+        passes->append(pass);
+
+        auto *event = new Util::JsonObject();
+        event->emplace("name", r.pass);
+        event->emplace("cat", r.manager);
+        event->emplace("ph", "X");
+        event->emplace("ts", r.startUsec);
+        event->emplace("dur", r.durationUsec);
+        event->emplace("pid", 1);
+        event->emplace("tid", 1);
+        event->emplace("args", stats);
+        events->append(event);
+
+        auto &total = totals[r.pass];
+        total.count++;
+        total.usec += r.durationUsec;
+        total.visited += r.nodesVisited;
+        total.cloned += r.nodesCloned;
+        total.changed += r.nodesChanged;
+        total.bytes += r.bytesAllocated;
+    }
+
+    std::vector<std::pair<cstring, Total>> sorted(totals.begin(), totals.end());
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto &a, const auto &b) { return a.second.usec > b.second.usec; });
+    auto *summary = new Util::JsonArray();
+    for (const auto &[name, total] : sorted) {
+        auto *entry = new Util::JsonObject();
+        entry->emplace("pass", name);
+        entry->emplace("invocations", total.count);
+        entry->emplace("total_us", total.usec);
+        entry->emplace("nodes_visited", total.visited);
+        entry->emplace("nodes_cloned", total.cloned);
+        entry->emplace("nodes_changed", total.changed);
+        entry->emplace("bytes_allocated", total.bytes);
+        summary->append(entry);
+    }
+
+    auto *report = new Util::JsonObject();
+    report->emplace("summary", summary);
+    report->emplace("passes", passes);
+    // This runs at exit, when there is no compilation context left to report errors to.
+    std::ofstream out(outputFile.c_str());
+    if (!out) {
+        std::cerr << "Could not open pass profile file " << outputFile << std::endl;
+        return;
+    }
+    report->serialize(out);
+    out << std::endl;
+
+    auto *trace = new Util::JsonObject();
+    trace->emplace("traceEvents", events);
+    trace->emplace("displayTimeUnit", "ms");
+    cstring traceFile = outputFile + ".trace.json";
+    std::ofstream traceOut(traceFile.c_str());
+    if (!traceOut) {
+        std::cerr << "Could not open pass profile file " << traceFile << std::endl;
+        return;
+    }
+    trace->serialize(traceOut);
+    traceOut << std::endl;
+}
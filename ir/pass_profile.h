@@ -0,0 +1,74 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_PASS_PROFILE_H_
+#define IR_PASS_PROFILE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ir/visitor.h"
+#include "lib/cstring.h"
+
+/// Records wall time, visitor work and allocation for every pass run by a PassManager,
+/// when enabled with --passProfile <file>.  At exit the records are written to <file>
+/// as JSON (one record per pass invocation plus a per-pass summary sorted by time) and
+/// to <file>.trace.json in the Chrome trace-event format (load it in chrome://tracing
+/// or Perfetto).
+class PassProfiler {
+ public:
+    struct Record {
+        cstring manager;
+        cstring pass;
+        unsigned depth;
+        uint64_t startUsec;
+        uint64_t durationUsec;
+        uint64_t nodesVisited;
+        uint64_t nodesCloned;
+        uint64_t nodesChanged;
+        uint64_t bytesAllocated;
+    };
+
+    /// Measures one pass invocation from construction to destruction.  Does nothing
+    /// unless profiling is enabled.
+    class Scope {
+        cstring manager;
+        cstring pass;
+        bool active;
+        uint64_t startUsec = 0;
+        Visitor::Counters counters;
+        uint64_t bytes = 0;
+
+     public:
+        Scope(cstring manager, cstring pass);
+        Scope(const Scope &) = delete;
+        ~Scope();
+    };
+
+    /// Start recording; the results are written to @file when the process exits.
+    static void enable(cstring file);
+    static bool isEnabled() { return !outputFile.isNullOrEmpty(); }
+    static const std::vector<Record> &records() { return recorded; }
+    /// Write the JSON report and the Chrome trace now.
+    static void write();
+
+ private:
+    static cstring outputFile;
+    static std::vector<Record> recorded;
+    static unsigned depth;
+};
+
+#endif /* IR_PASS_PROFILE_H_ */
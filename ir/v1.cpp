@@ -23,17 +23,21 @@ limitations under the License.
 #include "ir/namemap.h"
 #include "ir/node.h"
 #include "ir/vector.h"
+#include "lib/arena.h"
 #include "lib/bitops.h"
 #include "lib/cstring.h"
 #include "lib/error.h"
 #include "lib/error_catalog.h"
 #include "lib/source_file.h"
 
-#define SINGLETON_TYPE(NAME)                                               \
-    const IR::Type_##NAME *IR::Type_##NAME::get() {                        \
-        static const Type_##NAME *singleton;                               \
-        if (!singleton) singleton = (new Type_##NAME(Util::SourceInfo())); \
-        return singleton;                                                  \
+#define SINGLETON_TYPE(NAME)                                          \
+    const IR::Type_##NAME *IR::Type_##NAME::get() {                   \
+        static const Type_##NAME *singleton;                          \
+        if (!singleton) {                                             \
+            Util::ArenaScope global(nullptr);                         \
+            singleton = (new Type_##NAME(Util::SourceInfo()));        \
+        }                                                             \
+        return singleton;                                             \
     }
 SINGLETON_TYPE(Block)
 SINGLETON_TYPE(Counter)
@@ -23,6 +23,7 @@ limitations under the License.
 #include "lib/safe_vector.h"
 
 class JSONLoader;
+class BinaryLoader;
 
 namespace IR {
 
@@ -46,6 +47,7 @@ class VectorBase : public Node {
 
  protected:
     explicit VectorBase(JSONLoader &json) : Node(json) {}
+    explicit VectorBase(BinaryLoader &bin) : Node(bin) {}
 
     DECLARE_TYPEINFO_WITH_TYPEID(VectorBase, NodeKind::VectorBase, Node);
 };
@@ -62,12 +64,14 @@ class Vector : public VectorBase {
     Vector(const Vector &) = default;
     Vector(Vector &&) = default;
     explicit Vector(JSONLoader &json);
+    explicit Vector(BinaryLoader &bin);
     Vector &operator=(const Vector &) = default;
     Vector &operator=(Vector &&) = default;
     explicit Vector(const T *a) { vec.emplace_back(std::move(a)); }
     explicit Vector(const safe_vector<const T *> &a) { vec.insert(vec.end(), a.begin(), a.end()); }
     Vector(const std::initializer_list<const T *> &a) : vec(a) {}
     static Vector<T> *fromJSON(JSONLoader &json);
+    static Vector<T> *fromBinary(BinaryLoader &bin);
     typedef typename safe_vector<const T *>::iterator iterator;
     typedef typename safe_vector<const T *>::const_iterator const_iterator;
     iterator begin() { return vec.begin(); }
@@ -199,6 +203,7 @@ class Vector : public VectorBase {
     virtual void parallel_visit_children(Visitor &v);
     virtual void parallel_visit_children(Visitor &v) const;
     void toJSON(JSONGenerator &json) const override;
+    void toBinary(BinaryWriter &bin) const override;
     Util::Enumerator<const T *> *getEnumerator() const { return Util::enumerate(vec); }
     template <typename S>
     Util::Enumerator<const S *> *only() const {
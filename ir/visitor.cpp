@@ -19,6 +19,9 @@ limitations under the License.
 #include <stdlib.h>
 #include <time.h>
 
+#include <array>
+#include <memory>
+
 #include "absl/container/flat_hash_map.h"
 #include "ir/ir-generated.h"
 #include "lib/hash.h"
@@ -39,6 +42,108 @@ limitations under the License.
 
 enum class VisitStatus : unsigned { New, Revisit, Busy, Done };
 
+namespace {
+
+/** @class NodeInfoTable
+ *  @brief Per-node visit state, indexed by node id.
+ *
+ *  Node ids are allocated densely, so rather than hashing node pointers the state
+ *  is kept in small pages of entries indexed by id.  Pages are allocated on first
+ *  use, as many visitors are applied only to small subtrees, and the last page used
+ *  is cached since nodes visited together were usually created together.  A new
+ *  page is only allocated while the pages are a quarter full on average, so sparse
+ *  ids (e.g., a few new nodes in a tree created long before) do not cost a page per
+ *  node.  Nodes that do not get a page, as well as distinct nodes sharing an id
+ *  (e.g., nodes read from JSON), are kept in a hash map instead; each entry records
+ *  its node so that the latter are detected.
+ */
+template <class Info>
+class NodeInfoTable {
+    static constexpr int pageBits = 6;
+    static constexpr int pageSize = 1 << pageBits;
+    struct entry_t {
+        const IR::Node *node;
+        Info info;
+    };
+    using page_t = std::array<entry_t, pageSize>;
+    absl::flat_hash_map<int, std::unique_ptr<page_t>> pages;
+    absl::flat_hash_map<const IR::Node *, Info, Util::Hash> overflow;
+    size_t inPages = 0;  // entries used in `pages`
+    mutable int lastPage = -1;
+    mutable page_t *lastEntries = nullptr;
+
+    entry_t *slot(int id, bool create) const {
+        int page = id >> pageBits;
+        if (page != lastPage) {
+            auto it = pages.find(page);
+            if (it == pages.end()) {
+                if (!create || pages.size() * pageSize >= 4 * inPages + pageSize)
+                    return nullptr;
+                auto &self = const_cast<NodeInfoTable &>(*this);
+                it = self.pages.emplace(page, std::make_unique<page_t>()).first;
+            }
+            lastPage = page;
+            lastEntries = it->second.get();
+        }
+        return &(*lastEntries)[id & (pageSize - 1)];
+    }
+
+ public:
+    /** Insert @info for @n unless @n is already present.
+     *
+     * @return the info of @n and whether it was inserted.
+     */
+    std::pair<Info *, bool> emplace(const IR::Node *n, const Info &info) {
+        if (n->id >= 0) {
+            if (auto *e = slot(n->id, true)) {
+                if (e->node == n) return {&e->info, false};
+                if (e->node == nullptr && (overflow.empty() || !overflow.count(n))) {
+                    *e = entry_t{n, info};
+                    ++inPages;
+                    return {&e->info, true};
+                }
+            }
+        }
+        auto [it, inserted] = overflow.emplace(n, info);
+        return {&it->second, inserted};
+    }
+
+    /** @return the info of @n, or nullptr if @n is not present. */
+    const Info *find(const IR::Node *n) const {
+        if (n->id >= 0) {
+            auto *e = slot(n->id, false);
+            if (e && e->node == n) return &e->info;
+        }
+        if (overflow.empty()) return nullptr;
+        auto it = overflow.find(n);
+        return it == overflow.end() ? nullptr : &it->second;
+    }
+    Info *find(const IR::Node *n) {
+        return const_cast<Info *>(static_cast<const NodeInfoTable &>(*this).find(n));
+    }
+
+    /** Remove all nodes whose info satisfies @pred. */
+    template <class Pred>
+    void erase_if(Pred pred) {
+        for (auto &page : pages)
+            for (auto &e : *page.second)
+                if (e.node && pred(e.info)) {
+                    e.node = nullptr;
+                    --inPages;
+                }
+        for (auto it = overflow.begin(); it != overflow.end();) {
+            if (pred(it->second))
+                // `overflow` is abseil map, therefore erase does not return iterator, use
+                // post-increment
+                overflow.erase(it++);
+            else
+                ++it;
+        }
+    }
+};
+
+}  // namespace
+
 /** @class Visitor::ChangeTracker
  *  @brief Assists visitors in traversing the IR.
 
@@ -55,14 +160,9 @@ class Visitor::ChangeTracker {
         bool visitOnce;
         const IR::Node *result;
     };
-    using visited_t = absl::flat_hash_map<const IR::Node *, visit_info_t, Util::Hash>;
-    visited_t visited;
+    NodeInfoTable<visit_info_t> visited;
 
  public:
-    ChangeTracker()
-        : visited(16) {}  // Pre-allocate 16 slots as usually these maps are small, but we do create
-                          // lots of them. This saves quite some time for rehashes
-
     /** Begin tracking @n during a visiting pass.  Use `finish(@n)` to mark @n as
      * visited once the pass completes.
      *
@@ -73,12 +173,12 @@ class Visitor::ChangeTracker {
      */
     [[nodiscard]] VisitStatus try_start(const IR::Node *n, bool defaultVisitOnce) {
         // Initialization
-        auto [it, inserted] = visited.emplace(n, visit_info_t{true, defaultVisitOnce, n});
+        auto [info, inserted] = visited.emplace(n, visit_info_t{true, defaultVisitOnce, n});
 
         if (!inserted) {  // We already seen this node, determine its status
-            if (it->second.visit_in_progress) return VisitStatus::Busy;
-            if (it->second.visitOnce) return VisitStatus::Done;
-            it->second.visit_in_progress = true;
+            if (info->visit_in_progress) return VisitStatus::Busy;
+            if (info->visitOnce) return VisitStatus::Done;
+            info->visit_in_progress = true;
             return VisitStatus::Revisit;
         }
 
@@ -99,10 +199,9 @@ class Visitor::ChangeTracker {
      * previously been invoked.
      */
     bool finish(const IR::Node *orig, const IR::Node *final) {
-        auto it = visited.find(orig);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
+        visit_info_t *orig_visit_info = visited.find(orig);
+        if (!orig_visit_info) BUG("visitor state tracker corrupted");
 
-        visit_info_t *orig_visit_info = &(it->second);
         orig_visit_info->visit_in_progress = false;
         if (!final) {
             orig_visit_info->result = final;
@@ -111,7 +210,7 @@ class Visitor::ChangeTracker {
             orig_visit_info->result = final;
             visited.emplace(final, visit_info_t{false, orig_visit_info->visitOnce, final});
             return true;
-        } else if (visited.count(final)) {
+        } else if (visited.find(final)) {
             // coalescing with some previously visited node, so we don't want to undo
             // the coalesce
             orig_visit_info->result = final;
@@ -126,22 +225,15 @@ class Visitor::ChangeTracker {
 
     /** Return a visitOnce flag for node @n */
     [[nodiscard]] bool shouldVisitOnce(const IR::Node *n) const {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        return it->second.visitOnce;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        return info->visitOnce;
     }
 
     /** Forget nodes that have already been visited, allowing them to be visited
      * again. */
     void revisit_visited() {
-        for (auto it = visited.begin(); it != visited.end();) {
-            if (!it->second.visit_in_progress)
-                // `visited` is abseil map, therefore erase does not return iterator, use
-                // post-increment
-                visited.erase(it++);
-            else
-                ++it;
-        }
+        visited.erase_if([](const visit_info_t &info) { return !info.visit_in_progress; });
     }
 
     /** Determine whether @n is currently being visited and the visitor has not finished
@@ -150,8 +242,8 @@ class Visitor::ChangeTracker {
      * @return true if @n is being visited and has not finished
      */
     [[nodiscard]] bool busy(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && it->second.visit_in_progress;
+        auto *info = visited.find(n);
+        return info && info->visit_in_progress;
     }
 
     /** Determine whether @n has been visited and the visitor has finished
@@ -162,8 +254,8 @@ class Visitor::ChangeTracker {
      * @return true if @n has been visited and the visitor is finished and visitOnce is true
      */
     [[nodiscard]] bool done(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && !it->second.visit_in_progress && it->second.visitOnce;
+        auto *info = visited.find(n);
+        return info && !info->visit_in_progress && info->visitOnce;
     }
 
     /** Produce the result of visiting @n.
@@ -173,9 +265,9 @@ class Visitor::ChangeTracker {
      * if `start(@n)` has not been invoked.
      */
     const IR::Node *result(const IR::Node *n) const {
-        auto it = visited.find(n);
-        if (it == visited.end()) return n;
-        return it->second.result;
+        auto *info = visited.find(n);
+        if (!info) return n;
+        return info->result;
     }
 
     /** Produce the final result of visiting @n.
@@ -184,21 +276,21 @@ class Visitor::ChangeTracker {
      * been invoked.
      */
     const IR::Node *finalResult(const IR::Node *n) const {
-        auto it = visited.find(n);
-        bool done = it != visited.end() && !it->second.visit_in_progress && it->second.visitOnce;
-        return done ? it->second.result : nullptr;
+        auto *info = visited.find(n);
+        bool done = info && !info->visit_in_progress && info->visitOnce;
+        return done ? info->result : nullptr;
     }
 
     void visitOnce(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = true;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = true;
     }
 
     void visitAgain(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = false;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = false;
     }
 };
 
@@ -214,25 +306,13 @@ class Visitor::Tracker {
     struct info_t {
         bool done, visitOnce;
     };
-    using visited_t = absl::flat_hash_map<const IR::Node *, info_t, Util::Hash>;
-    visited_t visited;
+    NodeInfoTable<info_t> visited;
 
  public:
-    Tracker()
-        : visited(16) {}  // Pre-allocate 16 slots as usually these maps are small, but we do create
-                          // lots of them. This saves quite some time for rehashes
-
     /** Forget nodes that have already been visited, allowing them to be visited
      * again. */
     void revisit_visited() {
-        for (auto it = visited.begin(); it != visited.end();) {
-            if (it->second.done)
-                // `visited` is abseil map, therefore erase does not return iterator, use
-                // post-increment
-                visited.erase(it++);
-            else
-                ++it;
-        }
+        visited.erase_if([](const info_t &info) { return info.done; });
     }
 
     /** Begin tracking @n during a visiting pass.  Use `finish(@n)` to mark @n as
@@ -246,12 +326,12 @@ class Visitor::Tracker {
      */
     [[nodiscard]] VisitStatus try_start(const IR::Node *n, bool defaultVisitOnce) {
         // Initialization
-        auto [it, inserted] = visited.emplace(n, info_t{false, defaultVisitOnce});
+        auto [info, inserted] = visited.emplace(n, info_t{false, defaultVisitOnce});
 
         if (!inserted) {  // We already seen this node, determine its status
-            if (!it->second.done) return VisitStatus::Busy;
-            if (it->second.visitOnce) return VisitStatus::Done;
-            it->second.done = false;
+            if (!info->done) return VisitStatus::Busy;
+            if (info->visitOnce) return VisitStatus::Done;
+            info->done = false;
             return VisitStatus::Revisit;
         }
 
@@ -270,10 +350,10 @@ class Visitor::Tracker {
      * previously been invoked.
      */
     void finish(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
 
-        it->second.done = true;
+        info->done = true;
     }
 
     /** Determine whether @n is currently being visited and the visitor has not finished
@@ -282,8 +362,8 @@ class Visitor::Tracker {
      * @return true if @n is being visited and has not finished
      */
     [[nodiscard]] bool busy(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && !it->second.done;
+        auto *info = visited.find(n);
+        return info && !info->done;
     }
 
     /** Determine whether @n has been visited and the visitor has finished
@@ -294,27 +374,27 @@ class Visitor::Tracker {
      * @return true if @n has been visited and the visitor is finished and visitOnce is true
      */
     [[nodiscard]] bool done(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && it->second.done && it->second.visitOnce;
+        auto *info = visited.find(n);
+        return info && info->done && info->visitOnce;
     }
 
     /** Return a visitOnce flag for node @n */
     bool shouldVisitOnce(const IR::Node *n) const {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        return it->second.visitOnce;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        return info->visitOnce;
     }
 
     void visitOnce(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = true;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = true;
     }
 
     void visitAgain(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = false;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = false;
     }
 };
 
@@ -367,8 +447,11 @@ Visitor::profile_t Transform::init_apply(const IR::Node *root) {
 void Visitor::end_apply() {}
 void Visitor::end_apply(const IR::Node *) {}
 
-static indent_t profile_indent;
-static uint64_t first_start = 0;
+bool Visitor::Counters::enabled = false;
+thread_local Visitor::Counters Visitor::counters;
+
+static thread_local indent_t profile_indent;
+static thread_local uint64_t first_start = 0;
 Visitor::profile_t::profile_t(Visitor &v_) : v(v_) {
     struct timespec ts;
 #ifdef CLOCK_MONOTONIC
@@ -486,6 +569,10 @@ const IR::Node *Modifier::apply_visitor(const IR::Node *n, const char *name) {
                 break;
             default: {  // New or Revisit
                 IR::Node *copy = n->clone();
+                if (Counters::enabled) {
+                    counters.visited++;
+                    counters.cloned++;
+                }
                 local.current.node = copy;
                 if (!dontForwardChildrenBeforePreorder) {
                     ForwardChildren forward_children(*visited);
@@ -495,7 +582,10 @@ const IR::Node *Modifier::apply_visitor(const IR::Node *n, const char *name) {
                     copy->visit_children(*this);
                     copy->apply_visitor_postorder(*this);
                 }
-                if (visited->finish(n, copy)) (n = copy)->validate();
+                if (visited->finish(n, copy)) {
+                    (n = copy)->validate();
+                    if (Counters::enabled) counters.changed++;
+                }
                 break;
             }
         }
@@ -519,6 +609,7 @@ const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
                 n->apply_visitor_revisit(*this);
                 break;
             default:  // New or Revisit
+                if (Counters::enabled) counters.visited++;
                 if (n->apply_visitor_preorder(*this)) {
                     n->visit_children(*this);
                     n->apply_visitor_postorder(*this);
@@ -551,6 +642,10 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
                 break;
             default: {  // New or Revisit
                 auto *copy = n->clone();
+                if (Counters::enabled) {
+                    counters.visited++;
+                    counters.cloned++;
+                }
                 local.current.node = copy;
                 if (!dontForwardChildrenBeforePreorder) {
                     ForwardChildren forward_children(*visited);
@@ -578,6 +673,7 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
                         // Sanity check for IR loops
                         if (status == VisitStatus::Busy) BUG("IR loop detected ");
                         local.current.node = copy = preorder_result->clone();
+                        if (Counters::enabled) counters.cloned++;
                     }
                 }
                 if (!prune_flag) {
@@ -588,8 +684,10 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
                 if (final_result == copy && final_result != preorder_result &&
                     *final_result == *preorder_result)
                     final_result = preorder_result;
-                if (visited->finish(n, final_result) && (n = final_result))
-                    final_result->validate();
+                if (visited->finish(n, final_result)) {
+                    if (Counters::enabled) counters.changed++;
+                    if ((n = final_result)) final_result->validate();
+                }
                 if (extra_clone) visited->finish(preorder_result, final_result);
                 break;
             }
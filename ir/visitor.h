@@ -91,6 +91,28 @@ class Visitor {
     };
     virtual ~Visitor() = default;
 
+    /// Work done by the Inspectors, Modifiers and Transforms of the calling thread; used
+    /// by PassProfiler to attribute it to passes.  Nothing is counted unless
+    /// Counters::enabled is set.  Threads that run visitors on behalf of another thread
+    /// hand their counts back to it (see PassManager::applyPerDeclaration).
+    struct Counters {
+        uint64_t visited = 0;  // nodes visited
+        uint64_t cloned = 0;   // nodes cloned by Modifiers and Transforms
+        uint64_t changed = 0;  // nodes replaced by Modifiers and Transforms
+
+        static bool enabled;
+        Counters &operator+=(const Counters &other) {
+            visited += other.visited;
+            cloned += other.cloned;
+            changed += other.changed;
+            return *this;
+        }
+        Counters operator-(const Counters &other) const {
+            return {visited - other.visited, cloned - other.cloned, changed - other.changed};
+        }
+    };
+    static thread_local Counters counters;
+
     mutable cstring internalName;
     // Some visitors are created and applied by other visitors.
     // This field keeps track of the caller.
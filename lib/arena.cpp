@@ -0,0 +1,134 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "config.h"
+#include "lib/backtrace_exception.h"
+#include "lib/exceptions.h"
+#include "lib/log.h"
+#include "lib/n4.h"
+
+namespace Util {
+
+namespace {
+
+thread_local Arena *currentArena = nullptr;
+
+/// The arenas of the live IRArenas, which may be owned by other threads.
+std::mutex irArenasMutex;
+std::vector<const Arena *> irArenas;
+
+}  // namespace
+
+/// Blocks form a singly linked list; the payload follows the header.
+struct Arena::Block {
+    Block *next;
+    size_t size;
+    alignas(std::max_align_t) char data[1];
+};
+
+void Arena::newBlock(size_t minSize) {
+    size_t size = minSize > blockSize ? minSize : blockSize;
+    // Blocks come from malloc, so that with libgc they are scanned for pointers.
+    auto *block = static_cast<Block *>(malloc(offsetof(Block, data) + size));
+    if (block == nullptr) throw backtrace_exception<std::bad_alloc>();
+    block->next = blocks;
+    block->size = size;
+    blocks = block;
+    cursor = block->data;
+    limit = block->data + size;
+    reserved += size;
+}
+
+void *Arena::allocate(size_t size, size_t align) {
+    auto aligned = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t(align) - 1);
+    if (cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(limit)) {
+        newBlock(size + align);
+        aligned = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t(align) - 1);
+    }
+    cursor = reinterpret_cast<char *>(aligned + size);
+    inUse += size;
+    if (inUse > peak) peak = inUse;
+    return reinterpret_cast<void *>(aligned);
+}
+
+bool Arena::contains(const void *ptr) const {
+    auto *p = static_cast<const char *>(ptr);
+    for (auto *block = blocks; block; block = block->next)
+        if (p >= block->data && p < block->data + block->size) return true;
+    return false;
+}
+
+void Arena::release() {
+    while (blocks) {
+        auto *next = blocks->next;
+        free(blocks);
+        blocks = next;
+    }
+    cursor = limit = nullptr;
+    inUse = reserved = 0;
+}
+
+Arena *Arena::current() { return currentArena; }
+
+ArenaScope::ArenaScope(Arena *arena) : saved(currentArena) { currentArena = arena; }
+
+ArenaScope::~ArenaScope() { currentArena = saved; }
+
+IRArena::IRArena() {
+#if HAVE_IR_ARENA
+    if (currentArena == nullptr) {
+        arena = std::make_unique<Arena>();
+        scope = std::make_unique<ArenaScope>(arena.get());
+        std::lock_guard<std::mutex> lock(irArenasMutex);
+        irArenas.push_back(arena.get());
+    }
+#endif
+}
+
+IRArena::~IRArena() {
+    if (arena) {
+        LOG1("IR arena: peak " << n4(arena->peakBytesInUse()) << "B in use, "
+                               << n4(arena->bytesReserved()) << "B reserved");
+        scope.reset();
+        std::lock_guard<std::mutex> lock(irArenasMutex);
+        irArenas.erase(std::find(irArenas.begin(), irArenas.end(), arena.get()));
+    }
+}
+
+void IRArena::endCompilation() {
+    if (scope) {
+        BUG_CHECK(currentArena == arena.get(), "IR arena is not the current arena");
+        scope.reset();
+    }
+}
+
+bool IRArena::owns(const void *ptr) {
+    std::lock_guard<std::mutex> lock(irArenasMutex);
+    for (const auto *arena : irArenas)
+        if (arena->contains(ptr)) return true;
+    return false;
+}
+
+}  // namespace Util
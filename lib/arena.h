@@ -0,0 +1,112 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_ARENA_H_
+#define LIB_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+
+namespace Util {
+
+/// A bump-pointer allocator.  Memory is carved out of large blocks and is never
+/// returned individually; all of it is released at once when the arena is destroyed.
+/// Objects allocated in an arena must not rely on their destructors being run.
+///
+/// When p4c is configured with ENABLE_IR_ARENA, IR nodes are allocated from the
+/// arena installed by the innermost ArenaScope (if any) instead of the global heap.
+/// The IR arena of a compiler is owned by an IRArena.
+class Arena {
+    struct Block;
+    Block *blocks = nullptr;
+    char *cursor = nullptr;
+    char *limit = nullptr;
+    size_t inUse = 0;
+    size_t reserved = 0;
+    size_t peak = 0;
+    size_t blockSize;
+
+ public:
+    static constexpr size_t defaultBlockSize = 1 << 20;
+
+    explicit Arena(size_t blockSize = defaultBlockSize) : blockSize(blockSize) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { release(); }
+
+    /// Allocate @size bytes aligned to @align (which must be a power of two).
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t));
+    /// @returns true if @ptr points into memory owned by this arena.
+    bool contains(const void *ptr) const;
+    /// Free all memory owned by the arena.
+    void release();
+
+    /// Number of bytes handed out since the arena was created or last released.
+    size_t bytesInUse() const { return inUse; }
+    /// Number of bytes obtained from the system for the blocks.
+    size_t bytesReserved() const { return reserved; }
+    /// Highest value of bytesInUse() seen so far, across calls to release().
+    size_t peakBytesInUse() const { return peak; }
+
+    /// @returns the arena installed by the innermost active ArenaScope of this thread, or
+    /// nullptr if allocations should go to the global heap.
+    static Arena *current();
+
+ private:
+    friend class ArenaScope;
+    void newBlock(size_t minSize);
+};
+
+/// RAII helper which makes @arena the current arena for the lifetime of the scope.
+/// Passing nullptr suspends arena allocation, which is needed for objects that outlive
+/// the arena, e.g., entries in process-wide caches.
+class ArenaScope {
+    Arena *saved;
+
+ public:
+    explicit ArenaScope(Arena *arena);
+    ArenaScope(const ArenaScope &) = delete;
+    ~ArenaScope();
+};
+
+/// Owns the arena that IR nodes are allocated from when p4c is built with
+/// ENABLE_IR_ARENA, and makes it current for the calling thread while it is alive.
+/// Everything allocated from it is freed when the IRArena is destroyed, so it must
+/// outlive every use of the IR: compilers create one at the top of main(), before
+/// any compilation context.  If an arena is already current, the IRArena does nothing,
+/// and without ENABLE_IR_ARENA it always does nothing.
+class IRArena {
+    std::unique_ptr<Arena> arena;
+    std::unique_ptr<ArenaScope> scope;
+
+ public:
+    IRArena();
+    IRArena(const IRArena &) = delete;
+    ~IRArena();
+
+    /// Stops allocating from the arena once the compilation is done.  Nodes created
+    /// afterwards, e.g., while a tool explores the compiled program, come from the
+    /// garbage-collected heap and can be reclaimed.  Those already in the arena stay
+    /// valid until the IRArena is destroyed.
+    void endCompilation();
+
+    /// @returns true if @p ptr points into the arena of a live IRArena, current or not.
+    static bool owns(const void *ptr);
+};
+
+}  // namespace Util
+
+#endif /* LIB_ARENA_H_ */
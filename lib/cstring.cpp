@@ -20,6 +20,7 @@ limitations under the License.
 #include <cctype>
 #include <iomanip>
 #include <ios>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 
@@ -142,22 +143,40 @@ struct hash<table_entry> {
 }  // namespace std
 
 namespace {
-std::unordered_set<table_entry> &cache() {
-    static std::unordered_set<table_entry> g_cache;
+// The intern table is split into independently locked shards, selected by the string
+// hash, so that concurrent interning from several threads rarely contends on a lock.
+constexpr std::size_t cache_shard_count = 64;
+
+struct cache_shard {
+    std::mutex lock;
+    std::unordered_set<table_entry> entries;
+};
+
+cache_shard *cache() {
+    static cache_shard g_cache[cache_shard_count];
 
     return g_cache;
 }
 
+cache_shard &cache_shard_for(const char *string, std::size_t length) {
+    // Use the high bits of the hash, the low ones select the bucket inside the shard.
+    auto hash = Util::hash(string, length);
+    return cache()[(hash >> (sizeof(hash) * 8 - 6)) % cache_shard_count];
+}
+
 const char *save_to_cache(const char *string, std::size_t length, table_entry_flags flags) {
+    auto &shard = cache_shard_for(string, length);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
     if ((flags & table_entry_flags::no_need_copy) == table_entry_flags::no_need_copy) {
-        return cache().emplace(string, length, flags).first->string();
+        return shard.entries.emplace(string, length, flags).first->string();
     }
 
     // temporary table_entry, used for searching only. no need to copy string
-    auto found = cache().find(table_entry(string, length, table_entry_flags::no_need_copy));
+    auto found = shard.entries.find(table_entry(string, length, table_entry_flags::no_need_copy));
 
-    if (found == cache().end()) {
-        return cache().emplace(string, length, flags).first->string();
+    if (found == shard.entries.end()) {
+        return shard.entries.emplace(string, length, flags).first->string();
     }
 
     return found->string();
@@ -180,8 +199,13 @@ void cstring::construct_from_literal(const char *string, std::size_t length) {
 
 size_t cstring::cache_size(size_t &count) {
     size_t rv = 0;
-    count = cache().size();
-    for (auto &s : cache()) rv += sizeof(s) + s.length();
+    count = 0;
+    for (std::size_t i = 0; i < cache_shard_count; ++i) {
+        auto &shard = cache()[i];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        count += shard.entries.size();
+        for (auto &s : shard.entries) rv += sizeof(s) + s.length();
+    }
     return rv;
 }
 
@@ -21,6 +21,9 @@ limitations under the License.
 #include <set>
 #include <type_traits>
 #include <unordered_map>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 
 #include <boost/format.hpp>
 
@@ -53,6 +56,14 @@ class ErrorReporter {
     /// Track errors or warnings that have already been issued for a particular source location
     std::set<std::pair<int, const Util::SourceInfo>> errorTracker;
 
+#ifdef MULTITHREAD
+    /// Serializes diagnostics which are issued from several threads.
+    static std::mutex &diagnosticLock() {
+        static std::mutex lock;
+        return lock;
+    }
+#endif  // MULTITHREAD
+
     /// Output the message and flush the stream
     virtual void emit_message(const ErrorMessage &msg) {
         *outputstream << msg.toString();
@@ -70,6 +81,9 @@ class ErrorReporter {
     /// list of seen errors, and return false.
     bool error_reported(int err, const Util::SourceInfo source) {
         if (!source.isValid()) return false;
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> acquire(diagnosticLock());
+#endif  // MULTITHREAD
         auto p = errorTracker.emplace(err, source);
         return !p.second;  // if insertion took place, then we have not seen the error.
     }
@@ -147,6 +161,9 @@ class ErrorReporter {
     void diagnose(DiagnosticAction action, const char *diagnosticName, const char *format,
                   const char *suffix, T... args) {
         if (action == DiagnosticAction::Ignore) return;
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> acquire(diagnosticLock());
+#endif  // MULTITHREAD
 
         ErrorMessage::MessageType msgType = ErrorMessage::MessageType::None;
         if (action == DiagnosticAction::Info) {
@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "config.h"
 #if HAVE_LIBGC
+#ifdef MULTITHREAD
+#define GC_THREADS
+#endif  // MULTITHREAD
 #include <gc/gc_cpp.h>
 #include <gc/gc_mark.h>
 #endif /* HAVE_LIBGC */
@@ -61,6 +64,9 @@ static void maybe_initialize_gc() {
     if (!done_init) {
         started_init = true;
         GC_INIT();
+#ifdef MULTITHREAD
+        GC_allow_register_threads();
+#endif  // MULTITHREAD
         done_init = true;
     }
 }
@@ -229,6 +235,9 @@ void *realloc(void *ptr, size_t size) {
         } else {
             started_init = true;
             GC_INIT();
+#ifdef MULTITHREAD
+            GC_allow_register_threads();
+#endif  // MULTITHREAD
             done_init = true;
         }
     }
@@ -309,6 +318,27 @@ void setup_gc_logging() {
 #endif /* HAVE_LIBGC */
 }
 
+void gc_register_thread() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    struct GC_stack_base sb;
+    if (GC_get_stack_base(&sb) == GC_SUCCESS) GC_register_my_thread(&sb);
+#endif
+}
+
+void gc_unregister_thread() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    GC_unregister_my_thread();
+#endif
+}
+
+size_t gc_total_bytes() {
+#if HAVE_LIBGC
+    return GC_get_total_bytes();
+#else
+    return 0;
+#endif
+}
+
 size_t gc_mem_inuse(size_t *max) {
 #if HAVE_LIBGC
     GC_word heapsize, heapfree;
@@ -21,6 +21,12 @@ limitations under the License.
 
 void setup_gc_logging();
 size_t gc_mem_inuse(size_t *max = 0);  // trigger GC, return inuse after
+size_t gc_total_bytes();                // bytes allocated since start (0 without libgc)
+
+// Make the calling thread known to (or forget it from) the collector.  Required for
+// worker threads in MULTITHREAD builds; no-ops otherwise.
+void gc_register_thread();
+void gc_unregister_thread();
 
 #define ALLOC_TRACE_DEPTH 5
 struct alloc_trace_cb_t {
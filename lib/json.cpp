@@ -95,7 +95,7 @@ bool JsonValue::operator==(const JsonValue &other) const {
 void JsonArray::serialize(std::ostream &out) const {
     bool isSmall = true;
     for (auto v : *this) {
-        if (!v->is<JsonValue>()) isSmall = false;
+        if (v == nullptr || !v->is<JsonValue>()) isSmall = false;
     }
     out << "[";
     if (!isSmall) out << IndentCtl::indent;
@@ -0,0 +1,147 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/json_writer.h"
+
+#include <stdexcept>
+
+#include "lib/indent.h"
+
+namespace Util {
+
+void JsonWriter::beginValue(bool isContainer) {
+    if (frames.empty()) {
+        if (wroteRoot) throw std::logic_error("Attempt to write a second json root value");
+        wroteRoot = true;
+        return;
+    }
+    auto &frame = frames.back();
+    if (frame.isObject) {
+        if (!frame.hasKey) throw std::logic_error("Json object member without a label");
+        frame.hasKey = false;
+        return;
+    }
+    if (isContainer && !frame.multiline) openMultiline(frame);
+    if (frame.multiline) separate(frame);
+}
+
+void JsonWriter::separate(Frame &frame) {
+    if (!frame.first) out << ",";
+    frame.first = false;
+    out << IndentCtl::endl;
+}
+
+void JsonWriter::openMultiline(Frame &frame) {
+    frame.multiline = true;
+    out << "[" << IndentCtl::indent;
+    for (const auto &v : frame.pending) {
+        separate(frame);
+        v.serialize(out);
+    }
+    frame.pending.clear();
+    frame.pending.shrink_to_fit();
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    beginValue(true);
+    out << "{" << IndentCtl::indent;
+    frames.emplace_back(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject() {
+    if (frames.empty() || !frames.back().isObject)
+        throw std::logic_error("Json object ended outside of an object");
+    if (frames.back().hasKey) throw std::logic_error("Json object member without a value");
+    out << IndentCtl::unindent << IndentCtl::endl << "}";
+    frames.pop_back();
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray() {
+    beginValue(true);
+    // The opening bracket is written once the layout of the array is known.
+    frames.emplace_back(false);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray() {
+    if (frames.empty() || frames.back().isObject)
+        throw std::logic_error("Json array ended outside of an array");
+    auto &frame = frames.back();
+    if (frame.multiline) {
+        out << IndentCtl::unindent << IndentCtl::endl;
+    } else {
+        out << "[";
+        for (const auto &v : frame.pending) {
+            if (!frame.first) out << ", ";
+            frame.first = false;
+            v.serialize(out);
+        }
+    }
+    out << "]";
+    frames.pop_back();
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(cstring label) {
+    if (frames.empty() || !frames.back().isObject)
+        throw std::logic_error("Json label outside of an object");
+    if (label.isNullOrEmpty()) throw std::logic_error("Empty label");
+    auto &frame = frames.back();
+    if (frame.hasKey) throw std::logic_error("Json object member without a value");
+    if (!frame.keys.insert(label).second)
+        throw std::logic_error(cstring("Attempt to add to json object a value "
+                                       "for a label which already exists ") +
+                               label.c_str());
+    if (!frame.first) out << ",";
+    frame.first = false;
+    out << IndentCtl::endl << "\"" << label << "\"" << " : ";
+    frame.hasKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const JsonValue &v) {
+    if (!frames.empty() && !frames.back().isObject && !frames.back().multiline) {
+        frames.back().pending.push_back(v);
+        return *this;
+    }
+    beginValue(false);
+    v.serialize(out);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const IJson *json) {
+    if (const auto *streamed = json == nullptr ? nullptr : json->to<JsonStreamed>()) {
+        streamed->writeTo(*this);
+        return *this;
+    }
+    if (const auto *v = json == nullptr ? nullptr : json->to<JsonValue>()) return value(*v);
+    beginValue(true);
+    if (json == nullptr)
+        out << "null";
+    else
+        json->serialize(out);
+    return *this;
+}
+
+void JsonStreamed::serialize(std::ostream &out) const {
+    JsonWriter writer(out);
+    write(writer);
+    if (!writer.done()) throw std::logic_error("Streamed json value is incomplete");
+}
+
+}  // namespace Util
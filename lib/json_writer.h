@@ -0,0 +1,119 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_JSON_WRITER_H_
+#define LIB_JSON_WRITER_H_
+
+#include <functional>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "lib/cstring.h"
+#include "lib/json.h"
+
+namespace Util {
+
+/// Writes JSON to a stream while it is being produced, instead of building a complete
+/// JsonObject/JsonArray tree first.  The output is byte-for-byte identical to serializing the
+/// equivalent tree with IJson::serialize: object members appear in the order in which they
+/// are written, and arrays holding only scalars are written on a single line.
+///
+/// Scalars of an array are held back until the first object or array element shows whether
+/// the array is written on one line, so only arrays of scalars are ever buffered.  Like
+/// JsonObject::emplace, misuse (an empty or repeated key, a value without a key, unbalanced
+/// end calls) throws std::logic_error.
+class JsonWriter {
+ public:
+    explicit JsonWriter(std::ostream &out) : out(out) {}
+    JsonWriter(const JsonWriter &) = delete;
+    JsonWriter &operator=(const JsonWriter &) = delete;
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray();
+    JsonWriter &endArray();
+
+    /// Starts the member @label of the innermost object.  The next value written belongs to it.
+    JsonWriter &key(cstring label);
+
+    /// Writes a scalar.
+    JsonWriter &value(const JsonValue &v);
+    /// Writes an existing tree, or null if @json is nullptr.  Like a nullptr element of a
+    /// JsonArray, and unlike JsonValue::null, nullptr puts the enclosing array on multiple lines.
+    /// JsonStreamed values in the tree are written by their function.
+    JsonWriter &value(const IJson *json);
+
+    /// Writes the member @label with the value @v.
+    template <typename T>
+    JsonWriter &field(cstring label, const T &v) {
+        key(label);
+        return value(v);
+    }
+
+    /// @returns true once a complete value has been written.
+    bool done() const { return wroteRoot && frames.empty(); }
+
+ private:
+    struct Frame {
+        bool isObject;
+        /// No member or element has been written yet.
+        bool first = true;
+        /// Objects: a key was written and waits for its value.
+        bool hasKey = false;
+        /// Arrays: the array contains an object or array and is written on multiple lines.
+        bool multiline = false;
+        /// Arrays: the scalars which are held back while the array may still fit on one line.
+        std::vector<JsonValue> pending;
+        /// Objects: the keys written so far.
+        std::set<cstring> keys;
+
+        explicit Frame(bool isObject) : isObject(isObject) {}
+    };
+
+    std::ostream &out;
+    std::vector<Frame> frames;
+    bool wroteRoot = false;
+
+    /// Prepares the output for the next value, which is an object or array if @isContainer.
+    void beginValue(bool isContainer);
+    /// Starts writing the innermost array on multiple lines, including its held back scalars.
+    void openMultiline(Frame &frame);
+    void separate(Frame &frame);
+};
+
+/// A value in a JsonObject/JsonArray tree which is produced only when the tree is serialized,
+/// by a function writing it to a JsonWriter.  Large parts of a document, such as the entries
+/// of a table, then never exist as a tree.  The function must write exactly one value, and it
+/// must not report errors: they have to be found before the document is written.
+class JsonStreamed final : public IJson {
+ public:
+    using Writer = std::function<void(JsonWriter &)>;
+
+    explicit JsonStreamed(Writer write) : write(std::move(write)) {}
+    void serialize(std::ostream &out) const override;
+    void writeTo(JsonWriter &writer) const { write(writer); }
+
+ private:
+    Writer write;
+
+    DECLARE_TYPEINFO(JsonStreamed, IJson);
+};
+
+}  // namespace Util
+
+#endif /* LIB_JSON_WRITER_H_ */
@@ -106,6 +106,7 @@ std::vector<const char *> *Util::Options::process(int argc, char *const argv[])
                 usage();
                 return nullptr;
             }
+            processedOptions.emplace_back(option->option, cstring(arg));
         }
     }
 
@@ -21,6 +21,7 @@ limitations under the License.
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cstring.h"
@@ -69,6 +70,8 @@ class Options {
     std::vector<cstring> optionOrder;
     std::vector<const char *> additionalUsage;
     std::vector<const char *> remainingOptions;  // produced as output
+    // options in the order they were processed, with their argument (null if none)
+    std::vector<std::pair<cstring, cstring>> processedOptions;
     // if true unknown options are collected in remainingOptions
     bool collectUnknownOptions = false;
 
@@ -96,6 +99,9 @@ class Options {
 
     virtual const char *getIncludePath() = 0;
     cstring getCompileCommand() { return compileCommand; }
+    const std::vector<std::pair<cstring, cstring>> &getProcessedOptions() const {
+        return processedOptions;
+    }
     cstring getBuildDate() { return buildDate; }
     cstring getBinaryName() { return cstring(binaryName); }
     virtual void usage();
@@ -190,6 +190,9 @@ class SourceInfo final {
 
     const SourcePosition &getEnd() const { return this->end; }
 
+    /// @returns the input sources the positions refer to.
+    const InputSources *getSources() const { return this->sources; }
+
     /**
        True if this comes 'before' this source position.
        'invalid' source positions come first.
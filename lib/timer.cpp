@@ -5,6 +5,9 @@
 #include <memory>
 #include <unordered_map>
 #include <utility>
+#ifdef MULTITHREAD
+#include <thread>
+#endif  // MULTITHREAD
 
 namespace Util {
 
@@ -12,6 +15,12 @@ namespace {
 
 using Clock = std::chrono::high_resolution_clock;
 
+#ifdef MULTITHREAD
+/// The counters are not thread safe, so only the thread which initialized the program
+/// records time.
+const std::thread::id TIMER_THREAD = std::this_thread::get_id();
+#endif  // MULTITHREAD
+
 /// Represents one specific time counter. The time counter entries form a tree - every non-root
 /// time counter has a parent, which is the most inner counter currently active when this
 /// counter has been created. Conversely, every counter can have any number of child counters,
@@ -98,7 +107,12 @@ struct ScopedTimerCtx {
 };
 #pragma GCC diagnostic pop
 
-ScopedTimer::ScopedTimer(const char *name) : ctx(new ScopedTimerCtx(name)) {}
+ScopedTimer::ScopedTimer(const char *name) {
+#ifdef MULTITHREAD
+    if (std::this_thread::get_id() != TIMER_THREAD) return;
+#endif  // MULTITHREAD
+    ctx.reset(new ScopedTimerCtx(name));
+}
 
 ScopedTimer::~ScopedTimer() = default;
 
@@ -40,7 +40,8 @@ std::vector<TimerEntry> getTimers();
 struct ScopedTimerCtx;
 
 /// Similar to withTimer function, measures execution time elapsed from instance creation to
-/// destruction.
+/// destruction. In MULTITHREAD builds, timers started on other threads than the main thread
+/// do not measure anything.
 class ScopedTimer {
  public:
     explicit ScopedTimer(const char *name);
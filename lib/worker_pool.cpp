@@ -0,0 +1,113 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/worker_pool.h"
+
+#include <algorithm>
+
+#include "lib/gc.h"
+
+namespace Util {
+
+WorkerPool &WorkerPool::get() {
+    static WorkerPool pool;
+    return pool;
+}
+
+#ifdef MULTITHREAD
+
+void WorkerPool::run(size_t count, unsigned threads, const std::function<void(size_t)> &task) {
+    std::unique_lock<std::mutex> guard(lock);
+    if (busy || threads < 2 || count < 2) {
+        guard.unlock();
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    busy = true;
+    unsigned helpers = std::min<size_t>(threads - 1, count - 1);
+    while (this->threads.size() < helpers)
+        this->threads.emplace_back([this, seen = batch]() { helper(seen); });
+    this->task = &task;
+    this->count = count;
+    next = 0;
+    failures.assign(count, nullptr);
+    ++batch;
+    slots = helpers;
+    wake.notify_all();
+
+    drain(guard);
+    // All tasks have been started; helpers which did not join yet have nothing to do.
+    slots = 0;
+    finished.wait(guard, [this]() { return pending == 0; });
+    this->task = nullptr;
+    busy = false;
+    auto failed = std::move(failures);
+    guard.unlock();
+
+    for (auto &f : failed)
+        if (f) std::rethrow_exception(f);
+}
+
+void WorkerPool::drain(std::unique_lock<std::mutex> &guard) {
+    while (next < count) {
+        size_t i = next++;
+        guard.unlock();
+        try {
+            (*task)(i);
+        } catch (...) {
+            failures[i] = std::current_exception();
+        }
+        guard.lock();
+    }
+}
+
+void WorkerPool::helper(unsigned seen) {
+    gc_register_thread();
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [&]() { return stopping || (batch != seen && slots > 0); });
+        if (stopping) break;
+        seen = batch;
+        --slots;
+        ++pending;
+        drain(guard);
+        if (--pending == 0) finished.notify_all();
+    }
+    guard.unlock();
+    gc_unregister_thread();
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : threads) t.join();
+}
+
+#else
+
+void WorkerPool::run(size_t count, unsigned, const std::function<void(size_t)> &task) {
+    for (size_t i = 0; i < count; ++i) task(i);
+}
+
+WorkerPool::~WorkerPool() {}
+
+#endif  // MULTITHREAD
+
+}  // namespace Util
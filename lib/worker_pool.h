@@ -0,0 +1,78 @@
+/*
+Copyright 2024-present The P4 Language Consortium
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_WORKER_POOL_H_
+#define LIB_WORKER_POOL_H_
+
+#include <cstddef>
+#include <functional>
+#ifdef MULTITHREAD
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif  // MULTITHREAD
+
+namespace Util {
+
+/// A process-wide set of threads that run batches of independent tasks.  The threads
+/// are started when a batch first needs them, are registered with the collector, and
+/// sleep between batches, so that passes which run many small batches do not pay for
+/// thread creation each time.  Without MULTITHREAD, every batch runs on the calling
+/// thread.
+class WorkerPool {
+ public:
+    static WorkerPool &get();
+
+    /// Calls @task(i) for every i in [0, count), using the calling thread and up to
+    /// @threads - 1 pool threads, and returns when all calls have returned.  If calls
+    /// throw, the exception of the lowest i is rethrown.  A batch started from inside
+    /// another batch runs on the calling thread only.
+    void run(size_t count, unsigned threads, const std::function<void(size_t)> &task);
+
+    WorkerPool(const WorkerPool &) = delete;
+    ~WorkerPool();
+
+ private:
+    WorkerPool() = default;
+
+#ifdef MULTITHREAD
+    std::mutex lock;
+    std::condition_variable wake;      // signalled when a batch starts or the pool stops
+    std::condition_variable finished;  // signalled when a helper leaves a batch
+    std::vector<std::thread> threads;
+    bool stopping = false;
+    bool busy = false;
+
+    // The current batch.
+    const std::function<void(size_t)> *task = nullptr;
+    size_t count = 0;
+    size_t next = 0;
+    unsigned batch = 0;    // incremented for every batch
+    unsigned slots = 0;    // helpers that may still join the batch
+    unsigned pending = 0;  // helpers that joined and have not left yet
+    std::vector<std::exception_ptr> failures;
+
+    void helper(unsigned seen);
+    /// Runs tasks of the current batch until none is left.  Called with @guard held.
+    void drain(std::unique_lock<std::mutex> &guard);
+#endif  // MULTITHREAD
+};
+
+}  // namespace Util
+
+#endif /* LIB_WORKER_POOL_H_ */
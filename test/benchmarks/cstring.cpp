@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lib/cstring.h"
+#include "lib/gc.h"
+
+namespace Test {
+
+#ifdef MULTITHREAD
+// Measures intern throughput with 1..N threads.  Each thread interns a mix of already
+// interned strings and strings private to that thread.
+TEST(cstringBenchmark, internThroughput) {
+    constexpr int iterations = 20000;
+    unsigned maxThreads = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+    for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back([t, threadCount]() {
+                gc_register_thread();
+                for (int i = 0; i < iterations; ++i) {
+                    // GTest assertions are not thread-safe in our build, so only intern here.
+                    cstring("throughput_shared_" + std::to_string(i % 512));
+                    cstring("throughput_" + std::to_string(threadCount) + "_" +
+                            std::to_string(t) + "_" + std::to_string(i));
+                }
+                gc_unregister_thread();
+            });
+        }
+        for (auto &t : threads) t.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double interns = 2.0 * iterations * threadCount;
+        std::cout << "cstring intern: " << threadCount << " thread(s), "
+                  << static_cast<uint64_t>(interns / elapsed.count()) << " interns/sec"
+                  << std::endl;
+    }
+}
+#endif  // MULTITHREAD
+
+}  // namespace Test
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+#include "ir/json_parser.h"
+
+namespace Test {
+
+namespace {
+
+long peakRssKb() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+}  // namespace
+
+// Times loading a large IR dump from a file with loadJsonFile and the stream parser, and loading
+// the IR back from it.  The dump is a few hundred MB, like that of a large program.
+TEST(jsonParserBenchmark, largeIrDump) {
+    constexpr int statements = 400000;
+    const char *file = "large_ir_dump.json";
+    {
+        IR::IndexedVector<IR::StatOrDecl> components;
+        for (int i = 0; i < statements; ++i) {
+            auto *text = new IR::StringLiteral(cstring("line\n\"" + std::to_string(i) + "\"\\"));
+            components.push_back(new IR::AssignmentStatement(
+                new IR::PathExpression(IR::ID("x")), new IR::Add(text, new IR::Constant(i))));
+        }
+        std::ofstream dump(file);
+        JSONGenerator(dump) << new IR::BlockStatement(components) << std::endl;
+    }
+    std::ifstream sizeOf(file, std::ios::ate | std::ios::binary);
+    auto size = static_cast<long>(sizeOf.tellg());
+
+    // loadJsonFile runs first, so that the peak RSS it reaches is not hidden by the stream parser.
+    long rssBefore = peakRssKb();
+    auto start = std::chrono::steady_clock::now();
+    JsonData *loaded = loadJsonFile(file);
+    std::chrono::duration<double> loadFileTime = std::chrono::steady_clock::now() - start;
+    long loadFileRss = peakRssKb() - rssBefore;
+    ASSERT_NE(loaded, nullptr);
+
+    start = std::chrono::steady_clock::now();
+    JSONLoader loader(loaded);
+    const IR::Node *node = nullptr;
+    loader >> node;
+    std::chrono::duration<double> loadIrTime = std::chrono::steady_clock::now() - start;
+    ASSERT_NE(node, nullptr);
+
+    rssBefore = peakRssKb();
+    start = std::chrono::steady_clock::now();
+    JsonData *streamed = nullptr;
+    std::ifstream in(file);
+    in >> streamed;
+    std::chrono::duration<double> streamTime = std::chrono::steady_clock::now() - start;
+    long streamRss = peakRssKb() - rssBefore;
+    ASSERT_NE(streamed, nullptr);
+    std::remove(file);
+
+    std::cout << "IR dump of " << size << " bytes:" << std::endl
+              << "  loadJsonFile:  " << loadFileTime.count() << " s, peak RSS +" << loadFileRss
+              << " KB" << std::endl
+              << "  stream parser: " << streamTime.count() << " s, peak RSS +" << streamRss
+              << " KB" << std::endl
+              << "  loading the IR from the tree: " << loadIrTime.count() << " s" << std::endl;
+}
+
+}  // namespace Test
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace Test {
+
+namespace {
+
+/// The number of const entries of the generated program.
+constexpr int ENTRIES = 100000;
+
+/// Writes a v1model program with a single table of ENTRIES const entries to @p path.
+void writeLargeTableProgram(const std::filesystem::path &path) {
+    std::ofstream out(path);
+    out << R"(#include <core.p4>
+#include <v1model.p4>
+
+header h_t { bit<32> dst; bit<16> port; }
+struct headers_t { h_t h; }
+struct metadata_t { }
+
+parser p(packet_in b, out headers_t h, inout metadata_t m, inout standard_metadata_t sm) {
+    state start { b.extract(h.h); transition accept; }
+}
+control vrfy(inout headers_t h, inout metadata_t m) { apply { } }
+control update(inout headers_t h, inout metadata_t m) { apply { } }
+control egress(inout headers_t h, inout metadata_t m, inout standard_metadata_t sm) { apply { } }
+control deparser(packet_out b, in headers_t h) { apply { b.emit(h.h); } }
+
+control ingress(inout headers_t h, inout metadata_t m, inout standard_metadata_t sm) {
+    action forward(bit<9> port) { sm.egress_spec = port; }
+    action drop() { mark_to_drop(sm); }
+    table routes {
+        key = { h.h.dst : exact; h.h.port : ternary; }
+        actions = { forward; drop; }
+        default_action = drop();
+        const entries = {
+)";
+    for (int i = 0; i < ENTRIES; ++i)
+        out << "            (32w" << i << ", 16w" << i % 4096 << " &&& 16w0xfff) : forward(9w"
+            << i % 512 << ");\n";
+    out << R"(        }
+    }
+    apply { routes.apply(); }
+}
+
+V1Switch(p(), vrfy(), ingress(), egress(), update(), deparser()) main;
+)";
+}
+
+}  // namespace
+
+// Compiles a v1model program with a large const table with p4c-bm2-ss, whose table entries are
+// streamed to the output.  Run from the build directory, like the load_ir_from_json test.
+TEST(JsonWriter, LargeTableBmv2Program) {
+    if (!std::filesystem::exists("./p4c-bm2-ss")) GTEST_SKIP() << "p4c-bm2-ss is not built";
+    std::filesystem::path source = "large_table_bmv2.p4";
+    std::filesystem::path output = "large_table_bmv2.json";
+    writeLargeTableProgram(source);
+
+    auto start = std::chrono::steady_clock::now();
+    int exitCode = std::system(
+        ("./p4c-bm2-ss -o " + output.string() + " " + source.string()).c_str());
+    std::chrono::duration<double> compileTime = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ(exitCode, 0);
+
+    struct rusage usage {};
+    getrusage(RUSAGE_CHILDREN, &usage);
+    std::cout << "p4c-bm2-ss, " << ENTRIES << " const entries: " << compileTime.count()
+              << " s, peak RSS " << usage.ru_maxrss << " KB, "
+              << std::filesystem::file_size(output) << " bytes of JSON" << std::endl;
+    std::filesystem::remove(source);
+    std::filesystem::remove(output);
+}
+
+}  // namespace Test
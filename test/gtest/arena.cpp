@@ -0,0 +1,94 @@
+#include "lib/arena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "helpers.h"
+#include "ir/ir.h"
+#include "lib/compile_context.h"
+
+namespace Test {
+
+TEST(Arena, allocate) {
+    Util::Arena arena(256);
+    auto *a = static_cast<char *>(arena.allocate(10));
+    auto *b = static_cast<char *>(arena.allocate(10));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignof(std::max_align_t), 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(std::max_align_t), 0u);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(arena.contains(a));
+    EXPECT_TRUE(arena.contains(b + 9));
+    EXPECT_EQ(arena.bytesInUse(), 20u);
+
+    // Larger than a block.
+    auto *c = arena.allocate(1000, 8);
+    EXPECT_TRUE(arena.contains(c));
+    EXPECT_GE(arena.bytesReserved(), 1256u);
+    EXPECT_EQ(arena.peakBytesInUse(), 1020u);
+
+    int local = 0;
+    EXPECT_FALSE(arena.contains(&local));
+
+    arena.release();
+    EXPECT_EQ(arena.bytesInUse(), 0u);
+    EXPECT_EQ(arena.bytesReserved(), 0u);
+    EXPECT_FALSE(arena.contains(a));
+}
+
+TEST(Arena, scope) {
+    // With ENABLE_IR_ARENA, main() of the test binary has installed an IR arena.
+    auto *global = Util::Arena::current();
+    Util::Arena outer, inner;
+    {
+        Util::ArenaScope outerScope(&outer);
+        EXPECT_EQ(Util::Arena::current(), &outer);
+        {
+            Util::ArenaScope innerScope(&inner);
+            EXPECT_EQ(Util::Arena::current(), &inner);
+            Util::ArenaScope suspended(nullptr);
+            EXPECT_EQ(Util::Arena::current(), nullptr);
+        }
+        EXPECT_EQ(Util::Arena::current(), &outer);
+    }
+    EXPECT_EQ(Util::Arena::current(), global);
+}
+
+TEST(Arena, owner) {
+    auto *global = Util::Arena::current();
+    {
+        // An IR arena is only created when none is current.
+        Util::IRArena nested;
+        if (global != nullptr) EXPECT_EQ(Util::Arena::current(), global);
+    }
+    EXPECT_EQ(Util::Arena::current(), global);
+    {
+        // Compilation contexts do not own the IR, however deeply they are nested.
+        AutoCompileContext context(new GTestContext(GTestContext::get()));
+        EXPECT_EQ(Util::Arena::current(), global);
+    }
+    EXPECT_EQ(Util::Arena::current(), global);
+}
+
+TEST(Arena, endCompilation) {
+    auto *global = Util::Arena::current();
+    Util::ArenaScope noArena(nullptr);
+    Util::IRArena irArena;
+    auto *arena = Util::Arena::current();
+    auto *compiled = new IR::Constant(1);
+    irArena.endCompilation();
+    EXPECT_EQ(Util::Arena::current(), nullptr);
+    auto *explored = new IR::Constant(2);
+    if (arena != nullptr) {
+        // Built with ENABLE_IR_ARENA: the arena outlives its time as the current arena.
+        EXPECT_NE(arena, global);
+        EXPECT_TRUE(arena->contains(compiled));
+        EXPECT_TRUE(Util::IRArena::owns(compiled));
+        EXPECT_FALSE(Util::IRArena::owns(explored));
+    }
+    EXPECT_EQ(compiled->value, 1);
+    delete explored;
+    delete compiled;
+}
+
+}  // namespace Test
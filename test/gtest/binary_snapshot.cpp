@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "frontends/common/parseInput.h"
+#include "frontends/p4/frontend.h"
+#include "helpers.h"
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+
+namespace Test {
+
+namespace {
+
+const IR::Node *roundTrip(const IR::Node *node) {
+    std::stringstream out;
+    BinaryWriter(out) << node;
+    std::string data = out.str();
+    BinaryLoader loader(data.data(), data.size());
+    EXPECT_TRUE(loader.isValid());
+    return loader.loadNode();
+}
+
+std::string toJSON(const IR::Node *node) {
+    std::stringstream out;
+    JSONGenerator(out) << node;
+    return out.str();
+}
+
+}  // namespace
+
+class BinarySnapshot : public P4CTest {};
+
+TEST_F(BinarySnapshot, SharedNodes) {
+    auto *c = new IR::Constant(IR::Type_Bits::get(16), 0x1234);
+    auto *e1 = new IR::Add(c, c);
+
+    const auto *e2 = roundTrip(e1)->to<IR::Add>();
+    ASSERT_NE(e2, nullptr);
+    EXPECT_NE(e2, e1);
+    EXPECT_EQ(e2->left, e2->right);
+    EXPECT_EQ(e2->left->to<IR::Constant>()->value, 0x1234);
+    EXPECT_EQ(e2->left->type->width_bits(), 16);
+    EXPECT_EQ(toJSON(e1), toJSON(e2));
+}
+
+TEST_F(BinarySnapshot, RejectsForeignData) {
+    std::string data = "{ \"Node_ID\" : 1 }";
+    BinaryLoader loader(data.data(), data.size());
+    EXPECT_FALSE(loader.isValid());
+}
+
+TEST_F(BinarySnapshot, ReportsTruncatedData) {
+    auto *c = new IR::Constant(IR::Type_Bits::get(16), 0x1234);
+    std::stringstream out;
+    BinaryWriter(out) << new IR::Add(c, new IR::Neg(c));
+    std::string data = out.str();
+
+    // Every prefix that still has a valid header is reported as an error.
+    for (size_t size = data.size() - 1; size > 0; --size) {
+        BinaryLoader loader(data.data(), size);
+        if (!loader.isValid()) break;
+        auto errors = ::errorCount();
+        EXPECT_EQ(loader.loadNode(), nullptr);
+        EXPECT_EQ(::errorCount(), errors + 1);
+    }
+}
+
+TEST_F(BinarySnapshot, Program) {
+    std::string source = P4_SOURCE(P4Headers::V1MODEL, R"(
+        header H { bit<32> f; bit<8> g; }
+        struct Headers { H h; }
+        struct Meta { }
+        parser p(packet_in pkt, out Headers hdr, inout Meta m, inout standard_metadata_t sm) {
+            state start { pkt.extract(hdr.h); transition accept; }
+        }
+        control ingress(inout Headers hdr, inout Meta m, inout standard_metadata_t sm) {
+            action set(bit<32> v) { hdr.h.f = v - 32w1; }
+            table t { key = { hdr.h.g : exact; } actions = { set; NoAction; } }
+            apply { t.apply(); }
+        }
+        control egress(inout Headers hdr, inout Meta m, inout standard_metadata_t sm) {
+            apply { }
+        }
+        control deparser(packet_out pkt, in Headers hdr) { apply { pkt.emit(hdr.h); } }
+        control vc(inout Headers hdr, inout Meta m) { apply { } }
+        control uc(inout Headers hdr, inout Meta m) { apply { } }
+        V1Switch(p(), vc(), ingress(), egress(), uc(), deparser()) main;
+    )");
+    auto test = FrontendTestCase::create(source);
+    ASSERT_TRUE(test);
+
+    const auto *program = roundTrip(test->program)->to<IR::P4Program>();
+    ASSERT_NE(program, nullptr);
+    EXPECT_EQ(toJSON(test->program), toJSON(program));
+    EXPECT_EQ(program->objects.size(), test->program->objects.size());
+    // Source positions survive as file/line/fragment, like with --fromJSON.
+    EXPECT_GT(program->objects.back()->srcInfo.line, 0);
+    EXPECT_FALSE(program->objects.back()->srcInfo.srcBrief.isNullOrEmpty());
+}
+
+}  // namespace Test
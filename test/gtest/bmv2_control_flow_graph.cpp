@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "backends/bmv2/common/controlFlowGraph.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+class BMV2ControlFlowGraph : public P4CTest {};
+
+unsigned countNodes(const BMV2::CFG &cfg) {
+    unsigned count = 0;
+    for (auto node : cfg.allNodes)
+        if (node->is<BMV2::CFG::TableNode>() || node->is<BMV2::CFG::IfNode>()) count++;
+    return count;
+}
+
+}  // namespace
+
+TEST_F(BMV2ControlFlowGraph, Optimize) {
+    auto test = FrontendTestCase::create(P4_SOURCE(P4Headers::V1MODEL, R"(
+        header H { bit<8> a; bit<8> b; }
+        struct Headers { H h; }
+        struct Metadata { }
+
+        parser parse(packet_in p, out Headers h, inout Metadata m,
+                     inout standard_metadata_t sm) {
+            state start { transition accept; } }
+        control verifyChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control egress(inout Headers h, inout Metadata m,
+                       inout standard_metadata_t sm) { apply { } }
+        control computeChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control deparse(packet_out p, in Headers h) { apply { } }
+
+        control ingress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) {
+            action set(bit<9> port) { sm.egress_spec = port; }
+            table forward {
+                key = { h.h.a : exact; }
+                actions = { set; NoAction; }
+                default_action = NoAction();
+            }
+            table check {
+                key = { h.h.b : exact; }
+                actions = { set; NoAction; }
+                default_action = NoAction();
+            }
+            table skip {
+                key = { h.h.b : exact; }
+                actions = { NoAction; }
+                const default_action = NoAction();
+            }
+            // The default action can be changed by the control plane.
+            table monitor {
+                actions = { NoAction; }
+                default_action = NoAction();
+            }
+            apply {
+                if (h.h.isValid()) {
+                    if (h.h.a == 1) {
+                        forward.apply();
+                    }
+                }
+                skip.apply();
+                if (h.h.b == 2) {
+                    skip.apply();
+                }
+                if (check.apply().hit) {
+                    skip.apply();
+                }
+                monitor.apply();
+            }
+        }
+
+        V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+                 computeChecksum(), deparse()) main;
+    )"));
+    ASSERT_TRUE(test);
+
+    ReferenceMap refMap;
+    TypeMap typeMap;
+    auto program = test->program->apply(TypeChecking(&refMap, &typeMap));
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    const IR::P4Control *ingress = nullptr;
+    for (auto decl : program->objects) {
+        auto control = decl->to<IR::P4Control>();
+        if (control != nullptr && control->name == "ingress") ingress = control;
+    }
+    ASSERT_TRUE(ingress != nullptr);
+
+    BMV2::CFG cfg;
+    cfg.build(ingress, &refMap, &typeMap);
+    ASSERT_TRUE(cfg.checkImplementable());
+    EXPECT_EQ(9U, countNodes(cfg));
+
+    auto before = BMV2::CFG::statistics();
+    cfg.optimize(&refMap, &typeMap);
+    EXPECT_TRUE(cfg.checkImplementable());
+    const auto &after = BMV2::CFG::statistics();
+    EXPECT_EQ(1U, after.mergedConditionals - before.mergedConditionals);
+    EXPECT_EQ(1U, after.removedConditionals - before.removedConditionals);
+    EXPECT_EQ(3U, after.removedTables - before.removedTables);
+    EXPECT_EQ(1U, after.removedTableNames.count("ingress.skip"));
+
+    // Left are the merged conditional, forward, check and monitor.
+    EXPECT_EQ(4U, countNodes(cfg));
+    for (auto node : cfg.allNodes) {
+        if (auto tn = node->to<BMV2::CFG::TableNode>()) {
+            EXPECT_NE(tn->table->controlPlaneName(), "ingress.skip");
+            EXPECT_EQ(1U, tn->successors.size());
+        } else if (auto in = node->to<BMV2::CFG::IfNode>()) {
+            EXPECT_TRUE(in->statement->condition->is<IR::LAnd>());
+        }
+    }
+}
+
+}  // namespace Test
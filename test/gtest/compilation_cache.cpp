@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "frontends/common/compilationCache.h"
+#include "frontends/common/options.h"
+#include "frontends/common/parseInput.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+
+namespace Test {
+
+namespace {
+
+std::string toJSON(const IR::Node *node) {
+    std::stringstream out;
+    JSONGenerator(out) << node;
+    return out.str();
+}
+
+}  // namespace
+
+class CompilationCache : public P4CTest {
+ protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              ("p4c-cache-test-" + std::to_string(::getpid()));
+        std::filesystem::remove_all(dir);
+        P4CContext::get().options().compilationCacheDir = dir.c_str();
+    }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+TEST_F(CompilationCache, HitAfterStore) {
+    auto &options = P4CContext::get().options();
+    std::string input = P4_SOURCE(P4Headers::NONE, R"(
+        const bit<8> x = 8w1 + 8w2;
+    )");
+    auto test = FrontendTestCase::create(input);
+    ASSERT_TRUE(test);
+
+    P4::CompilationCache::computeKey(options, input);
+    ASSERT_TRUE(options.compilationCacheKey);
+    EXPECT_EQ(P4::CompilationCache::lookup(options, test->program), nullptr);
+    P4::CompilationCache::store(options, test->program);
+
+    const auto *cached = P4::CompilationCache::lookup(options, test->program);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(toJSON(cached), toJSON(test->program));
+    // Source positions refer to the input that was parsed.
+    const auto &srcInfo = cached->objects.back()->srcInfo;
+    EXPECT_EQ(srcInfo.getSources(), test->program->objects.back()->srcInfo.getSources());
+    EXPECT_EQ(srcInfo, test->program->objects.back()->srcInfo);
+
+    // A different input has a different key.
+    P4::CompilationCache::computeKey(options, input + "\n");
+    EXPECT_EQ(P4::CompilationCache::lookup(options, test->program), nullptr);
+}
+
+TEST_F(CompilationCache, DamagedEntries) {
+    auto &options = P4CContext::get().options();
+    std::string input = P4_SOURCE(P4Headers::NONE, R"(
+        const bit<8> x = 8w1 + 8w2;
+    )");
+    auto test = FrontendTestCase::create(input);
+    ASSERT_TRUE(test);
+    P4::CompilationCache::computeKey(options, input);
+    P4::CompilationCache::store(options, test->program);
+    auto path = dir / (std::string(options.compilationCacheKey) + ".frontend.p4ir");
+    auto size = std::filesystem::file_size(path);
+    ASSERT_GT(size, 32U);
+
+    auto expectIgnored = [&]() {
+        auto errors = ::errorCount();
+        auto warnings = ::diagnosticCount();
+        EXPECT_EQ(P4::CompilationCache::lookup(options, test->program), nullptr);
+        EXPECT_EQ(::errorCount(), errors);
+        EXPECT_EQ(::diagnosticCount(), warnings + 1);
+    };
+
+    // Flip a byte of the snapshot: the checksum no longer matches.
+    {
+        std::fstream entry(path, std::ios::in | std::ios::out | std::ios::binary);
+        entry.seekg(size - 1);
+        char last = entry.get();
+        entry.seekp(size - 1);
+        entry.put(static_cast<char>(~last));
+    }
+    expectIgnored();
+
+    // Truncated entries.
+    std::filesystem::resize_file(path, size / 2);
+    expectIgnored();
+    std::filesystem::resize_file(path, 4);
+    expectIgnored();
+}
+
+TEST_F(CompilationCache, StagesShareTheKey) {
+    auto &options = P4CContext::get().options();
+    std::string input = P4_SOURCE(P4Headers::NONE, R"(
+        const bit<8> x = 8w1 + 8w2;
+    )");
+    auto test = FrontendTestCase::create(input);
+    ASSERT_TRUE(test);
+    P4::CompilationCache::computeKey(options, input);
+
+    P4::CompilationCache::store(options, test->program, "midend");
+    EXPECT_EQ(P4::CompilationCache::lookup(options, test->program), nullptr);
+    const auto *cached = P4::CompilationCache::lookup(options, test->program, "midend");
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(toJSON(cached), toJSON(test->program));
+
+    std::string output;
+    EXPECT_FALSE(P4::CompilationCache::lookupOutput(options, "bmv2.json", output));
+    P4::CompilationCache::storeOutput(options, "bmv2.json", "{\"program\" : \"x\"}\n");
+    ASSERT_TRUE(P4::CompilationCache::lookupOutput(options, "bmv2.json", output));
+    EXPECT_EQ(output, "{\"program\" : \"x\"}\n");
+
+    // Nothing is stored once a diagnostic was reported.
+    ::warning(ErrorType::WARN_UNUSED, "test warning");
+    P4::CompilationCache::computeKey(options, input + "\n");
+    P4::CompilationCache::storeOutput(options, "bmv2.json", output);
+    EXPECT_FALSE(P4::CompilationCache::lookupOutput(options, "bmv2.json", output));
+}
+
+TEST_F(CompilationCache, KeyOfParsedOptions) {
+    auto keyOf = [](std::vector<const char *> args) {
+        CompilerOptions options;
+        args.insert(args.begin(), "p4test");
+        args.push_back("--compilationCache");
+        args.push_back("cache");
+        EXPECT_NE(options.process(args.size(), const_cast<char *const *>(args.data())),
+                  nullptr);
+        P4::CompilationCache::computeKey(options, "input");
+        return std::string(options.compilationCacheKey);
+    };
+    EXPECT_EQ(keyOf({"-DA=1", "-DB=2"}), keyOf({"-DA=1", "-DB=2"}));
+    // An argument with a space is not the same as two arguments.
+    EXPECT_NE(keyOf({"-DA=1 -DB=2"}), keyOf({"-DA=1", "-DB=2"}));
+    EXPECT_NE(keyOf({"-DA=1"}), keyOf({"-DA=2"}));
+    // The cache directory is not part of the key.
+    EXPECT_EQ(keyOf({"-DA=1", "--compilationCache", "elsewhere"}), keyOf({"-DA=1"}));
+}
+
+}  // namespace Test
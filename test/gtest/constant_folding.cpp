@@ -133,4 +133,73 @@ TEST_F(P4CConstantFoldingValidation, filter) {
     EXPECT_TRUE(ts_2->size->is<IR::Constant>());
 }
 
+const std::string tableEntriesCode() {
+    static const std::string code = P4_SOURCE(R"(
+        match_kind { exact }
+
+        action a(bit<8> x) {}
+
+        control c(in bit<8> k) {
+            table literal {
+                key = { k : exact; }
+                actions = { a; }
+                const entries = {
+                    1 : a(2);
+                    3 : a(4);
+                }
+            }
+            table computed {
+                key = { k : exact; }
+                actions = { a; }
+                const entries = {
+                    1 + 2 : a(2 * 3);
+                }
+            }
+            apply {
+                literal.apply();
+                computed.apply();
+            }
+        }
+    )");
+
+    return code;
+}
+
+const IR::EntriesList *getEntries(const IR::P4Program *program, cstring table_name) {
+    for (const auto *d : *program->getDeclarations()) {
+        const auto *control = d->to<IR::P4Control>();
+        if (!control) continue;
+        for (const auto *local : control->controlLocals) {
+            const auto *table = local->to<IR::P4Table>();
+            if (table && table->name == table_name) return table->getEntries();
+        }
+    }
+    return nullptr;
+}
+
+// Entries made only of literals are left alone, the others are folded
+TEST_F(P4CConstantFoldingValidation, table_entries) {
+    createPasses(nullptr);
+
+    const auto *original =
+        P4::parseP4String(tableEntriesCode(), CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(original);
+    const auto *program = original->apply(pm);
+    ASSERT_TRUE(program);
+    EXPECT_EQ(::errorCount(), 0);
+
+    const auto *literal = getEntries(program, "literal");
+    ASSERT_TRUE(literal);
+    EXPECT_EQ(literal, getEntries(original, "literal"));
+
+    const auto *computed = getEntries(program, "computed");
+    ASSERT_TRUE(computed);
+    EXPECT_FALSE(getEntries(original, "computed")->entries.at(0)->isLiteral());
+    const auto *entry = computed->entries.at(0);
+    EXPECT_TRUE(entry->isLiteral());
+    EXPECT_EQ(entry->keys->components.at(0)->to<IR::Constant>()->asInt(), 3);
+    const auto *call = entry->action->to<IR::MethodCallExpression>();
+    EXPECT_EQ(call->arguments->at(0)->expression->to<IR::Constant>()->asInt(), 6);
+}
+
 }  // namespace Test
@@ -18,6 +18,14 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+#ifdef MULTITHREAD
+#include <thread>
+
+#include "lib/gc.h"
+#endif  // MULTITHREAD
+
 namespace Test {
 
 TEST(cstring, construct) {
@@ -142,4 +150,27 @@ TEST(cstring, literalSuffix) {
     EXPECT_TRUE((std::is_same_v<cstring, decltype(""_cs)>));
 }
 
+#ifdef MULTITHREAD
+TEST(cstring, concurrentIntern) {
+    constexpr int threadCount = 4;
+    constexpr int stringCount = 1000;
+    std::vector<std::vector<const char *>> interned(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t, &interned]() {
+            gc_register_thread();
+            for (int i = 0; i < stringCount; ++i)
+                interned[t].push_back(cstring("concurrent_" + std::to_string(i)).c_str());
+            gc_unregister_thread();
+        });
+    }
+    for (auto &t : threads) t.join();
+
+    // Every thread must have observed the same interned copy of each string.
+    for (int t = 1; t < threadCount; ++t) EXPECT_EQ(interned[0], interned[t]);
+    for (int i = 0; i < stringCount; ++i)
+        EXPECT_EQ(interned[0][i], cstring("concurrent_" + std::to_string(i)).c_str());
+}
+#endif  // MULTITHREAD
+
 }  // namespace Test
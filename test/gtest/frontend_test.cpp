@@ -2,6 +2,7 @@
 
 #include "frontends/common/constantFolding.h"
 #include "frontends/common/parseInput.h"
+#include "frontends/common/programMap.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/moveDeclarations.h"
@@ -170,6 +171,197 @@ TEST_F(P4CFrontendEnumValidation, InvalidType) {
     ASSERT_TRUE(errors.contains("type-declared types"));
 }
 
+// Tests for the type checking of table entries
+struct P4CFrontendEntriesValidation : P4CFrontend {
+    P4CFrontendEntriesValidation() {
+        addPasses({new P4::ClearTypeMap(&typeMap), new P4::ResolveReferences(&refMap),
+                   new P4::TypeInference(&refMap, &typeMap, false, false)});
+    }
+
+    P4::ReferenceMap refMap;
+    P4::TypeMap typeMap;
+};
+
+const IR::EntriesList *tableEntries(const IR::Node *program, cstring tableName) {
+    for (const auto *node : program->to<IR::P4Program>()->objects) {
+        const auto *control = node->to<IR::P4Control>();
+        if (!control) continue;
+        for (const auto *local : control->controlLocals) {
+            const auto *table = local->to<IR::P4Table>();
+            if (table && table->name == tableName) return table->getEntries();
+        }
+    }
+    return nullptr;
+}
+
+TEST_F(P4CFrontendEntriesValidation, MaskRangeDefault) {
+    std::string program = P4_SOURCE(R"(
+        match_kind { exact, ternary, range }
+        control c(in bit<8> k) {
+            action a() {}
+            table t {
+                key = { k : ternary; k : range; }
+                actions = { a; }
+                const entries = {
+                    (8w1 &&& 8w3, 8w1 .. 8w5) : a();
+                    (_, 8w2) : a();
+                    (1 &&& 3, 1 .. 5) : a();
+                }
+            }
+            apply { t.apply(); }
+        }
+    )");
+    const auto *prog = parseAndProcess(program);
+    ASSERT_TRUE(prog);
+    ASSERT_EQ(::errorCount(), 0);
+
+    // Integer literals take the type of the key fields.
+    const auto *entries = tableEntries(prog, "t");
+    ASSERT_TRUE(entries);
+    const auto *keys = entries->entries.at(2)->keys;
+    const auto *mask = keys->components.at(0)->to<IR::Mask>();
+    ASSERT_TRUE(mask);
+    EXPECT_EQ(mask->right->to<IR::Constant>()->type->width_bits(), 8);
+    const auto *range = keys->components.at(1)->to<IR::Range>();
+    ASSERT_TRUE(range);
+    EXPECT_EQ(range->left->to<IR::Constant>()->type->width_bits(), 8);
+}
+
+TEST_F(P4CFrontendEntriesValidation, MismatchedWidth) {
+    std::string program = P4_SOURCE(R"(
+        match_kind { exact, ternary }
+        control c(in bit<8> k) {
+            action a() {}
+            table t {
+                key = { k : ternary; }
+                actions = { a; }
+                const entries = {
+                    8w1 &&& 8w3 : a();
+                    16w1 &&& 16w3 : a();
+                }
+            }
+            apply { t.apply(); }
+        }
+    )");
+    RedirectStderr errors;
+    const auto *prog = parseAndProcess(program);
+    errors.dumpAndReset();
+    ASSERT_TRUE(prog);
+    ASSERT_GT(::errorCount(), 0u);
+    ASSERT_TRUE(errors.contains("16w1 &&& 16w3"));
+}
+
+TEST_F(P4CFrontendEntriesValidation, MismatchedSign) {
+    std::string program = P4_SOURCE(R"(
+        match_kind { exact }
+        control c(in bit<8> k) {
+            action a() {}
+            table t {
+                key = { k : exact; }
+                actions = { a; }
+                const entries = {
+                    8w1 : a();
+                    8s2 : a();
+                }
+            }
+            apply { t.apply(); }
+        }
+    )");
+    RedirectStderr errors;
+    const auto *prog = parseAndProcess(program);
+    errors.dumpAndReset();
+    ASSERT_TRUE(prog);
+    ASSERT_GT(::errorCount(), 0u);
+    ASSERT_TRUE(errors.contains("8s2"));
+}
+
+TEST_F(P4CFrontendEntriesValidation, SerEnumKey) {
+    std::string program = P4_SOURCE(R"(
+        match_kind { exact }
+        enum bit<8> E { A = 1, B = 2 }
+        control c(in E k) {
+            action a() {}
+            table t {
+                key = { k : exact; }
+                actions = { a; }
+                const entries = {
+                    E.A : a();
+                    8w2 : a();
+                }
+            }
+            table u {
+                key = { k : exact; }
+                actions = { a; }
+                const entries = {
+                    E.B : a();
+                    16w1 : a();
+                }
+            }
+            apply { t.apply(); u.apply(); }
+        }
+    )");
+    RedirectStderr errors;
+    const auto *prog = parseAndProcess(program);
+    errors.dumpAndReset();
+    ASSERT_TRUE(prog);
+    // The underlying type converts implicitly to the enum, other widths do not.
+    ASSERT_GT(::errorCount(), 0u);
+    ASSERT_TRUE(errors.contains("16w1"));
+    ASSERT_FALSE(errors.contains("8w2"));
+}
+
+struct P4CFrontendEntriesRetyping : P4CFrontendEntriesValidation {
+    void SetUp() override { P4::ProgramMap::setIncrementalUpdates(true); }
+    void TearDown() override { P4::ProgramMap::setIncrementalUpdates(false); }
+};
+
+/// Changes the type named K to bit<16>.
+class WidenK : public Transform {
+    const IR::Node *postorder(IR::Type_Typedef *type) override {
+        if (type->name != "K") return type;
+        auto *widened = type->clone();
+        widened->type = IR::Type_Bits::get(16);
+        return widened;
+    }
+};
+
+TEST_F(P4CFrontendEntriesRetyping, KeyTypeChanges) {
+    std::string program = P4_SOURCE(R"(
+        match_kind { exact }
+        typedef bit<8> K;
+        control c(in K k) {
+            action a() {}
+            table t {
+                key = { k : exact; }
+                actions = { a; }
+                const entries = {
+                    8w1 : a();
+                }
+            }
+            apply { t.apply(); }
+        }
+    )");
+    const auto *prog = parseAndProcess(program);
+    ASSERT_TRUE(prog);
+    ASSERT_EQ(::errorCount(), 0);
+
+    // Checking the same program again keeps the entries.
+    const auto *entries = tableEntries(prog, "t");
+    prog = prog->apply(pm);
+    ASSERT_TRUE(prog);
+    ASSERT_EQ(::errorCount(), 0);
+    EXPECT_EQ(tableEntries(prog, "t"), entries);
+
+    // The entries are checked against the new key type.
+    prog = prog->apply(WidenK());
+    RedirectStderr errors;
+    prog = prog->apply(pm);
+    errors.dumpAndReset();
+    ASSERT_TRUE(prog);
+    ASSERT_GT(::errorCount(), 0u);
+    ASSERT_TRUE(errors.contains("8w1"));
+}
+
 // Tests for MoveInitializers
 struct P4CFrontendMoveInitializers : P4CFrontend {
     P4CFrontendMoveInitializers() {
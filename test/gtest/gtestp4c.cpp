@@ -17,9 +17,11 @@ limitations under the License.
 #include <gtest/gtest.h>
 
 #include "helpers.h"
+#include "lib/arena.h"
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+    Util::IRArena irArena;
     AutoCompileContext autoGTestContext(new GTestContext);
 
     // Initialize the global test environment.
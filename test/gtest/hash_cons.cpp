@@ -0,0 +1,92 @@
+#include "ir/hash_cons.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "ir/dump.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+class HashCons : public ::testing::Test {
+ protected:
+    void TearDown() override {
+        IR::HashCons::enable(false);
+        IR::HashCons::clear();
+    }
+};
+
+TEST_F(HashCons, disabledAllocates) {
+    IR::HashCons::clear();
+    auto *t = IR::Type_Bits::get(8);
+    auto *a = IR::HashCons::constant({}, t, 5);
+    auto *b = IR::HashCons::constant({}, t, 5);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(a->equiv(*b));
+    // Requests are only counted while hash-consing is enabled.
+    EXPECT_EQ(IR::HashCons::stats().requests, 0u);
+    EXPECT_EQ(IR::HashCons::stats().shared, 0u);
+}
+
+TEST_F(HashCons, sharesEqualLiterals) {
+    IR::HashCons::clear();
+    IR::HashCons::enable();
+    auto *t = IR::Type_Bits::get(8);
+    auto *a = IR::HashCons::constant({}, t, 5);
+    EXPECT_EQ(a, IR::HashCons::constant({}, t, 5));
+    EXPECT_NE(a, IR::HashCons::constant({}, t, 6));
+    EXPECT_NE(a, IR::HashCons::constant({}, IR::Type_Bits::get(8, true), 5));
+    EXPECT_NE(a, IR::HashCons::constant({}, t, 5, 16));
+
+    auto *yes = IR::HashCons::boolLiteral({}, true);
+    EXPECT_EQ(yes, IR::HashCons::boolLiteral({}, true));
+    EXPECT_NE(yes, IR::HashCons::boolLiteral({}, false));
+    EXPECT_TRUE(yes->value);
+
+    auto *s = IR::HashCons::stringLiteral({}, "x");
+    EXPECT_EQ(s, IR::HashCons::stringLiteral({}, "x"));
+    EXPECT_EQ(s->value, "x");
+
+    EXPECT_EQ(IR::HashCons::stats().requests, 10u);
+    EXPECT_EQ(IR::HashCons::stats().shared, 3u);
+}
+
+TEST_F(HashCons, keepsSourcePositions) {
+    IR::HashCons::clear();
+    IR::HashCons::enable();
+    auto *t = IR::Type_Bits::get(8);
+    Util::InputSources sources;
+    Util::SourceInfo here(&sources, Util::SourcePosition(1, 1), Util::SourcePosition(1, 2));
+    auto *a = IR::HashCons::constant(here, t, 1);
+    auto *b = IR::HashCons::constant({}, t, 1);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, IR::HashCons::constant(here, t, 1));
+
+    // The same position in another input is another source.
+    Util::InputSources other;
+    Util::SourceInfo there(&other, Util::SourcePosition(1, 1), Util::SourcePosition(1, 2));
+    EXPECT_NE(a, IR::HashCons::constant(there, t, 1));
+
+    // Source positions loaded from JSON have no input, only a file, line and column.
+    Util::SourceInfo line1("x.p4", 1, 4, "1"), line2("x.p4", 2, 4, "1");
+    auto *c = IR::HashCons::constant(line1, t, 1);
+    EXPECT_NE(c, b);
+    EXPECT_NE(c, IR::HashCons::constant(line2, t, 1));
+    EXPECT_EQ(c, IR::HashCons::constant(line1, t, 1));
+}
+
+TEST_F(HashCons, statsInDumps) {
+    IR::HashCons::clear();
+    IR::HashCons::enable();
+    auto *t = IR::Type_Bits::get(8);
+    auto *a = IR::HashCons::constant({}, t, 5);
+    EXPECT_EQ(a, IR::HashCons::constant({}, t, 5));
+    std::stringstream out;
+    ::dump(out, a);
+    EXPECT_NE(out.str().find("hash-consing: 1 of 2 leaf expression allocations avoided"),
+              std::string::npos);
+}
+
+}  // namespace Test
@@ -0,0 +1,139 @@
+#include "lib/json_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "lib/json.h"
+
+namespace Util {
+
+namespace {
+
+/// @returns the output of @write, called with a fresh stream.
+std::string writeTo(const std::function<void(std::ostream &)> &write) {
+    std::stringstream out;
+    write(out);
+    return out.str();
+}
+
+}  // namespace
+
+TEST(JsonWriter, MatchesTreeSerialization) {
+    auto *small = new JsonArray();
+    small->append(5)->append("5")->append(true);
+    auto *inner = new JsonObject();
+    inner->emplace("small", small);
+    inner->emplace("empty", new JsonArray());
+    auto *mixed = new JsonArray();
+    mixed->append(1)->append(inner)->append(new JsonArray());
+    auto *tree = new JsonObject();
+    tree->emplace("x", "x");
+    tree->emplace("n", -3);
+    tree->emplace("mixed", mixed);
+    tree->emplace("object", new JsonObject());
+    tree->emplace("null", JsonValue::null);
+
+    auto streamed = writeTo([](std::ostream &out) {
+        JsonWriter writer(out);
+        writer.beginObject();
+        writer.field("x", "x");
+        writer.field("n", -3);
+        writer.key("mixed").beginArray().value(1).beginObject();
+        writer.key("small").beginArray().value(5).value("5").value(true).endArray();
+        writer.key("empty").beginArray().endArray();
+        writer.endObject().beginArray().endArray().endArray();
+        writer.key("object").beginObject().endObject();
+        writer.field("null", JsonValue());
+        writer.endObject();
+        EXPECT_TRUE(writer.done());
+    });
+    EXPECT_EQ(tree->toString(), streamed);
+
+    // Existing trees can be embedded at any position.
+    auto embedded = writeTo([&](std::ostream &out) {
+        JsonWriter writer(out);
+        writer.beginObject();
+        writer.field("x", "x");
+        writer.field("n", -3);
+        writer.key("mixed").beginArray().value(1).value(inner).value(new JsonArray()).endArray();
+        writer.field("object", new JsonObject());
+        writer.field("null", static_cast<const IJson *>(nullptr));
+        writer.endObject();
+    });
+    EXPECT_EQ(tree->toString(), embedded);
+}
+
+TEST(JsonWriter, RejectsMalformedDocuments) {
+    std::stringstream out;
+    JsonWriter writer(out);
+    EXPECT_THROW(writer.key("x"), std::logic_error);
+    EXPECT_THROW(writer.endObject(), std::logic_error);
+    writer.beginObject();
+    EXPECT_THROW(writer.value(1), std::logic_error);
+    EXPECT_THROW(writer.key(""), std::logic_error);
+    writer.field("x", 1);
+    EXPECT_THROW(writer.key("x"), std::logic_error);
+    EXPECT_THROW(writer.endArray(), std::logic_error);
+    writer.endObject();
+    EXPECT_THROW(writer.beginObject(), std::logic_error);
+}
+
+TEST(JsonWriter, NullElementsMatchTreeLayout) {
+    // A null element makes the tree write an array on multiple lines, JsonValue::null does not.
+    auto *tree = new JsonArray();
+    tree->append(1);
+    tree->push_back(nullptr);
+    tree->append((new JsonArray())->append(1)->append(JsonValue::null));
+
+    auto streamed = writeTo([](std::ostream &out) {
+        JsonWriter writer(out);
+        writer.beginArray().value(1).value(static_cast<const IJson *>(nullptr));
+        writer.beginArray().value(1).value(JsonValue()).endArray();
+        writer.endArray();
+    });
+    EXPECT_EQ(tree->toString(), streamed);
+}
+
+TEST(JsonWriter, StreamedValuesMatchTree) {
+    auto *entries = new JsonArray();
+    for (int i = 0; i < 3; ++i) {
+        auto *entry = new JsonObject();
+        entry->emplace("key", i);
+        entry->emplace("data", (new JsonArray())->append(i));
+        entries->append(entry);
+    }
+    auto *tree = new JsonObject();
+    tree->emplace("name", "t");
+    tree->emplace("entries", entries);
+    tree->emplace("size", 3);
+
+    auto *lazy = new JsonObject();
+    lazy->emplace("name", "t");
+    lazy->emplace("entries", new JsonStreamed([](JsonWriter &writer) {
+                      writer.beginArray();
+                      for (int i = 0; i < 3; ++i) {
+                          writer.beginObject();
+                          writer.field("key", i);
+                          writer.key("data").beginArray().value(i).endArray();
+                          writer.endObject();
+                      }
+                      writer.endArray();
+                  }));
+    lazy->emplace("size", 3);
+    EXPECT_EQ(tree->toString(), lazy->toString());
+
+    auto streamed = writeTo([&](std::ostream &out) {
+        JsonWriter writer(out);
+        writer.value(lazy);
+    });
+    EXPECT_EQ(tree->toString(), streamed);
+
+    auto *incomplete = new JsonStreamed([](JsonWriter &writer) { writer.beginArray(); });
+    EXPECT_THROW(incomplete->toString(), std::logic_error);
+}
+
+}  // namespace Util
@@ -23,11 +23,15 @@ limitations under the License.
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <thread>
 
 #include "helpers.h"
 #include "ir/ir.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+#include "ir/json_parser.h"
 #include "lib/log.h"
 
 using namespace P4;
@@ -58,4 +62,36 @@ TEST_F(FromJSONTest, load_ir_from_json) {
     ASSERT_FALSE(exitCode);
 }
 
+// parseJson builds the same tree as the stream parser, including escaped strings.
+TEST_F(FromJSONTest, parse_ir_dump) {
+    IR::IndexedVector<IR::StatOrDecl> components;
+    for (int i = 0; i < 3; ++i) {
+        auto *text = new IR::StringLiteral(cstring("line\n\"" + std::to_string(i) + "\"\\"));
+        components.push_back(new IR::AssignmentStatement(
+            new IR::PathExpression(IR::ID("x")), new IR::Add(text, new IR::Constant(i))));
+    }
+    std::stringstream dump;
+    JSONGenerator(dump) << new IR::BlockStatement(components) << std::endl;
+    std::string text = dump.str();
+
+    JsonData *streamed = nullptr;
+    std::istringstream in(text);
+    in >> streamed;
+    JsonData *parsed = parseJsonData(text);
+    ASSERT_NE(parsed, nullptr);
+    std::stringstream streamedTree, parsedTree;
+    streamedTree << streamed;
+    parsedTree << parsed;
+    EXPECT_EQ(streamedTree.str(), parsedTree.str());
+
+    JSONLoader loader(parsed);
+    const IR::Node *node = nullptr;
+    loader >> node;
+    const auto *loaded = node->checkedTo<IR::BlockStatement>();
+    ASSERT_EQ(loaded->components.size(), size_t(3));
+    const auto *add = loaded->components.at(1)->checkedTo<IR::AssignmentStatement>()->right;
+    EXPECT_EQ(add->checkedTo<IR::Add>()->left->checkedTo<IR::StringLiteral>()->value,
+              cstring("line\n\"1\"\\"));
+}
+
 }  // namespace Test
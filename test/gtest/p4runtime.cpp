@@ -16,11 +16,13 @@ limitations under the License.
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <google/protobuf/util/json_util.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gtest/gtest.h>
 
 #include <iterator>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -32,6 +34,7 @@ limitations under the License.
 
 #include "control-plane/p4RuntimeSerializer.h"
 #include "control-plane/p4infoApi.h"
+#include "control-plane/protobufJson.h"
 #include "control-plane/typeSpecConverter.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
@@ -1475,6 +1478,174 @@ TEST_F(P4Runtime, JsonSerializationPrintOptions) {
     }
 }
 
+namespace {
+
+/// Checks that writeProtobufJson prints @message like MessageToJsonString, with and without
+/// whitespace and with JSON or proto field names.
+void expectJsonMatchesProtobuf(const google::protobuf::Message &message) {
+    SCOPED_TRACE(message.GetTypeName());
+    for (bool whitespace : {true, false}) {
+        for (bool protoNames : {true, false}) {
+            google::protobuf::util::JsonPrintOptions options;
+            options.add_whitespace = whitespace;
+            options.preserve_proto_field_names = protoNames;
+            ASSERT_TRUE(
+                P4::ControlPlaneAPI::supportsProtobufJson(message.GetDescriptor(), options));
+            std::string expected;
+            ASSERT_TRUE(
+                google::protobuf::util::MessageToJsonString(message, &expected, options).ok());
+            std::ostringstream json;
+            EXPECT_TRUE(P4::ControlPlaneAPI::writeProtobufJson(message, json, options));
+            EXPECT_EQ(expected, json.str());
+        }
+    }
+}
+
+}  // namespace
+
+TEST_F(P4Runtime, JsonSerializationMatchesProtobuf) {
+    auto test = createP4RuntimeTestCase(P4_SOURCE(P4Headers::V1MODEL, R"(
+        header Header { bit<8> hfA; bit<16> hfB; }
+        struct Headers { Header h; }
+        struct Metadata { }
+
+        parser parse(packet_in p, out Headers h, inout Metadata m,
+                     inout standard_metadata_t sm) {
+            state start { transition accept; } }
+        control verifyChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control egress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) { apply { } }
+        control computeChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control deparse(packet_out p, in Headers h) { apply { } }
+
+        control ingress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) {
+            action a() { sm.egress_spec = 0; }
+            action a_with_control_params(bit<9> x) { sm.egress_spec = x; }
+
+            table t_exact_ternary {
+                key = { h.h.hfA : exact; h.h.hfB : ternary; }
+                actions = { a; a_with_control_params; }
+                default_action = a;
+                const entries = {
+                    (0x01, 0x1111 &&& 0xF   ) : a_with_control_params(1);
+                    (0x02, 0x1181           ) : a_with_control_params(2);
+                    (0x03, 0x1000 &&& 0xF000) : a_with_control_params(3);
+                    (0x04, _                ) : a_with_control_params(4);
+                }
+            }
+            apply { t_exact_ternary.apply(); }
+        }
+        V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+                 computeChecksum(), deparse()) main;
+    )"));
+
+    ASSERT_TRUE(test);
+    ASSERT_EQ(4, test->entries->updates_size());
+
+    expectJsonMatchesProtobuf(*test->p4Info);
+    expectJsonMatchesProtobuf(*test->entries);
+}
+
+TEST_F(P4Runtime, JsonSerializationMatchesProtobufTypeInfo) {
+    auto test = createP4RuntimeTestCase(P4_SOURCE(P4Headers::V1MODEL, R"(
+        @controller_header("packet_in")
+        header PacketIn { bit<9> ingressPort; bit<7> pad; }
+        @controller_header("packet_out")
+        header PacketOut { bit<9> egressPort; bit<7> pad; }
+        header Header { bit<16> headerFieldA; bit<8> headerFieldB; }
+        struct Headers { PacketIn packetIn; PacketOut packetOut; Header h; }
+        enum bit<8> Color { Red = 1, Green = 2 }
+        struct Inner { bit<8> x; bit<16> y; }
+        struct Metadata { bit<3> a; Inner inner; Color color; }
+
+        parser parse(packet_in p, out Headers h, inout Metadata m,
+                     inout standard_metadata_t sm) {
+            state start { transition accept; } }
+        control verifyChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control egress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) { apply { } }
+        control computeChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control deparse(packet_out p, in Headers h) { apply { } }
+
+        control ingress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) {
+            apply {
+                digest(1, h.h);
+                digest(2, m);
+            }
+        }
+
+        V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+                 computeChecksum(), deparse()) main;
+    )"));
+
+    ASSERT_TRUE(test);
+    // The maps of type_info have several entries, whose order has to match too.
+    const auto &typeInfo = test->p4Info->type_info();
+    EXPECT_EQ(2, typeInfo.structs_size());
+    EXPECT_EQ(1, typeInfo.headers_size());
+    EXPECT_EQ(1, typeInfo.serializable_enums_size());
+    EXPECT_EQ(2, test->p4Info->controller_packet_metadata_size());
+    expectJsonMatchesProtobuf(*test->p4Info);
+}
+
+TEST_F(P4Runtime, JsonSerializationMatchesProtobufAnyAndBytes) {
+    // Bytes of every length modulo 3, with and without high bits, and strings which are escaped
+    // or left to the protobuf library.
+    const std::vector<std::string> bytes = {"",
+                                            std::string(1, '\0'),
+                                            "\xff\x01",
+                                            "abc",
+                                            std::string("\x80\x00\xfe\x7f", 4),
+                                            "\xfb\xff\xbf\x3e\x3f"};
+    const std::vector<std::string> strings = {
+        "", "<a href=\"x\">&'/", "tab\tnew\nline\x01\x7f\\", "caf\xc3\xa9",
+        "\xf0\x9f\x98\x80 \xe2\x80\xa8"};
+
+    p4configv1::P4Info p4Info;
+    auto *ext = p4Info.add_externs();
+    ext->set_extern_type_id(0x81);
+    ext->set_extern_type_name("MyExtern");
+    for (size_t i = 0; i < strings.size(); ++i) {
+        auto *instance = ext->add_instances();
+        instance->mutable_preamble()->set_id(0x81000000 + i);
+        instance->mutable_preamble()->set_name(strings[i]);
+        instance->mutable_preamble()->add_annotations(strings[strings.size() - 1 - i]);
+        instance->mutable_preamble()->mutable_doc()->set_brief(strings[i]);
+        p4configv1::Digest info;
+        info.mutable_preamble()->set_name(strings[i]);
+        info.mutable_type_spec()->mutable_bitstring()->mutable_bit()->set_bitwidth(9);
+        if (i % 2 == 0) instance->mutable_info()->PackFrom(info);
+    }
+    expectJsonMatchesProtobuf(p4Info);
+
+    p4v1::WriteRequest entries;
+    entries.set_device_id(~uint64_t(0));
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        auto *update = entries.add_updates();
+        update->set_type(p4v1::Update::INSERT);
+        p4v1::TableEntry entry;
+        entry.set_table_id(1);
+        entry.set_metadata(bytes[i]);
+        auto *match = entry.add_match();
+        match->set_field_id(i + 1);
+        match->mutable_exact()->set_value(bytes[i]);
+        auto *param = entry.mutable_action()->mutable_action()->add_params();
+        param->set_param_id(1);
+        param->set_value(bytes[bytes.size() - 1 - i]);
+        if (i % 2 == 0) {
+            *update->mutable_entity()->mutable_table_entry() = entry;
+        } else {
+            auto *externEntry = update->mutable_entity()->mutable_extern_entry();
+            externEntry->set_extern_type_id(0x81);
+            externEntry->set_extern_id(i);
+            externEntry->mutable_entry()->PackFrom(entry);
+        }
+    }
+    expectJsonMatchesProtobuf(entries);
+}
+
 class P4RuntimePkgInfo : public P4CTest {
  protected:
     static std::optional<P4::P4RuntimeAPI> createTestCase(const char *annotations);
@@ -0,0 +1,182 @@
+#include "ir/pass_manager.h"
+
+#include <gtest/gtest.h>
+
+#include "frontends/common/constantFolding.h"
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/reassociation.h"
+#include "frontends/p4/strengthReduction.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "frontends/p4/uselessCasts.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+namespace {
+
+/// Decrements every positive constant by one, counting the constants it visits.
+class CountDown : public Transform, public PerDeclarationSafe {
+    int *visits;
+
+ public:
+    explicit CountDown(int *visits) : visits(visits) {}
+    const IR::Node *postorder(IR::Constant *c) override {
+        ++*visits;
+        if (c->value > 0) c->value -= 1;
+        return c;
+    }
+    CountDown *clone() const override { return new CountDown(*this); }
+};
+
+/// Same as CountDown, but not marked PerDeclarationSafe.
+class CountDownAll : public Transform {
+    int *visits;
+
+ public:
+    explicit CountDownAll(int *visits) : visits(visits) {}
+    const IR::Node *postorder(IR::Constant *c) override {
+        ++*visits;
+        if (c->value > 0) c->value -= 1;
+        return c;
+    }
+};
+
+const IR::P4Program *makeProgram() {
+    auto *t = IR::Type_Bits::get(8);
+    IR::Vector<IR::Node> objects;
+    for (int v : {0, 1, 3}) objects.push_back(new IR::Constant(t, v));
+    return new IR::P4Program(objects);
+}
+
+void expectAllZero(const IR::Node *node) {
+    auto *program = node->to<IR::P4Program>();
+    ASSERT_NE(program, nullptr);
+    ASSERT_EQ(program->objects.size(), 3u);
+    for (auto *obj : program->objects) EXPECT_EQ(obj->to<IR::Constant>()->value, 0);
+}
+
+}  // namespace
+
+class PerDeclarationPasses : public P4CTest {};
+
+TEST_F(PerDeclarationPasses, parallelMatchesSerial) {
+    std::string source = P4_SOURCE(R"(
+        control c1(inout bit<8> a, inout bit<8> b) {
+            apply { a = b * 8; b = (a + 1) + 2; a = a & 0; }
+        }
+        control c2(inout bit<8> a, inout bit<8> b) {
+            apply { a = b + 0; b = b / 4; a = (a | 1) | 2; }
+        }
+        control c3(inout bit<8> a, inout bit<8> b) {
+            apply { if (a == a) { b = 0 - b; } a = b % 16; }
+        }
+        control c4(inout bit<8> a, inout bit<8> b) {
+            apply { a = (a * 2) * 3; }
+        }
+    )");
+    auto *program = P4::parseP4String(source, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+
+    auto run = [program](unsigned threads) {
+        auto saved = PassManager::getParallelism();
+        PassManager::setParallelism(threads);
+        PassManager passes({new P4::StrengthReduction(nullptr, nullptr), new P4::Reassociation()});
+        auto *result = program->apply(passes);
+        PassManager::setParallelism(saved);
+        return result;
+    };
+    auto *serial = run(0);
+    auto *parallel = run(4);
+    EXPECT_NE(serial, program);
+    EXPECT_NE(parallel, program);
+    EXPECT_TRUE(serial->equiv(*parallel));
+    EXPECT_EQ(::errorCount(), 0u);
+}
+
+// The constant folding loop of the frontend only revisits the declarations the
+// PerDeclarationSafe passes in it changed, and still reaches the fixed point.
+TEST_F(PerDeclarationPasses, frontendLoopSkipsFixedDeclarations) {
+    std::string source = P4_SOURCE(R"(
+        const bit<8> K = 2;
+        control c1(inout bit<8> a, inout bit<8> b) {
+            apply { a = (b + 1) + K; b = b * 8; }
+        }
+        control c2(inout bit<8> a, inout bit<8> b) {
+            apply { a = (bit<8>)(b & 0); }
+        }
+        control c3(inout bit<8> a, inout bit<8> b) {
+            apply { a = b; }
+        }
+        control c4(inout bit<8> a, inout bit<8> b) {
+            apply { b = a; }
+        }
+    )");
+    auto *program = P4::parseP4String(source, CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    P4::ReferenceMap refMap;
+    P4::TypeMap typeMap;
+    program = program->apply(P4::TypeChecking(&refMap, &typeMap));
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+
+    auto loop = [&]() {
+        return new PassRepeated({
+            new P4::ConstantFolding(&refMap, &typeMap),
+            new P4::StrengthReduction(&refMap, &typeMap),
+            new P4::Reassociation(),
+            new P4::UselessCasts(&refMap, &typeMap),
+        });
+    };
+    auto before = PassManager::perDeclarationStatistics();
+    auto *result = program->apply(*loop());
+    const auto &after = PassManager::perDeclarationStatistics();
+    ASSERT_TRUE(result != nullptr && ::errorCount() == 0);
+    EXPECT_NE(result, program);
+    EXPECT_GT(after.skipped - before.skipped, 0u);
+    EXPECT_GT(after.applied - before.applied, 0u);
+
+    // Passes without memory of earlier runs find nothing left to do.
+    EXPECT_TRUE(result->equiv(*result->apply(*loop())));
+}
+
+TEST(PassRepeated, revisitsAllDeclarations) {
+    int visits = 0;
+    PassRepeated repeated({new CountDownAll(&visits)});
+    auto *result = makeProgram()->apply(repeated);
+    expectAllZero(result);
+    // 4 iterations over 3 constants.
+    EXPECT_EQ(visits, 12);
+}
+
+TEST(PassRepeated, revisitsOnlyChangedDeclarations) {
+    int visits = 0;
+    PassRepeated repeated({new CountDown(&visits)});
+    auto *result = makeProgram()->apply(repeated);
+    expectAllZero(result);
+    // 3 constants in the first iteration, then only those changed by the previous one.
+    EXPECT_EQ(visits, 3 + 2 + 1 + 1);
+}
+
+TEST(PassRepeated, nestedManagersRememberFixedDeclarations) {
+    int visits = 0;
+    PassRepeated repeated({new PassManager({new CountDown(&visits)})});
+    auto *result = makeProgram()->apply(repeated);
+    expectAllZero(result);
+    // The inner manager is applied afresh in each iteration, within the same outer run.
+    EXPECT_EQ(visits, 3 + 2 + 1 + 1);
+}
+
+TEST(PassRepeated, forgetsFixedDeclarationsBetweenApplies) {
+    int visits = 0;
+    PassRepeated repeated({new CountDown(&visits)});
+    auto *program = makeProgram()->apply(repeated);
+    expectAllZero(program);
+    // Applying the same pass manager again visits every declaration once more.
+    visits = 0;
+    EXPECT_EQ(program->apply(repeated), program);
+    EXPECT_EQ(visits, 3);
+}
+
+}  // namespace Test
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/programMap.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+using namespace P4;
+using namespace P4::literals;
+
+namespace Test {
+
+namespace {
+
+class P4CProgramChanges : public P4CTest {
+ protected:
+    void SetUp() override { ProgramMap::setIncrementalUpdates(true); }
+    void TearDown() override { ProgramMap::setIncrementalUpdates(false); }
+};
+
+const IR::P4Program *parseProgram() {
+    std::string program = P4_SOURCE(R"(
+        header H { bit<32> f; }
+        control C(inout H h);
+        package P(C a, C b);
+        control A(inout H h) { apply { h.f = h.f + 1; } }
+        control B(inout H h) { apply { h.f = 2; } }
+        P(A(), B()) main;
+    )");
+    return P4::parseP4String(program, CompilerOptions::FrontendVersion::P4_16);
+}
+
+/// Replaces the constant 2 by 3.
+class ChangeConstant : public Transform {
+    const IR::Node *postorder(IR::Constant *c) override {
+        if (c->value == 2) return new IR::Constant(c->srcInfo, c->type, 3);
+        return c;
+    }
+};
+
+const IR::AssignmentStatement *firstAssignment(const IR::P4Program *program, cstring control) {
+    for (const auto *obj : program->objects) {
+        const auto *c = obj->to<IR::P4Control>();
+        if (c && c->name == control)
+            return c->body->components.at(0)->to<IR::AssignmentStatement>();
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+TEST_F(P4CProgramChanges, staleDeclarations) {
+    const auto *before = parseProgram();
+    ASSERT_TRUE(before != nullptr && ::errorCount() == 0);
+    const auto *after = before->apply(ChangeConstant());
+    ASSERT_NE(before, after);
+
+    ProgramChanges changes(before, after);
+    EXPECT_TRUE(changes.isIncremental());
+    // B changed, and main refers to B.
+    EXPECT_TRUE(changes.isStale(firstAssignment(before, "B"_cs)->right));
+    EXPECT_TRUE(changes.isStale(firstAssignment(after, "B"_cs)->right));
+    EXPECT_TRUE(changes.isStale(after->objects.back()));
+    EXPECT_FALSE(changes.isStale(firstAssignment(after, "A"_cs)));
+    EXPECT_FALSE(changes.isStale(after->objects.front()));
+
+    // Adding a declaration changes the top-level names.
+    auto *extended = after->clone();
+    extended->objects.push_back(new IR::Type_Header("G"_cs, IR::IndexedVector<IR::StructField>()));
+    EXPECT_FALSE(ProgramChanges(before, extended).isIncremental());
+}
+
+TEST_F(P4CProgramChanges, retypeChangedDeclarations) {
+    ReferenceMap refMap;
+    TypeMap typeMap;
+    PassManager typeCheck({new ClearTypeMap(&typeMap), new TypeChecking(&refMap, &typeMap)});
+
+    const auto *program = parseProgram();
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    program = program->apply(typeCheck);
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    const auto *assignA = firstAssignment(program, "A"_cs);
+    const auto *typeA = typeMap.getType(assignA->left);
+    ASSERT_NE(typeA, nullptr);
+
+    program = program->apply(ChangeConstant());
+    program->apply(ClearTypeMap(&typeMap));
+    // Types of the unchanged control are kept, the changed constant has none yet.
+    EXPECT_EQ(typeMap.getType(assignA->left), typeA);
+    const auto *three = firstAssignment(program, "B"_cs)->right;
+    EXPECT_EQ(typeMap.getType(three), nullptr);
+
+    program = program->apply(typeCheck);
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    EXPECT_EQ(typeMap.getType(assignA->left), typeA);
+    EXPECT_NE(typeMap.getType(three), nullptr);
+}
+
+TEST_F(P4CProgramChanges, clearWhenDisabled) {
+    ProgramMap::setIncrementalUpdates(false);
+    ReferenceMap refMap;
+    TypeMap typeMap;
+    const auto *program = parseProgram();
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    program = program->apply(TypeChecking(&refMap, &typeMap));
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+
+    program = program->apply(ChangeConstant());
+    program->apply(ClearTypeMap(&typeMap));
+    EXPECT_EQ(typeMap.size(), 0u);
+}
+
+}  // namespace Test
@@ -160,4 +160,55 @@ TEST_F(P4CVisitor, MultiVisitModifierLoop) {
     ASSERT_TRUE(program != nullptr);
 }
 
+namespace {
+
+struct CountingInspector : public Inspector {
+    uint64_t visits = 0;
+    bool preorder(const IR::Node *) override {
+        ++visits;
+        return true;
+    }
+};
+
+}  // namespace
+
+// Visiting nodes whose ids are far apart, as for a few nodes created in between
+// passes, still visits every node once.
+TEST_F(P4CVisitor, SparseIds) {
+    auto *type = IR::Type_Bits::get(8);
+    const IR::Expression *expr = new IR::Constant(type, 0);
+    auto *shared = new IR::Constant(type, 1);
+    for (int i = 0; i < 100; ++i) {
+        for (int j = 0; j < 1000; ++j) new IR::Constant(type, j);
+        expr = new IR::Add(type, expr, i % 10 == 0 ? shared : new IR::Constant(type, i));
+    }
+    CountingInspector inspector;
+    expr->apply(inspector);
+    // 100 additions, the first constant, 90 constants and the shared one.
+    EXPECT_EQ(inspector.visits, 100U + 1 + 90 + 1);
+}
+
+TEST_F(P4CVisitor, WorkCounters) {
+    auto *type = IR::Type_Bits::get(8);
+    const IR::Node *expr =
+        new IR::Add(type, new IR::Constant(type, 1), new IR::Constant(type, 2));
+    bool wasEnabled = Visitor::Counters::enabled;
+
+    // Nothing is counted unless a profile is being recorded.
+    Visitor::Counters::enabled = false;
+    auto before = Visitor::counters;
+    expr->apply(CountingInspector());
+    EXPECT_EQ((Visitor::counters - before).visited, 0U);
+
+    Visitor::Counters::enabled = true;
+    before = Visitor::counters;
+    CountingInspector inspector;
+    expr->apply(inspector);
+    auto work = Visitor::counters - before;
+    Visitor::Counters::enabled = wasEnabled;
+    EXPECT_EQ(work.visited, inspector.visits);
+    EXPECT_EQ(work.cloned, 0U);
+    EXPECT_EQ(work.changed, 0U);
+}
+
 }  // namespace Test
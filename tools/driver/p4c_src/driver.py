@@ -177,6 +177,12 @@ class BackendDriver:
         if opts.optimizeParserInlining:
             self.add_command_option("compiler", "--parser-inline-opt")
 
+        # reuse front-end results of earlier compilations
+        if opts.compilation_cache:
+            self.add_command_option(
+                "compiler", "--compilationCache {}".format(opts.compilation_cache)
+            )
+
         # set developer options
         if os.environ["P4C_BUILD_TYPE"] == "DEVELOPER":
             for option in opts.log_levels:
@@ -413,6 +413,17 @@ def main():
         action="store_true",
         default=False,
     )
+    parser.add_argument(
+        "--compilation-cache",
+        dest="compilation_cache",
+        help=(
+            "Reuse the front-end results of previous compilations of the same "
+            "preprocessed program with the same options, stored in DIR."
+        ),
+        action="store",
+        metavar="DIR",
+        default=os.environ.get("P4C_COMPILATION_CACHE"),
+    )
 
     ### DRYified “env_indicates_developer_build”
     env_indicates_developer_build = os.environ["P4C_BUILD_TYPE"] == "DEVELOPER"
@@ -110,6 +110,8 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
 
     impl << "#include \"ir/ir-generated.h\"    // IWYU pragma: keep\n\n"
          << "#include \"ir/ir-inline.h\"       // IWYU pragma: keep\n"
+         << "#include \"ir/binary_loader.h\"   // IWYU pragma: keep\n"
+         << "#include \"ir/binary_writer.h\"   // IWYU pragma: keep\n"
          << "#include \"ir/json_generator.h\"  // IWYU pragma: keep\n"
          << "#include \"ir/json_loader.h\"     // IWYU pragma: keep\n"
          << "#include \"ir/visitor.h\"         // IWYU pragma: keep\n"
@@ -130,9 +132,12 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         << std::endl
         << "class JSONLoader;\n"
         << "using NodeFactoryFn = IR::Node*(*)(JSONLoader&);\n"
+        << "class BinaryLoader;\n"
+        << "using BinaryNodeFactoryFn = IR::Node*(*)(BinaryLoader&);\n"
         << std::endl
         << "namespace IR {\n"
         << "extern std::map<cstring, NodeFactoryFn> unpacker_table;\n"
+        << "extern std::map<cstring, BinaryNodeFactoryFn> binary_unpacker_table;\n"
         << "}\n";
 
     impl << "std::map<cstring, NodeFactoryFn> IR::unpacker_table = {\n";
@@ -151,6 +156,21 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
     }
     impl << " };\n" << std::endl;
 
+    impl << "std::map<cstring, BinaryNodeFactoryFn> IR::binary_unpacker_table = {\n";
+    first = true;
+    for (auto cls : *getClasses()) {
+        if (cls->kind == NodeKind::Concrete) {
+            if (first)
+                first = false;
+            else
+                impl << ",\n";
+            impl << "{\"" << cls->name << "\", BinaryNodeFactoryFn(&IR::";
+            if (cls->containedIn && cls->containedIn->name) impl << cls->containedIn->name << "::";
+            impl << cls->name << "::fromBinary)}";
+        }
+    }
+    impl << " };\n" << std::endl;
+
     for (auto e : elements) {
         e->generate_hdr(out);
         e->generate_impl(impl);
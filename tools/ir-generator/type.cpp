@@ -120,6 +120,16 @@ NamedType &NamedType::JSONObject() {
     return nt;
 }
 
+NamedType &NamedType::BinaryWriter() {
+    static NamedType nt("BinaryWriter");
+    return nt;
+}
+
+NamedType &NamedType::BinaryLoader() {
+    static NamedType nt("BinaryLoader");
+    return nt;
+}
+
 NamedType &NamedType::SourceInfo() {
     static NamedType nt(new LookupScope("Util"), "SourceInfo");
     return nt;